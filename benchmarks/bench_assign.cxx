@@ -28,6 +28,48 @@ static void BM_device_assign_4d(benchmark::State& state)
 
 BENCHMARK(BM_device_assign_4d)->Unit(benchmark::kMillisecond);
 
+// ======================================================================
+// BM_host_assign_6d, BM_host_sten_6d
+//
+// host assignment of a 6-d container expression, and of a 5 point stencil
+// built from views, small enough to stay in cache
+
+static void BM_host_assign_6d(benchmark::State& state)
+{
+  auto shape = gt::shape(16, 8, 4, 4, 4, 2);
+  auto a = gt::zeros<real_t>(shape);
+  auto b = gt::empty_like(a);
+
+  for (auto _ : state) {
+    b = a + 2 * a;
+    benchmark::DoNotOptimize(b.data());
+  }
+}
+
+BENCHMARK(BM_host_assign_6d)->Unit(benchmark::kMicrosecond);
+
+static void BM_host_sten_6d(benchmark::State& state)
+{
+  const int bnd = 2; // # of ghost points
+  auto shape_rhs = gt::shape(16, 8, 4, 4, 4, 2);
+  auto shape_f = shape_rhs;
+  shape_f[0] += 2 * bnd;
+
+  auto rhs = gt::zeros<real_t>(shape_rhs);
+  auto f = gt::zeros<real_t>(shape_f);
+  real_t s0 = 1. / 12., s1 = -2. / 3., s3 = 2. / 3., s4 = -1. / 12.;
+
+  for (auto _ : state) {
+    rhs = rhs + s0 * f.view(_s(bnd - 2, -bnd - 2)) +
+          s1 * f.view(_s(bnd - 1, -bnd - 1)) +
+          s3 * f.view(_s(bnd + 1, -bnd + 1)) +
+          s4 * f.view(_s(bnd + 2, -bnd + 2));
+    benchmark::DoNotOptimize(rhs.data());
+  }
+}
+
+BENCHMARK(BM_host_sten_6d)->Unit(benchmark::kMicrosecond);
+
 // ======================================================================
 // BM_add_ij_sten
 
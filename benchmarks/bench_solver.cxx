@@ -1,4 +1,5 @@
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <string>
 
@@ -82,7 +83,8 @@ static void BM_solver(benchmark::State& state)
             << " MB" << std::endl;
 
   auto fn = [&]() {
-    s.solve(d_rhs.data().get(), d_result.data().get());
+    s.solve(gt::raw_pointer_cast(d_rhs.data()),
+            gt::raw_pointer_cast(d_result.data()));
     gt::synchronize();
   };
 
@@ -94,6 +96,70 @@ static void BM_solver(benchmark::State& state)
   }
 }
 
+// ======================================================================
+// BM_solver_update
+//
+// refactor with new matrix values and solve, as when the matrices change
+// every few steps; with REBUILD != 0, by creating a new solver instead of
+// calling update_matrices
+
+// args: int N, int BW, int NRHS, int NBATCH, int REBUILD
+template <typename Solver>
+static void BM_solver_update(benchmark::State& state)
+{
+  using T = typename Solver::value_type;
+
+  const int N = state.range(0);
+  const int BW = state.range(1);
+  const int NRHS = state.range(2);
+  const int NBATCH = state.range(3);
+  const bool REBUILD = state.range(4) != 0;
+
+  auto h_A = make_test_matrix<T>(N, BW, NBATCH, true);
+  auto h_A2 = make_test_matrix<T>(N, BW, NBATCH, false);
+
+  gt::gtensor<T, 3> h_rhs(gt::shape(N, NRHS, NBATCH));
+  gt::gtensor_device<T, 3> d_rhs(h_rhs.shape());
+  gt::gtensor_device<T, 3> d_result(h_rhs.shape());
+  h_rhs = gt::scalar(T(1.0));
+  gt::copy(h_rhs, d_rhs);
+
+  gt::gtensor<T*, 1> h_Aptr(NBATCH);
+  gt::gtensor<T*, 1> h_A2ptr(NBATCH);
+  for (int b = 0; b < NBATCH; b++) {
+    h_Aptr(b) = gt::raw_pointer_cast(h_A.data()) + (N * N * b);
+    h_A2ptr(b) = gt::raw_pointer_cast(h_A2.data()) + (N * N * b);
+  }
+
+  gt::blas::handle_t h;
+
+  auto s = std::make_unique<Solver>(h, N, NBATCH, NRHS,
+                                    gt::raw_pointer_cast(h_Aptr.data()));
+
+  int step = 0;
+  auto fn = [&]() {
+    // alternate between two sets of values with the same sparsity pattern
+    T* const* matrix_batches =
+      gt::raw_pointer_cast(step++ % 2 ? h_Aptr.data() : h_A2ptr.data());
+    if (REBUILD) {
+      s.reset();
+      s = std::make_unique<Solver>(h, N, NBATCH, NRHS, matrix_batches);
+    } else {
+      s->update_matrices(matrix_batches);
+    }
+    s->solve(gt::raw_pointer_cast(d_rhs.data()),
+             gt::raw_pointer_cast(d_result.data()));
+    gt::synchronize();
+  };
+
+  // warm up, device compile
+  fn();
+
+  for (auto _ : state) {
+    fn();
+  }
+}
+
 // Solver, N, BW, NRHS, NBATCH
 BENCHMARK(BM_solver<gt::solver::solver_dense<double>>)
   ->Args({512, 32, 1, 64})
@@ -132,4 +198,20 @@ BENCHMARK(BM_solver<gt::solver::solver_sparse<gt::complex<double>>>)
   ->Unit(benchmark::kMillisecond);
 #endif
 
+// Solver, N, BW, NRHS, NBATCH, REBUILD
+BENCHMARK(BM_solver_update<gt::solver::solver_dense<double>>)
+  ->Args({210, 32, 1, 256, 0})
+  ->Args({210, 32, 1, 256, 1})
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_solver_update<gt::solver::solver_sparse<double>>)
+  ->Args({210, 5, 1, 256, 0})
+  ->Args({210, 5, 1, 256, 1})
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_solver_update<gt::solver::solver_sparse_batch<double>>)
+  ->Args({210, 5, 1, 256, 0})
+  ->Args({210, 5, 1, 256, 1})
+  ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
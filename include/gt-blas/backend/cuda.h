@@ -3,6 +3,8 @@
 
 #include "cublas_v2.h"
 
+#include "gtensor/gtensor.h"
+
 // ======================================================================
 // error handling helper
 
@@ -381,6 +383,167 @@ CREATE_GEMM_BATCHED(cublasSgemmBatched, float, float);
 
 #undef CREATE_GEMM_BATCHED
 
+// ======================================================================
+// strided batched
+//
+// Batch entry b of A lives at d_A + b * lda * n, its pivots at
+// d_PivotArray + b * n and its right hand sides at d_B + b * ldb * nrhs.
+// cuBLAS only has pointer array versions of getrf / getrs / getri, so the
+// pointer arrays are filled in on the device, in the caller provided
+// scratch, on the stream of the handle: no extra allocation and no host to
+// device upload. getrf / getri write per entry info to d_infoArray if given,
+// otherwise to the scratch.
+
+namespace detail
+{
+
+// n_arrays pointer arrays of batchSize entries followed by batchSize ints,
+// in units of T
+template <typename T>
+inline gt::blas::index_t strided_scratch_count(int n_arrays, int batchSize)
+{
+  std::size_t bytes = std::size_t(n_arrays) * batchSize * sizeof(T*) +
+                      std::size_t(batchSize) * sizeof(int);
+  return (bytes + sizeof(T) - 1) / sizeof(T);
+}
+
+template <typename T>
+inline T** strided_scratch_pointers(T* d_scratch, int i, int batchSize)
+{
+  return reinterpret_cast<T**>(d_scratch) + i * batchSize;
+}
+
+template <typename T>
+inline int* strided_scratch_info(T* d_scratch, int n_arrays, int batchSize)
+{
+  return reinterpret_cast<int*>(strided_scratch_pointers(d_scratch, n_arrays,
+                                                         batchSize));
+}
+
+// d_ptrs[b] = base + b * stride
+template <typename T>
+inline void fill_strided_pointers(handle_t& h, T* base, long long stride,
+                                  int batchSize, T** d_ptrs)
+{
+  gt::launch<1>(
+    gt::shape(batchSize),
+    GT_LAMBDA(int b) { d_ptrs[b] = base + b * stride; }, h.get_stream());
+}
+
+} // namespace detail
+
+template <typename T>
+inline gt::blas::index_t getrf_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int lda,
+                                                               int batchSize)
+{
+  return detail::strided_scratch_count<T>(1, batchSize);
+}
+
+template <typename T>
+inline void getrf_strided_batched(handle_t& h, int n, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray,
+                                  int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count,
+                                  int* d_infoArray = nullptr)
+{
+  T** d_Aarray = detail::strided_scratch_pointers(d_scratch, 0, batchSize);
+  if (!d_infoArray) {
+    d_infoArray = detail::strided_scratch_info(d_scratch, 1, batchSize);
+  }
+  detail::fill_strided_pointers(h, d_A, (long long)lda * n, batchSize,
+                                d_Aarray);
+  getrf_batched<T>(h, n, d_Aarray, lda, d_PivotArray, d_infoArray,
+                   batchSize);
+}
+
+template <typename T>
+inline gt::blas::index_t getrs_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int nrhs,
+                                                               int lda, int ldb,
+                                                               int batchSize)
+{
+  return detail::strided_scratch_count<T>(2, batchSize);
+}
+
+template <typename T>
+inline void getrs_strided_batched(handle_t& h, int n, int nrhs, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray, T* d_B,
+                                  int ldb, int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count)
+{
+  T** d_Aarray = detail::strided_scratch_pointers(d_scratch, 0, batchSize);
+  T** d_Barray = detail::strided_scratch_pointers(d_scratch, 1, batchSize);
+  detail::fill_strided_pointers(h, d_A, (long long)lda * n, batchSize,
+                                d_Aarray);
+  detail::fill_strided_pointers(h, d_B, (long long)ldb * nrhs, batchSize,
+                                d_Barray);
+  getrs_batched<T>(h, n, nrhs, d_Aarray, lda, d_PivotArray, d_Barray, ldb,
+                   batchSize);
+}
+
+template <typename T>
+inline gt::blas::index_t getri_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int lda,
+                                                               int ldc,
+                                                               int batchSize)
+{
+  return detail::strided_scratch_count<T>(2, batchSize);
+}
+
+// out of place, the inverse of the factored d_A is written to d_C
+template <typename T>
+inline void getri_strided_batched(handle_t& h, int n, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray, T* d_C,
+                                  int ldc, int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count,
+                                  int* d_infoArray = nullptr)
+{
+  T** d_Aarray = detail::strided_scratch_pointers(d_scratch, 0, batchSize);
+  T** d_Carray = detail::strided_scratch_pointers(d_scratch, 1, batchSize);
+  if (!d_infoArray) {
+    d_infoArray = detail::strided_scratch_info(d_scratch, 2, batchSize);
+  }
+  detail::fill_strided_pointers(h, d_A, (long long)lda * n, batchSize,
+                                d_Aarray);
+  detail::fill_strided_pointers(h, d_C, (long long)ldc * n, batchSize,
+                                d_Carray);
+  getri_batched<T>(h, n, d_Aarray, lda, d_PivotArray, d_Carray, ldc,
+                   d_infoArray, batchSize);
+}
+
+template <typename T>
+inline void gemm_strided_batched(handle_t& h, int m, int n, int k, T alpha,
+                                 const T* d_A, int lda, long long strideA,
+                                 const T* d_B, int ldb, long long strideB,
+                                 T beta, T* d_C, int ldc, long long strideC,
+                                 int batchSize);
+
+#define CREATE_GEMM_STRIDED_BATCHED(METHOD, GTTYPE, BLASTYPE)                  \
+  template <>                                                                  \
+  inline void gemm_strided_batched<GTTYPE>(                                    \
+    handle_t & h, int m, int n, int k, GTTYPE alpha, const GTTYPE* d_A,        \
+    int lda, long long strideA, const GTTYPE* d_B, int ldb, long long strideB, \
+    GTTYPE beta, GTTYPE* d_C, int ldc, long long strideC, int batchSize)       \
+  {                                                                            \
+    gtBlasCheck(METHOD(h.get_backend_handle(), CUBLAS_OP_N, CUBLAS_OP_N, m, n, \
+                       k, reinterpret_cast<BLASTYPE*>(&alpha),                 \
+                       reinterpret_cast<const BLASTYPE*>(d_A), lda, strideA,   \
+                       reinterpret_cast<const BLASTYPE*>(d_B), ldb, strideB,   \
+                       reinterpret_cast<BLASTYPE*>(&beta),                     \
+                       reinterpret_cast<BLASTYPE*>(d_C), ldc, strideC,         \
+                       batchSize));                                            \
+  }
+
+CREATE_GEMM_STRIDED_BATCHED(cublasZgemmStridedBatched, gt::complex<double>,
+                            cuDoubleComplex)
+CREATE_GEMM_STRIDED_BATCHED(cublasCgemmStridedBatched, gt::complex<float>,
+                            cuComplex)
+CREATE_GEMM_STRIDED_BATCHED(cublasDgemmStridedBatched, double, double)
+CREATE_GEMM_STRIDED_BATCHED(cublasSgemmStridedBatched, float, float)
+
+#undef CREATE_GEMM_STRIDED_BATCHED
+
 } // namespace blas
 
 } // namespace gt
@@ -387,6 +387,181 @@ CREATE_GEMM_BATCHED(rocblas_sgemm_batched, float, float);
 
 #undef CREATE_GEMM_BATCHED
 
+// ======================================================================
+// strided batched
+//
+// Batch entry b of A lives at d_A + b * lda * n, its pivots at
+// d_PivotArray + b * n and its right hand sides at d_B + b * ldb * nrhs.
+// rocSOLVER supports strided batches directly, the scratch only holds the
+// info array of getrf / getri when the caller does not pass d_infoArray.
+
+namespace detail
+{
+
+// batchSize ints, in units of T
+template <typename T>
+inline gt::blas::index_t strided_scratch_info_count(int batchSize)
+{
+  return (std::size_t(batchSize) * sizeof(int) + sizeof(T) - 1) / sizeof(T);
+}
+
+} // namespace detail
+
+template <typename T>
+inline gt::blas::index_t getrf_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int lda,
+                                                               int batchSize)
+{
+  return detail::strided_scratch_info_count<T>(batchSize);
+}
+
+template <typename T>
+inline void getrf_strided_batched(handle_t& h, int n, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray,
+                                  int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count,
+                                  int* d_infoArray = nullptr);
+
+#define CREATE_GETRF_STRIDED_BATCHED(METHOD, GTTYPE, BLASTYPE)                 \
+  template <>                                                                  \
+  inline void getrf_strided_batched<GTTYPE>(                                   \
+    handle_t & h, int n, GTTYPE* d_A, int lda,                                 \
+    gt::blas::index_t* d_PivotArray, int batchSize, GTTYPE* d_scratch,         \
+    gt::blas::index_t scratch_count, int* d_infoArray)                         \
+  {                                                                            \
+    if (!d_infoArray) {                                                        \
+      d_infoArray = reinterpret_cast<int*>(d_scratch);                         \
+    }                                                                          \
+    gtBlasCheck(METHOD(h.get_backend_handle(), n, n,                           \
+                       reinterpret_cast<BLASTYPE*>(d_A), lda,                  \
+                       rocblas_stride(lda) * n, d_PivotArray, n, d_infoArray,  \
+                       batchSize));                                            \
+  }
+
+CREATE_GETRF_STRIDED_BATCHED(rocsolver_zgetrf_strided_batched,
+                             gt::complex<double>, rocblas_double_complex)
+CREATE_GETRF_STRIDED_BATCHED(rocsolver_cgetrf_strided_batched,
+                             gt::complex<float>, rocblas_float_complex)
+CREATE_GETRF_STRIDED_BATCHED(rocsolver_dgetrf_strided_batched, double, double)
+CREATE_GETRF_STRIDED_BATCHED(rocsolver_sgetrf_strided_batched, float, float)
+
+#undef CREATE_GETRF_STRIDED_BATCHED
+
+template <typename T>
+inline gt::blas::index_t getrs_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int nrhs,
+                                                               int lda, int ldb,
+                                                               int batchSize)
+{
+  return 0;
+}
+
+template <typename T>
+inline void getrs_strided_batched(handle_t& h, int n, int nrhs, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray, T* d_B,
+                                  int ldb, int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count);
+
+#define CREATE_GETRS_STRIDED_BATCHED(METHOD, GTTYPE, BLASTYPE)                 \
+  template <>                                                                  \
+  inline void getrs_strided_batched<GTTYPE>(                                   \
+    handle_t & h, int n, int nrhs, GTTYPE* d_A, int lda,                       \
+    gt::blas::index_t* d_PivotArray, GTTYPE* d_B, int ldb, int batchSize,      \
+    GTTYPE* d_scratch, gt::blas::index_t scratch_count)                        \
+  {                                                                            \
+    gtBlasCheck(METHOD(h.get_backend_handle(), rocblas_operation_none, n,      \
+                       nrhs, reinterpret_cast<BLASTYPE*>(d_A), lda,            \
+                       rocblas_stride(lda) * n, d_PivotArray, n,               \
+                       reinterpret_cast<BLASTYPE*>(d_B), ldb,                  \
+                       rocblas_stride(ldb) * nrhs, batchSize));                \
+  }
+
+CREATE_GETRS_STRIDED_BATCHED(rocsolver_zgetrs_strided_batched,
+                             gt::complex<double>, rocblas_double_complex)
+CREATE_GETRS_STRIDED_BATCHED(rocsolver_cgetrs_strided_batched,
+                             gt::complex<float>, rocblas_float_complex)
+CREATE_GETRS_STRIDED_BATCHED(rocsolver_dgetrs_strided_batched, double, double)
+CREATE_GETRS_STRIDED_BATCHED(rocsolver_sgetrs_strided_batched, float, float)
+
+#undef CREATE_GETRS_STRIDED_BATCHED
+
+template <typename T>
+inline gt::blas::index_t getri_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int lda,
+                                                               int ldc,
+                                                               int batchSize)
+{
+  return detail::strided_scratch_info_count<T>(batchSize);
+}
+
+// out of place, the inverse of the factored d_A is written to d_C
+template <typename T>
+inline void getri_strided_batched(handle_t& h, int n, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray, T* d_C,
+                                  int ldc, int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count,
+                                  int* d_infoArray = nullptr);
+
+#define CREATE_GETRI_STRIDED_BATCHED(METHOD, GTTYPE, BLASTYPE)                 \
+  template <>                                                                  \
+  inline void getri_strided_batched<GTTYPE>(                                   \
+    handle_t & h, int n, GTTYPE* d_A, int lda,                                 \
+    gt::blas::index_t* d_PivotArray, GTTYPE* d_C, int ldc, int batchSize,      \
+    GTTYPE* d_scratch, gt::blas::index_t scratch_count, int* d_infoArray)      \
+  {                                                                            \
+    if (!d_infoArray) {                                                        \
+      d_infoArray = reinterpret_cast<int*>(d_scratch);                         \
+    }                                                                          \
+    gtBlasCheck(METHOD(h.get_backend_handle(), n,                              \
+                       reinterpret_cast<BLASTYPE*>(d_A), lda,                  \
+                       rocblas_stride(lda) * n, d_PivotArray, n,               \
+                       reinterpret_cast<BLASTYPE*>(d_C), ldc,                  \
+                       rocblas_stride(ldc) * n, d_infoArray, batchSize));      \
+  }
+
+CREATE_GETRI_STRIDED_BATCHED(rocsolver_zgetri_outofplace_strided_batched,
+                             gt::complex<double>, rocblas_double_complex)
+CREATE_GETRI_STRIDED_BATCHED(rocsolver_cgetri_outofplace_strided_batched,
+                             gt::complex<float>, rocblas_float_complex)
+CREATE_GETRI_STRIDED_BATCHED(rocsolver_dgetri_outofplace_strided_batched,
+                             double, double)
+CREATE_GETRI_STRIDED_BATCHED(rocsolver_sgetri_outofplace_strided_batched,
+                             float, float)
+
+#undef CREATE_GETRI_STRIDED_BATCHED
+
+template <typename T>
+inline void gemm_strided_batched(handle_t& h, int m, int n, int k, T alpha,
+                                 const T* d_A, int lda, long long strideA,
+                                 const T* d_B, int ldb, long long strideB,
+                                 T beta, T* d_C, int ldc, long long strideC,
+                                 int batchSize);
+
+#define CREATE_GEMM_STRIDED_BATCHED(METHOD, GTTYPE, BLASTYPE)                  \
+  template <>                                                                  \
+  inline void gemm_strided_batched<GTTYPE>(                                    \
+    handle_t & h, int m, int n, int k, GTTYPE alpha, const GTTYPE* d_A,        \
+    int lda, long long strideA, const GTTYPE* d_B, int ldb, long long strideB, \
+    GTTYPE beta, GTTYPE* d_C, int ldc, long long strideC, int batchSize)       \
+  {                                                                            \
+    gtBlasCheck(METHOD(                                                        \
+      h.get_backend_handle(), rocblas_operation_none, rocblas_operation_none,  \
+      m, n, k, reinterpret_cast<BLASTYPE*>(&alpha),                            \
+      reinterpret_cast<const BLASTYPE*>(d_A), lda, strideA,                    \
+      reinterpret_cast<const BLASTYPE*>(d_B), ldb, strideB,                    \
+      reinterpret_cast<BLASTYPE*>(&beta), reinterpret_cast<BLASTYPE*>(d_C),    \
+      ldc, strideC, batchSize));                                               \
+  }
+
+CREATE_GEMM_STRIDED_BATCHED(rocblas_zgemm_strided_batched, gt::complex<double>,
+                            rocblas_double_complex)
+CREATE_GEMM_STRIDED_BATCHED(rocblas_cgemm_strided_batched, gt::complex<float>,
+                            rocblas_float_complex)
+CREATE_GEMM_STRIDED_BATCHED(rocblas_dgemm_strided_batched, double, double)
+CREATE_GEMM_STRIDED_BATCHED(rocblas_sgemm_strided_batched, float, float)
+
+#undef CREATE_GEMM_STRIDED_BATCHED
+
 } // namespace blas
 
 } // namespace gt
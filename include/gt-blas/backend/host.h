@@ -3,13 +3,23 @@
 
 #include <gtensor/gtensor.h>
 
+#include <algorithm>
+#include <atomic>
 #include <complex.h>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <cblas.h>
 extern "C" {
 #include <lapack.h>
 }
 
+#include "host_small_batched.h"
+
 namespace gt
 {
 
@@ -21,6 +31,166 @@ namespace blas
 
 using index_t = int;
 
+// ======================================================================
+// batch_thread_pool
+//
+// The batched routines below call single-matrix LAPACK / CBLAS routines once
+// per batch entry. For many small matrices, the batch is split into chunks
+// of entries that are worked on by a set of persistent threads (plus the
+// calling thread). To avoid oversubscription, OpenBLAS is limited to one
+// thread while the pool works on a batch, and its previous thread count is
+// restored afterwards. Only one batch runs on the pool at a time; a call
+// made while the pool is busy, or from inside a pool job, runs on the calling
+// thread instead of waiting for it. The number of threads defaults to the
+// hardware concurrency and can be set with the GTENSOR_BLAS_NUM_THREADS
+// environment variable (1 leaves OpenBLAS alone); handle_host sets per handle
+// limits and the chunk size.
+
+namespace detail
+{
+
+class batch_thread_pool
+{
+public:
+  explicit batch_thread_pool(int n_threads)
+    : generation_(0), pending_(0), stop_(false)
+  {
+    for (int i = 1; i < n_threads; i++) {
+      workers_.emplace_back([this, i] { run(i); });
+    }
+  }
+
+  ~batch_thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  static batch_thread_pool& instance()
+  {
+    static batch_thread_pool pool(default_num_threads());
+    return pool;
+  }
+
+  // including the calling thread
+  int num_threads() const { return workers_.size() + 1; }
+
+  // calls f(begin, end) for chunks of at most `chunk` entries covering
+  // [0, n), on up to n_threads threads, and returns when all are done
+  template <typename F>
+  void parallel_for(int n, int chunk, int n_threads, const F& f)
+  {
+    std::unique_lock<std::mutex> call_lock;
+    if (!in_pool()) {
+      call_lock = std::unique_lock<std::mutex>(call_mutex_, std::try_to_lock);
+    }
+    if (!call_lock.owns_lock()) {
+      for (int begin = 0; begin < n; begin += chunk) {
+        f(begin, std::min(begin + chunk, n));
+      }
+      return;
+    }
+    pool_scope scope;
+    std::atomic<int> next(0);
+    auto body = [&]() {
+      int begin;
+      while ((begin = next.fetch_add(chunk)) < n) {
+        f(begin, std::min(begin + chunk, n));
+      }
+    };
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = body;
+      active_threads_ = n_threads;
+      pending_ = workers_.size();
+      generation_++;
+    }
+    work_cv_.notify_all();
+    body();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+    job_ = nullptr;
+  }
+
+private:
+  static int default_num_threads()
+  {
+    const char* env = std::getenv("GTENSOR_BLAS_NUM_THREADS");
+    int n = env ? std::atoi(env) : std::thread::hardware_concurrency();
+    return std::max(n, 1);
+  }
+
+  // true on the workers and on a thread that is running a batch on the pool
+  static bool& in_pool()
+  {
+    static thread_local bool flag = false;
+    return flag;
+  }
+
+  // marks the calling thread as in the pool and limits OpenBLAS to one thread
+  // for the duration of a batch
+  class pool_scope
+  {
+  public:
+    pool_scope() : blas_num_threads_(openblas_get_num_threads())
+    {
+      in_pool() = true;
+      openblas_set_num_threads(1);
+    }
+
+    ~pool_scope()
+    {
+      openblas_set_num_threads(blas_num_threads_);
+      in_pool() = false;
+    }
+
+  private:
+    int blas_num_threads_;
+  };
+
+  void run(int id)
+  {
+    in_pool() = true;
+    unsigned long seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      work_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+      if (id < active_threads_) {
+        auto job = job_;
+        lock.unlock();
+        job();
+        lock.lock();
+      }
+      if (--pending_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex call_mutex_;
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  std::function<void()> job_;
+  unsigned long generation_;
+  int active_threads_;
+  int pending_;
+  bool stop_;
+};
+
+} // namespace detail
+
 // ======================================================================
 // handle and stream management
 
@@ -30,14 +200,82 @@ class dummy_handle
 class handle_host : public detail::handle_base<handle_host, dummy_handle>
 {
 public:
-  handle_host() {}
+  handle_host()
+    : batch_num_threads_(0), batch_chunk_size_(0), small_batched_max_n_(16)
+  {}
   ~handle_host() {}
 
-  void set_stream(gt::stream_view sview) {}
+  void set_stream(gt::stream_view sview) { stream_ = sview; }
+
+  gt::stream_view get_stream() { return stream_; }
+
+  // the routines below run on the calling thread, so they first wait for the
+  // work already queued on the handle's stream
+  void wait_for_stream() { stream_.synchronize(); }
+
+  // threads used for batched routines, 0 for all threads of the pool
+  void set_batch_num_threads(int n) { batch_num_threads_ = n; }
+
+  // batch entries handed to a thread at a time, 0 to split the batch into a
+  // few chunks per thread
+  void set_batch_chunk_size(int n) { batch_chunk_size_ = n; }
+
+  // getrf / getrs / getri batched on matrices up to this size use the native
+  // kernels in host_small_batched.h instead of LAPACK, 0 to always use LAPACK
+  void set_small_batched_max_n(int n) { small_batched_max_n_ = n; }
+
+  bool use_small_batched(int n) const { return n <= small_batched_max_n_; }
+
+  // calls f(begin, end) on chunks of [0, batch_size), see batch_thread_pool
+  template <typename F>
+  void parallel_batch(int batch_size, const F& f)
+  {
+    auto& pool = detail::batch_thread_pool::instance();
+    int n_threads = pool.num_threads();
+    if (batch_num_threads_ > 0) {
+      n_threads = std::min(n_threads, batch_num_threads_);
+    }
+    int chunk = batch_chunk_size_;
+    if (chunk <= 0) {
+      chunk = std::max(1, batch_size / (4 * n_threads));
+    }
+    if (n_threads == 1 || chunk >= batch_size) {
+      f(0, batch_size);
+      return;
+    }
+
+    pool.parallel_for(batch_size, chunk, n_threads, f);
+  }
+
+  // like parallel_batch, but chunks are whole groups of `lanes` entries
+  template <typename F>
+  void parallel_batch_groups(int batch_size, int lanes, const F& f)
+  {
+    int n_groups = (batch_size + lanes - 1) / lanes;
+    parallel_batch(n_groups, [&](int begin, int end) {
+      f(begin * lanes, std::min(end * lanes, batch_size));
+    });
+  }
 
-  gt::stream_view get_stream() { return gt::stream_view{}; }
+private:
+  gt::stream_view stream_;
+  int batch_num_threads_;
+  int batch_chunk_size_;
+  int small_batched_max_n_;
 };
 
+// runs the native small batched kernel Kernel<GTTYPE> on the batch if n is
+// below the crossover set on the handle, see host_small_batched.h
+#define GT_BLAS_SMALL_BATCHED(KERNEL, GTTYPE, ...)                             \
+  if (h.use_small_batched(n)) {                                                \
+    constexpr int lanes = detail::small_batched_lanes<GTTYPE>::value;          \
+    h.parallel_batch_groups(batchSize, lanes, [&](int begin, int end) {        \
+      detail::small_batched_dispatch<detail::KERNEL<GTTYPE>>(                  \
+        n, __VA_ARGS__, begin, end);                                           \
+    });                                                                        \
+    return;                                                                    \
+  }
+
 using handle_t = handle_host;
 
 // ======================================================================
@@ -51,6 +289,7 @@ inline void axpy(handle_t& h, int n, T a, const T* x, int incx, T* y, int incy);
   inline void axpy<GTTYPE>(handle_t & h, int n, GTTYPE a, const GTTYPE* x,     \
                            int incx, GTTYPE* y, int incy)                      \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     METHOD(n, a, reinterpret_cast<const BLASTYPE*>(x), incx,                   \
            reinterpret_cast<BLASTYPE*>(y), incy);                              \
   }
@@ -60,6 +299,7 @@ inline void axpy(handle_t& h, int n, T a, const T* x, int incx, T* y, int incy);
   inline void axpy<GTTYPE>(handle_t & h, int n, GTTYPE a, const GTTYPE* x,     \
                            int incx, GTTYPE* y, int incy)                      \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     METHOD(n, reinterpret_cast<BLASTYPE*>(&a),                                 \
            reinterpret_cast<const BLASTYPE*>(x), incx,                         \
            reinterpret_cast<BLASTYPE*>(y), incy);                              \
@@ -83,6 +323,7 @@ inline void scal(handle_t& h, int n, S fac, T* arr, const int incx);
   inline void scal<GTTYPE, GTTYPE>(handle_t & h, int n, GTTYPE fac,            \
                                    GTTYPE* arr, const int incx)                \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     METHOD(n, fac, reinterpret_cast<BLASTYPE*>(arr), incx);                    \
   }
 
@@ -91,6 +332,7 @@ inline void scal(handle_t& h, int n, S fac, T* arr, const int incx);
   inline void scal<GTTYPE, GTTYPE>(handle_t & h, int n, GTTYPE fac,            \
                                    GTTYPE* arr, const int incx)                \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     METHOD(n, reinterpret_cast<BLASTYPE*>(&fac),                               \
            reinterpret_cast<BLASTYPE*>(arr), incx);                            \
   }
@@ -110,6 +352,7 @@ inline void scal<double, gt::complex<double>>(handle_t& h, int n, double fac,
                                               gt::complex<double>* arr,
                                               const int incx)
 {
+  h.wait_for_stream();
   cblas_zdscal(n, fac, reinterpret_cast<openblas_complex_double*>(arr), incx);
 }
 
@@ -118,6 +361,7 @@ inline void scal<float, gt::complex<float>>(handle_t& h, int n, float fac,
                                             gt::complex<float>* arr,
                                             const int incx)
 {
+  h.wait_for_stream();
   cblas_csscal(n, fac, reinterpret_cast<openblas_complex_float*>(arr), incx);
 }
 
@@ -132,6 +376,7 @@ inline void copy(handle_t& h, int n, const T* x, int incx, T* y, int incy);
   inline void copy<GTTYPE>(handle_t & h, int n, const GTTYPE* x, int incx,     \
                            GTTYPE* y, int incy)                                \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     METHOD(n, reinterpret_cast<const BLASTYPE*>(x), incx,                      \
            reinterpret_cast<BLASTYPE*>(y), incy);                              \
   }
@@ -154,6 +399,7 @@ inline T dot(handle_t& h, int n, const T* x, int incx, const T* y, int incy);
   inline GTTYPE dot<GTTYPE>(handle_t & h, int n, const GTTYPE* x, int incx,    \
                             const GTTYPE* y, int incy)                         \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     return METHOD(n, reinterpret_cast<const BLASTYPE*>(x), incx,               \
                   reinterpret_cast<const BLASTYPE*>(y), incy);                 \
   }
@@ -171,6 +417,7 @@ inline T dotu(handle_t& h, int n, const T* x, int incx, const T* y, int incy);
   inline GTTYPE dotu<GTTYPE>(handle_t & h, int n, const GTTYPE* x, int incx,   \
                              const GTTYPE* y, int incy)                        \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     BLASTYPE result = METHOD(n, reinterpret_cast<const BLASTYPE*>(x), incx,    \
                              reinterpret_cast<const BLASTYPE*>(y), incy);      \
     return {RPART(result), IPART(result)};                                     \
@@ -191,6 +438,7 @@ inline T dotc(handle_t& h, int n, const T* x, int incx, const T* y, int incy);
   inline GTTYPE dotc<GTTYPE>(handle_t & h, int n, const GTTYPE* x, int incx,   \
                              const GTTYPE* y, int incy)                        \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     BLASTYPE result = METHOD(n, reinterpret_cast<const BLASTYPE*>(x), incx,    \
                              reinterpret_cast<const BLASTYPE*>(y), incy);      \
     return {RPART(result), IPART(result)};                                     \
@@ -216,6 +464,7 @@ inline void gemv(handle_t& h, int m, int n, T alpha, const T* A, int lda,
                            const GTTYPE* A, int lda, const GTTYPE* x,          \
                            int incx, GTTYPE beta, GTTYPE* y, int incy)         \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     METHOD(CblasColMajor, CblasNoTrans, m, n, alpha,                           \
            reinterpret_cast<const BLASTYPE*>(A), lda,                          \
            reinterpret_cast<const BLASTYPE*>(x), incx, beta,                   \
@@ -228,6 +477,7 @@ inline void gemv(handle_t& h, int m, int n, T alpha, const T* A, int lda,
                            const GTTYPE* A, int lda, const GTTYPE* x,          \
                            int incx, GTTYPE beta, GTTYPE* y, int incy)         \
   {                                                                            \
+    h.wait_for_stream();                                                       \
     METHOD(CblasColMajor, CblasNoTrans, m, n,                                  \
            reinterpret_cast<const BLASTYPE*>(&alpha),                          \
            reinterpret_cast<const BLASTYPE*>(A), lda,                          \
@@ -257,10 +507,15 @@ inline void getrf_batched(handle_t& h, int n, T** d_Aarray, int lda,
                                     int lda, gt::blas::index_t* d_PivotArray,  \
                                     int* d_infoArray, int batchSize)           \
   {                                                                            \
-    for (int b = 0; b < batchSize; b++) {                                      \
-      METHOD(&n, &n, reinterpret_cast<BLASTYPE*>(d_Aarray[b]), &lda,           \
-             &d_PivotArray[b * n], &d_infoArray[b]);                           \
-    }                                                                          \
+    h.wait_for_stream();                                                       \
+    GT_BLAS_SMALL_BATCHED(small_getrf, GTTYPE, n, d_Aarray, lda, d_PivotArray, \
+                          d_infoArray);                                        \
+    h.parallel_batch(batchSize, [&](int begin, int end) {                      \
+      for (int b = begin; b < end; b++) {                                      \
+        METHOD(&n, &n, reinterpret_cast<BLASTYPE*>(d_Aarray[b]), &lda,         \
+               &d_PivotArray[b * n], &d_infoArray[b]);                         \
+      }                                                                        \
+    });                                                                        \
   }
 
 CREATE_GETRF_BATCHED(LAPACK_zgetrf, gt::complex<double>, _Complex double)
@@ -270,31 +525,43 @@ CREATE_GETRF_BATCHED(LAPACK_sgetrf, float, float)
 
 #undef CREATE_GETRF_BATCHED
 
-#if 0
 // ======================================================================
 // getrf_npvt batched
+//
+// LAPACK has no LU without pivoting, so this is a plain right-looking
+// factorization. Like the device versions, it is meant for matrices that
+// are safe to factor without pivoting, e.g. diagonally dominant ones.
 
 template <typename T>
 inline void getrf_npvt_batched(handle_t& h, int n, T** d_Aarray, int lda,
-                               int* d_infoArray, int batchSize);
-
-#define CREATE_GETRF_NPVT_BATCHED(METHOD, GTTYPE, BLASTYPE)                    \
-  template <>                                                                  \
-  inline void getrf_npvt_batched<GTTYPE>(handle_t & h, int n,                  \
-                                         GTTYPE** d_Aarray, int lda,           \
-                                         int* d_infoArray, int batchSize)      \
-  {                                                                            \
-    for (int b = 0; b < batchSize; b++) {                                      \
-      METHOD(&n, &n, reinterpret_cast<BLASTYPE*>(d_Aarray[b]), &lda, NULL,     \
-             &d_infoArray[b]);                                                 \
-    }                                                                          \
-  }
-
-CREATE_GETRF_NPVT_BATCHED(LAPACK_zgetrf, gt::complex<double>, _Complex double)
-CREATE_GETRF_NPVT_BATCHED(LAPACK_cgetrf, gt::complex<float>, _Complex float)
-
-#undef CREATE_GETRF_NPVT_BATCHED
-#endif
+                               int* d_infoArray, int batchSize)
+{
+  h.wait_for_stream();
+  h.parallel_batch(batchSize, [&](int begin, int end) {
+    for (int b = begin; b < end; b++) {
+      T* a = d_Aarray[b];
+      d_infoArray[b] = 0;
+      for (int k = 0; k < n; k++) {
+        T akk = a[k * lda + k];
+        if (akk == T(0)) {
+          if (d_infoArray[b] == 0) {
+            d_infoArray[b] = k + 1;
+          }
+          continue;
+        }
+        for (int i = k + 1; i < n; i++) {
+          a[k * lda + i] /= akk;
+        }
+        for (int j = k + 1; j < n; j++) {
+          T akj = a[j * lda + k];
+          for (int i = k + 1; i < n; i++) {
+            a[j * lda + i] -= a[k * lda + i] * akj;
+          }
+        }
+      }
+    }
+  });
+}
 
 // ======================================================================
 // getrs batched
@@ -310,18 +577,23 @@ inline void getrs_batched(handle_t& h, int n, int nrhs, T* const* d_Aarray,
     handle_t & h, int n, int nrhs, GTTYPE* const* d_Aarray, int lda,           \
     gt::blas::index_t* devIpiv, GTTYPE** d_Barray, int ldb, int batchSize)     \
   {                                                                            \
+    h.wait_for_stream();                                                       \
+    GT_BLAS_SMALL_BATCHED(small_getrs, GTTYPE, n, nrhs, d_Aarray, lda,         \
+                          devIpiv, d_Barray, ldb);                             \
     static const char op_N = 'N';                                              \
-    int info;                                                                  \
-    for (int b = 0; b < batchSize; b++) {                                      \
-      METHOD(&op_N, &n, &nrhs, reinterpret_cast<BLASTYPE*>(d_Aarray[b]), &lda, \
-             &devIpiv[b * n], reinterpret_cast<BLASTYPE*>(d_Barray[b]), &ldb,  \
-             &info);                                                           \
-      if (info != 0) {                                                         \
-        fprintf(stderr, "METHOD failed, info=%d at %s %d\n", info, __FILE__,   \
-                __LINE__);                                                     \
-        abort();                                                               \
+    h.parallel_batch(batchSize, [&](int begin, int end) {                      \
+      int info;                                                                \
+      for (int b = begin; b < end; b++) {                                      \
+        METHOD(&op_N, &n, &nrhs, reinterpret_cast<BLASTYPE*>(d_Aarray[b]),     \
+               &lda, &devIpiv[b * n],                                          \
+               reinterpret_cast<BLASTYPE*>(d_Barray[b]), &ldb, &info);         \
+        if (info != 0) {                                                       \
+          fprintf(stderr, "METHOD failed, info=%d at %s %d\n", info, __FILE__, \
+                  __LINE__);                                                   \
+          abort();                                                             \
+        }                                                                      \
       }                                                                        \
-    }                                                                          \
+    });                                                                        \
   }
 
 CREATE_GETRS_BATCHED(LAPACK_zgetrs, gt::complex<double>, _Complex double)
@@ -346,16 +618,23 @@ inline void getri_batched(handle_t& h, int n, T* const* d_Aarray, int lda,
     gt::blas::index_t* devIpiv, GTTYPE** d_Carray, int ldc, int* d_infoArray,  \
     int batchSize)                                                             \
   {                                                                            \
+    h.wait_for_stream();                                                       \
+    GT_BLAS_SMALL_BATCHED(small_getri, GTTYPE, n, d_Aarray, lda, devIpiv,      \
+                          d_Carray, ldc, d_infoArray);                         \
     int lwork = n * n;                                                         \
-    auto work = gt::empty<GTTYPE>({lwork});                                    \
-    for (int b = 0; b < batchSize; b++) {                                      \
-      for (int i = 0; i < n * n; i++) {                                        \
-        d_Carray[b][i] = d_Aarray[b][i];                                       \
+    h.parallel_batch(batchSize, [&](int begin, int end) {                      \
+      auto work = gt::empty<GTTYPE>({lwork});                                  \
+      for (int b = begin; b < end; b++) {                                      \
+        for (int j = 0; j < n; j++) {                                          \
+          for (int i = 0; i < n; i++) {                                        \
+            d_Carray[b][j * ldc + i] = d_Aarray[b][j * lda + i];               \
+          }                                                                    \
+        }                                                                      \
+        METHOD(&n, reinterpret_cast<BLASTYPE*>(d_Carray[b]), &ldc,             \
+               &devIpiv[b * n], reinterpret_cast<BLASTYPE*>(work.data()),      \
+               &lwork, &d_infoArray[b]);                                       \
       }                                                                        \
-      METHOD(&n, reinterpret_cast<BLASTYPE*>(d_Carray[b]), &lda,               \
-             &devIpiv[b * n], reinterpret_cast<BLASTYPE*>(work.data()),        \
-             &lwork, &d_infoArray[b]);                                         \
-    }                                                                          \
+    });                                                                        \
   }
 
 CREATE_GETRI_BATCHED(LAPACK_zgetri, gt::complex<double>, _Complex double)
@@ -380,14 +659,17 @@ inline void gemm_batched(handle_t& h, int m, int n, int k, T alpha,
                                    GTTYPE** d_Barray, int ldb, GTTYPE beta,    \
                                    GTTYPE** d_Carray, int ldc, int batchSize)  \
   {                                                                            \
-    for (int b = 0; b < batchSize; b++) {                                      \
-      METHOD(CblasColMajor, CblasNoTrans, CblasNoTrans, m, n, k,               \
-             reinterpret_cast<BLASTYPE*>(&alpha),                              \
-             reinterpret_cast<BLASTYPE*>(d_Aarray[b]), lda,                    \
-             reinterpret_cast<BLASTYPE*>(d_Barray[b]), ldb,                    \
-             reinterpret_cast<BLASTYPE*>(&beta),                               \
-             reinterpret_cast<BLASTYPE*>(d_Carray[b]), ldc);                   \
-    }                                                                          \
+    h.wait_for_stream();                                                       \
+    h.parallel_batch(batchSize, [&](int begin, int end) {                      \
+      for (int b = begin; b < end; b++) {                                      \
+        METHOD(CblasColMajor, CblasNoTrans, CblasNoTrans, m, n, k,             \
+               reinterpret_cast<BLASTYPE*>(&alpha),                            \
+               reinterpret_cast<BLASTYPE*>(d_Aarray[b]), lda,                  \
+               reinterpret_cast<BLASTYPE*>(d_Barray[b]), ldb,                  \
+               reinterpret_cast<BLASTYPE*>(&beta),                             \
+               reinterpret_cast<BLASTYPE*>(d_Carray[b]), ldc);                 \
+      }                                                                        \
+    });                                                                        \
   }
 
 #define CREATE_GEMM_BATCHED(METHOD, GTTYPE, BLASTYPE)                          \
@@ -397,12 +679,15 @@ inline void gemm_batched(handle_t& h, int m, int n, int k, T alpha,
                                    GTTYPE** d_Barray, int ldb, GTTYPE beta,    \
                                    GTTYPE** d_Carray, int ldc, int batchSize)  \
   {                                                                            \
-    for (int b = 0; b < batchSize; b++) {                                      \
-      METHOD(CblasColMajor, CblasNoTrans, CblasNoTrans, m, n, k, alpha,        \
-             reinterpret_cast<BLASTYPE*>(d_Aarray[b]), lda,                    \
-             reinterpret_cast<BLASTYPE*>(d_Barray[b]), ldb, beta,              \
-             reinterpret_cast<BLASTYPE*>(d_Carray[b]), ldc);                   \
-    }                                                                          \
+    h.wait_for_stream();                                                       \
+    h.parallel_batch(batchSize, [&](int begin, int end) {                      \
+      for (int b = begin; b < end; b++) {                                      \
+        METHOD(CblasColMajor, CblasNoTrans, CblasNoTrans, m, n, k, alpha,      \
+               reinterpret_cast<BLASTYPE*>(d_Aarray[b]), lda,                  \
+               reinterpret_cast<BLASTYPE*>(d_Barray[b]), ldb, beta,            \
+               reinterpret_cast<BLASTYPE*>(d_Carray[b]), ldc);                 \
+      }                                                                        \
+    });                                                                        \
   }
 
 CREATE_GEMM_BATCHED_CMPLX(cblas_zgemm, gt::complex<double>,
@@ -413,6 +698,115 @@ CREATE_GEMM_BATCHED(cblas_dgemm, double, double);
 CREATE_GEMM_BATCHED(cblas_sgemm, float, float);
 
 #undef CREATE_GEMM_BATCHED
+#undef GT_BLAS_SMALL_BATCHED
+
+// ======================================================================
+// strided batched
+//
+// Batch entry b of A lives at d_A + b * lda * n, its pivots at
+// d_PivotArray + b * n and its right hand sides at d_B + b * ldb * nrhs.
+// The scratch arguments keep the signatures the same on all backends; no
+// scratch is needed on the host. Pointer arrays are cheap to build here, so
+// these forward to the routines above, including the thread pool and the
+// small batched kernels.
+
+namespace detail
+{
+
+template <typename T>
+inline std::vector<T*> strided_pointers(T* base, long long stride,
+                                        int batchSize)
+{
+  std::vector<T*> ptrs(batchSize);
+  for (int b = 0; b < batchSize; b++) {
+    ptrs[b] = base + b * stride;
+  }
+  return ptrs;
+}
+
+} // namespace detail
+
+template <typename T>
+inline gt::blas::index_t getrf_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int lda,
+                                                               int batchSize)
+{
+  return 0;
+}
+
+template <typename T>
+inline void getrf_strided_batched(handle_t& h, int n, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray,
+                                  int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count,
+                                  int* d_infoArray = nullptr)
+{
+  auto Aptr = detail::strided_pointers(d_A, (long long)lda * n, batchSize);
+  std::vector<int> info(d_infoArray ? 0 : batchSize);
+  getrf_batched<T>(h, n, Aptr.data(), lda, d_PivotArray,
+                   d_infoArray ? d_infoArray : info.data(), batchSize);
+}
+
+template <typename T>
+inline gt::blas::index_t getrs_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int nrhs,
+                                                               int lda, int ldb,
+                                                               int batchSize)
+{
+  return 0;
+}
+
+template <typename T>
+inline void getrs_strided_batched(handle_t& h, int n, int nrhs, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray, T* d_B,
+                                  int ldb, int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count)
+{
+  auto Aptr = detail::strided_pointers(d_A, (long long)lda * n, batchSize);
+  auto Bptr = detail::strided_pointers(d_B, (long long)ldb * nrhs, batchSize);
+  getrs_batched<T>(h, n, nrhs, Aptr.data(), lda, d_PivotArray, Bptr.data(),
+                   ldb, batchSize);
+}
+
+template <typename T>
+inline gt::blas::index_t getri_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int lda,
+                                                               int ldc,
+                                                               int batchSize)
+{
+  return 0;
+}
+
+// out of place, the inverse of the factored d_A is written to d_C
+template <typename T>
+inline void getri_strided_batched(handle_t& h, int n, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray, T* d_C,
+                                  int ldc, int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count,
+                                  int* d_infoArray = nullptr)
+{
+  auto Aptr = detail::strided_pointers(d_A, (long long)lda * n, batchSize);
+  auto Cptr = detail::strided_pointers(d_C, (long long)ldc * n, batchSize);
+  std::vector<int> info(d_infoArray ? 0 : batchSize);
+  getri_batched<T>(h, n, Aptr.data(), lda, d_PivotArray, Cptr.data(), ldc,
+                   d_infoArray ? d_infoArray : info.data(), batchSize);
+}
+
+template <typename T>
+inline void gemm_strided_batched(handle_t& h, int m, int n, int k, T alpha,
+                                 const T* d_A, int lda, long long strideA,
+                                 const T* d_B, int ldb, long long strideB,
+                                 T beta, T* d_C, int ldc, long long strideC,
+                                 int batchSize)
+{
+  auto Aptr =
+    detail::strided_pointers(const_cast<T*>(d_A), strideA, batchSize);
+  auto Bptr =
+    detail::strided_pointers(const_cast<T*>(d_B), strideB, batchSize);
+  auto Cptr = detail::strided_pointers(d_C, strideC, batchSize);
+  gemm_batched<T>(h, m, n, k, alpha, Aptr.data(), lda, Bptr.data(), ldb, beta,
+                  Cptr.data(), ldc, batchSize);
+}
 
 } // namespace blas
 
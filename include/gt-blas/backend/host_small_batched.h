@@ -0,0 +1,331 @@
+#ifndef GTENSOR_BLAS_HOST_SMALL_BATCHED_H
+#define GTENSOR_BLAS_HOST_SMALL_BATCHED_H
+
+#include <gtensor/gtensor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace gt
+{
+
+namespace blas
+{
+
+namespace detail
+{
+
+// ======================================================================
+// small batched LU
+//
+// Native getrf / getrs / getri for batches of small matrices, where the
+// per-call overhead of LAPACK dominates. Groups of `lanes` matrices are
+// gathered into an interleaved "batch innermost" buffer, element (i, j) of
+// lane l at ((j * n) + i) * lanes + l, so that every step of the
+// factorization is a loop over lanes the compiler can vectorize. Pivoting
+// is partial pivoting per lane, as in LAPACK (including 1-based pivots and
+// info > 0 for an exactly singular U). Common sizes are instantiated with a
+// compile-time n.
+
+template <typename T>
+struct small_batched_lanes
+{
+  // one cache line / AVX-512 register worth of batch members
+  static constexpr int value = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+};
+
+template <typename T>
+inline T pivot_abs(T a)
+{
+  return std::abs(a);
+}
+
+// |re| + |im| like LAPACK's i?amax for complex types
+template <typename R>
+inline R pivot_abs(gt::complex<R> a)
+{
+  return std::abs(a.real()) + std::abs(a.imag());
+}
+
+// copies count matrices (rows x cols, leading dimension ld) into the lanes
+// of buf; unused lanes are set to the identity, so they factor trivially
+template <typename T, int W>
+inline void small_gather(T* const* ptrs, int count, int rows, int cols,
+                         int ld, T* buf)
+{
+  for (int l = 0; l < W; l++) {
+    for (int j = 0; j < cols; j++) {
+      for (int i = 0; i < rows; i++) {
+        T v = l < count ? ptrs[l][j * ld + i] : T(i == j ? 1 : 0);
+        buf[(j * rows + i) * W + l] = v;
+      }
+    }
+  }
+}
+
+template <typename T, int W>
+inline void small_scatter(const T* buf, int count, int rows, int cols, int ld,
+                          T* const* ptrs)
+{
+  for (int l = 0; l < count; l++) {
+    for (int j = 0; j < cols; j++) {
+      for (int i = 0; i < rows; i++) {
+        ptrs[l][j * ld + i] = buf[(j * rows + i) * W + l];
+      }
+    }
+  }
+}
+
+// in-place LU of the W interleaved n x n matrices in a; piv[k * W + l] is
+// the 0-based row swapped with row k in lane l
+template <typename T, int N, int W>
+inline void small_getrf_lanes(int n_rt, T* a, int* piv, int* info)
+{
+  const int n = N > 0 ? N : n_rt;
+  auto A = [&](int i, int j) { return a + (j * n + i) * W; };
+
+  T inv[W];
+  for (int l = 0; l < W; l++) {
+    info[l] = 0;
+  }
+  for (int k = 0; k < n; k++) {
+    for (int l = 0; l < W; l++) {
+      int p = k;
+      auto pmax = pivot_abs(A(k, k)[l]);
+      for (int i = k + 1; i < n; i++) {
+        auto v = pivot_abs(A(i, k)[l]);
+        if (v > pmax) {
+          pmax = v;
+          p = i;
+        }
+      }
+      piv[k * W + l] = p;
+      if (p != k) {
+        for (int j = 0; j < n; j++) {
+          std::swap(A(k, j)[l], A(p, j)[l]);
+        }
+      }
+      // LAPACK leaves the column unscaled after a zero pivot
+      if (pmax == 0) {
+        if (info[l] == 0) {
+          info[l] = k + 1;
+        }
+        inv[l] = T(1);
+      } else {
+        inv[l] = T(1) / A(k, k)[l];
+      }
+    }
+
+    for (int i = k + 1; i < n; i++) {
+      T* aik = A(i, k);
+      for (int l = 0; l < W; l++) {
+        aik[l] *= inv[l];
+      }
+    }
+    for (int j = k + 1; j < n; j++) {
+      const T* akj = A(k, j);
+      for (int i = k + 1; i < n; i++) {
+        T* aij = A(i, j);
+        const T* aik = A(i, k);
+        for (int l = 0; l < W; l++) {
+          aij[l] -= aik[l] * akj[l];
+        }
+      }
+    }
+  }
+}
+
+// solves with the LU factors from small_getrf_lanes for the W interleaved
+// n x nrhs right hand sides in b
+template <typename T, int N, int W>
+inline void small_getrs_lanes(int n_rt, int nrhs, const T* a, const int* piv,
+                              T* b)
+{
+  const int n = N > 0 ? N : n_rt;
+  auto A = [&](int i, int j) { return a + (j * n + i) * W; };
+
+  for (int r = 0; r < nrhs; r++) {
+    auto B = [&](int i) { return b + (r * n + i) * W; };
+    for (int k = 0; k < n; k++) {
+      for (int l = 0; l < W; l++) {
+        int p = piv[k * W + l];
+        if (p != k) {
+          std::swap(B(k)[l], B(p)[l]);
+        }
+      }
+    }
+    // L y = P b, L unit lower triangular
+    for (int k = 0; k < n; k++) {
+      const T* bk = B(k);
+      for (int i = k + 1; i < n; i++) {
+        T* bi = B(i);
+        const T* aik = A(i, k);
+        for (int l = 0; l < W; l++) {
+          bi[l] -= aik[l] * bk[l];
+        }
+      }
+    }
+    // U x = y
+    for (int k = n - 1; k >= 0; k--) {
+      T* bk = B(k);
+      const T* akk = A(k, k);
+      for (int l = 0; l < W; l++) {
+        bk[l] /= akk[l];
+      }
+      for (int i = 0; i < k; i++) {
+        T* bi = B(i);
+        const T* aik = A(i, k);
+        for (int l = 0; l < W; l++) {
+          bi[l] -= aik[l] * bk[l];
+        }
+      }
+    }
+  }
+}
+
+// ======================================================================
+// batch drivers, for batch entries [begin, end)
+
+template <typename T, int N>
+inline void small_getrf_range(int n, T* const* d_Aarray, int lda,
+                              int* d_PivotArray, int* d_infoArray, int begin,
+                              int end)
+{
+  constexpr int W = small_batched_lanes<T>::value;
+  std::vector<T> a(n * n * W);
+  std::vector<int> piv(n * W);
+  int info[W];
+  for (int b0 = begin; b0 < end; b0 += W) {
+    int count = std::min(W, end - b0);
+    small_gather<T, W>(d_Aarray + b0, count, n, n, lda, a.data());
+    small_getrf_lanes<T, N, W>(n, a.data(), piv.data(), info);
+    small_scatter<T, W>(a.data(), count, n, n, lda, d_Aarray + b0);
+    for (int l = 0; l < count; l++) {
+      for (int k = 0; k < n; k++) {
+        d_PivotArray[(b0 + l) * n + k] = piv[k * W + l] + 1;
+      }
+      d_infoArray[b0 + l] = info[l];
+    }
+  }
+}
+
+// gathers the (1-based) pivots of lanes [b0, b0 + count) into piv
+template <int W>
+inline void small_gather_pivots(int n, const int* devIpiv, int b0, int count,
+                                int* piv)
+{
+  for (int k = 0; k < n; k++) {
+    for (int l = 0; l < W; l++) {
+      piv[k * W + l] = l < count ? devIpiv[(b0 + l) * n + k] - 1 : k;
+    }
+  }
+}
+
+template <typename T, int N>
+inline void small_getrs_range(int n, int nrhs, T* const* d_Aarray, int lda,
+                              const int* devIpiv, T* const* d_Barray, int ldb,
+                              int begin, int end)
+{
+  constexpr int W = small_batched_lanes<T>::value;
+  std::vector<T> a(n * n * W);
+  std::vector<T> b(n * nrhs * W);
+  std::vector<int> piv(n * W);
+  for (int b0 = begin; b0 < end; b0 += W) {
+    int count = std::min(W, end - b0);
+    small_gather<T, W>(d_Aarray + b0, count, n, n, lda, a.data());
+    small_gather<T, W>(d_Barray + b0, count, n, nrhs, ldb, b.data());
+    small_gather_pivots<W>(n, devIpiv, b0, count, piv.data());
+    small_getrs_lanes<T, N, W>(n, nrhs, a.data(), piv.data(), b.data());
+    small_scatter<T, W>(b.data(), count, n, nrhs, ldb, d_Barray + b0);
+  }
+}
+
+// inverse from the LU factors, by solving with the identity
+template <typename T, int N>
+inline void small_getri_range(int n, T* const* d_Aarray, int lda,
+                              const int* devIpiv, T* const* d_Carray, int ldc,
+                              int* d_infoArray, int begin, int end)
+{
+  constexpr int W = small_batched_lanes<T>::value;
+  std::vector<T> a(n * n * W);
+  std::vector<T> c(n * n * W);
+  std::vector<int> piv(n * W);
+  for (int b0 = begin; b0 < end; b0 += W) {
+    int count = std::min(W, end - b0);
+    small_gather<T, W>(d_Aarray + b0, count, n, n, lda, a.data());
+    small_gather_pivots<W>(n, devIpiv, b0, count, piv.data());
+    for (int j = 0; j < n; j++) {
+      for (int i = 0; i < n; i++) {
+        for (int l = 0; l < W; l++) {
+          c[(j * n + i) * W + l] = T(i == j ? 1 : 0);
+        }
+      }
+    }
+    small_getrs_lanes<T, N, W>(n, n, a.data(), piv.data(), c.data());
+    small_scatter<T, W>(c.data(), count, n, n, ldc, d_Carray + b0);
+    for (int l = 0; l < count; l++) {
+      d_infoArray[b0 + l] = 0;
+      for (int k = 0; k < n; k++) {
+        if (a[(k * n + k) * W + l] == T(0)) {
+          d_infoArray[b0 + l] = k + 1;
+          break;
+        }
+      }
+    }
+  }
+}
+
+// calls F::template run<N>(args...) with a compile-time N for common sizes,
+// N = 0 (runtime size) otherwise
+template <typename F, typename... Args>
+inline void small_batched_dispatch(int n, Args&&... args)
+{
+  switch (n) {
+    case 2: F::template run<2>(std::forward<Args>(args)...); break;
+    case 3: F::template run<3>(std::forward<Args>(args)...); break;
+    case 4: F::template run<4>(std::forward<Args>(args)...); break;
+    case 8: F::template run<8>(std::forward<Args>(args)...); break;
+    case 16: F::template run<16>(std::forward<Args>(args)...); break;
+    default: F::template run<0>(std::forward<Args>(args)...); break;
+  }
+}
+
+template <typename T>
+struct small_getrf
+{
+  template <int N, typename... Args>
+  static void run(Args&&... args)
+  {
+    small_getrf_range<T, N>(std::forward<Args>(args)...);
+  }
+};
+
+template <typename T>
+struct small_getrs
+{
+  template <int N, typename... Args>
+  static void run(Args&&... args)
+  {
+    small_getrs_range<T, N>(std::forward<Args>(args)...);
+  }
+};
+
+template <typename T>
+struct small_getri
+{
+  template <int N, typename... Args>
+  static void run(Args&&... args)
+  {
+    small_getri_range<T, N>(std::forward<Args>(args)...);
+  }
+};
+
+} // namespace detail
+
+} // namespace blas
+
+} // namespace gt
+
+#endif
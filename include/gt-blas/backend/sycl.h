@@ -1,6 +1,8 @@
 #ifndef GTENSOR_BLAS_HIP_H
 #define GTENSOR_BLAS_HIP_H
 
+#include <stdexcept>
+
 #include "gtensor/backend_sycl.h"
 #include "gtensor/complex.h"
 #include "oneapi/mkl.hpp"
@@ -289,7 +291,13 @@ inline void getri_batched(handle_t& h, int n, T** d_Aarray, int lda,
   e.wait();
 }
 
-// Strided getrf/s, oneMKL specific
+// ======================================================================
+// strided batched
+//
+// Batch entry b of A lives at d_A + b * lda * n, its pivots at
+// d_PivotArray + b * n and its right hand sides at d_B + b * ldb * nrhs.
+// oneMKL reports failures by throwing, so like getrf_batched, a given
+// d_infoArray is set to zero once the call has succeeded.
 
 template <typename T>
 inline gt::blas::index_t getrf_strided_batched_scratchpad_size(handle_t& h,
@@ -299,19 +307,24 @@ inline gt::blas::index_t getrf_strided_batched_scratchpad_size(handle_t& h,
   using T2 = typename make_std<T>::type;
   sycl::queue& q = h.get_backend_handle();
   return oneapi::mkl::lapack::getrf_batch_scratchpad_size<T2>(
-    q, n, n, lda, n * n, n, batchSize);
+    q, n, n, lda, index_t(lda) * n, n, batchSize);
 }
 
 template <typename T>
 inline void getrf_strided_batched(handle_t& h, int n, T* d_A, int lda,
                                   gt::blas::index_t* d_PivotArray,
                                   int batchSize, T* d_scratch,
-                                  gt::blas::index_t scratch_count)
+                                  gt::blas::index_t scratch_count,
+                                  int* d_infoArray = nullptr)
 {
   sycl::queue& q = h.get_backend_handle();
-  oneapi::mkl::lapack::getrf_batch(q, n, n, std_cast(d_A), lda, n * n,
-                                   std_cast(d_PivotArray), n, batchSize,
-                                   std_cast(d_scratch), scratch_count);
+  oneapi::mkl::lapack::getrf_batch(q, n, n, std_cast(d_A), lda,
+                                   index_t(lda) * n, std_cast(d_PivotArray), n,
+                                   batchSize, std_cast(d_scratch),
+                                   scratch_count);
+  if (d_infoArray) {
+    q.memset(d_infoArray, 0, sizeof(int) * batchSize);
+  }
 }
 
 template <typename T>
@@ -323,8 +336,8 @@ inline gt::blas::index_t getrs_strided_batched_scratchpad_size(handle_t& h,
   using T2 = typename make_std<T>::type;
   sycl::queue& q = h.get_backend_handle();
   return oneapi::mkl::lapack::getrs_batch_scratchpad_size<T2>(
-    q, oneapi::mkl::transpose::nontrans, n, nrhs, lda, n * n, n, ldb, n * nrhs,
-    batchSize);
+    q, oneapi::mkl::transpose::nontrans, n, nrhs, lda, index_t(lda) * n, n,
+    ldb, index_t(ldb) * nrhs, batchSize);
 }
 
 template <typename T>
@@ -335,9 +348,65 @@ inline void getrs_strided_batched(handle_t& h, int n, int nrhs, T* d_A, int lda,
 {
   sycl::queue& q = h.get_backend_handle();
   oneapi::mkl::lapack::getrs_batch(
-    q, oneapi::mkl::transpose::nontrans, n, nrhs, std_cast(d_A), lda, n * n,
-    std_cast(d_PivotArray), n, std_cast(d_B), ldb, n * nrhs, batchSize,
-    std_cast(d_scratch), scratch_count);
+    q, oneapi::mkl::transpose::nontrans, n, nrhs, std_cast(d_A), lda,
+    index_t(lda) * n, std_cast(d_PivotArray), n, std_cast(d_B), ldb,
+    index_t(ldb) * nrhs, batchSize, std_cast(d_scratch), scratch_count);
+}
+
+template <typename T>
+inline gt::blas::index_t getri_strided_batched_scratchpad_size(handle_t& h,
+                                                               int n, int lda,
+                                                               int ldc,
+                                                               int batchSize)
+{
+  using T2 = typename make_std<T>::type;
+  sycl::queue& q = h.get_backend_handle();
+  return oneapi::mkl::lapack::getri_batch_scratchpad_size<T2>(
+    q, n, ldc, index_t(ldc) * n, n, batchSize);
+}
+
+// out of place like getri_batched: the factored d_A is copied to d_C, which
+// is then inverted in place. Columns of all entries are equally spaced on
+// both sides, so a single pitched copy handles lda != ldc.
+template <typename T>
+inline void getri_strided_batched(handle_t& h, int n, T* d_A, int lda,
+                                  gt::blas::index_t* d_PivotArray, T* d_C,
+                                  int ldc, int batchSize, T* d_scratch,
+                                  gt::blas::index_t scratch_count,
+                                  int* d_infoArray = nullptr)
+{
+  if (lda < n || ldc < n) {
+    throw std::invalid_argument(
+      "getri_strided_batched: leading dimensions must be at least n");
+  }
+  sycl::queue& q = h.get_backend_handle();
+  if (lda == ldc) {
+    q.copy(d_A, d_C, index_t(lda) * n * batchSize);
+  } else {
+    gt::backend::copy_impl::sycl_copy_2d_device_async(
+      d_A, lda, d_C, ldc, n, gt::size_type(n) * batchSize, q);
+  }
+  oneapi::mkl::lapack::getri_batch(q, n, std_cast(d_C), ldc, index_t(ldc) * n,
+                                   std_cast(d_PivotArray), n, batchSize,
+                                   std_cast(d_scratch), scratch_count);
+  if (d_infoArray) {
+    q.memset(d_infoArray, 0, sizeof(int) * batchSize);
+  }
+}
+
+template <typename T>
+inline void gemm_strided_batched(handle_t& h, int m, int n, int k, T alpha,
+                                 const T* d_A, int lda, long long strideA,
+                                 const T* d_B, int ldb, long long strideB,
+                                 T beta, T* d_C, int ldc, long long strideC,
+                                 int batchSize)
+{
+  sycl::queue& q = h.get_backend_handle();
+  auto trans_op = oneapi::mkl::transpose::nontrans;
+  oneapi::mkl::blas::gemm_batch(
+    q, trans_op, trans_op, m, n, k, *std_cast(&alpha), std_cast(d_A), lda,
+    strideA, std_cast(d_B), ldb, strideB, *std_cast(&beta), std_cast(d_C), ldc,
+    strideC, batchSize);
 }
 
 template <typename T>
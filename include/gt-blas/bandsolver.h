@@ -1,6 +1,9 @@
 #ifndef GTENSOR_BANDSOLVE_H
 #define GTENSOR_BANDSOLVE_H
 
+#include <stdexcept>
+#include <type_traits>
+
 #include "gtensor/complex.h"
 #include "gtensor/reductions.h"
 
@@ -22,6 +25,129 @@ struct matrix_bandwidth
   int upper;
 };
 
+namespace detail
+{
+
+// element (i, j) of a column major matrix in full storage
+template <typename T>
+struct dense_band_ref
+{
+  T* a;
+  int lda;
+
+  GT_INLINE T& operator()(int i, int j) const { return a[j * lda + i]; }
+};
+
+// element (i, j) of a matrix in LAPACK band storage, at row kv + i - j of
+// column j, kv = lbw + ubw
+template <typename T>
+struct compact_band_ref
+{
+  T* ab;
+  int ldab;
+  int kv;
+
+  GT_INLINE T& operator()(int i, int j) const
+  {
+    return ab[j * ldab + kv + i - j];
+  }
+};
+
+// LU factorization with partial pivoting of an n x n matrix with lower /
+// upper bandwidth lbw / ubw, as LAPACK ?gbtf2: the pivot row is searched
+// within the band only, and row interchanges are applied to the trailing
+// columns only, so column k of L keeps its multipliers in rows
+// k + 1 .. k + lbw. U gets upper bandwidth lbw + ubw from the fill-in,
+// which A must have room for (and be zero in). piv is 1-based, info as in
+// getrf.
+template <typename T, typename Ref>
+GT_INLINE void band_getrf(int n, int lbw, int ubw, const Ref& A,
+                          index_t* piv, int* info)
+{
+  const int ku = lbw + ubw;
+  *info = 0;
+  for (int k = 0; k < n; k++) {
+    const int imax = k + lbw < n - 1 ? k + lbw : n - 1;
+    const int jmax = k + ku < n - 1 ? k + ku : n - 1;
+
+    int p = k;
+    auto pmax = gt::abs(A(k, k));
+    for (int i = k + 1; i <= imax; i++) {
+      auto v = gt::abs(A(i, k));
+      if (v > pmax) {
+        pmax = v;
+        p = i;
+      }
+    }
+    piv[k] = p + 1;
+
+    // LAPACK leaves the column unscaled after a zero pivot
+    if (pmax == 0) {
+      if (*info == 0) {
+        *info = k + 1;
+      }
+      continue;
+    }
+
+    if (p != k) {
+      for (int j = k; j <= jmax; j++) {
+        T tmp = A(k, j);
+        A(k, j) = A(p, j);
+        A(p, j) = tmp;
+      }
+    }
+
+    T inv = T(1) / A(k, k);
+    for (int i = k + 1; i <= imax; i++) {
+      A(i, k) *= inv;
+    }
+    for (int j = k + 1; j <= jmax; j++) {
+      T akj = A(k, j);
+      if (akj != T(0)) {
+        for (int i = k + 1; i <= imax; i++) {
+          A(i, j) -= A(i, k) * akj;
+        }
+      }
+    }
+  }
+}
+
+// solves with the factors of band_getrf for one right hand side, applying
+// the row interchanges as the elimination proceeds like LAPACK ?gbtrs
+template <typename T, typename Ref>
+GT_INLINE void band_getrs(int n, int lbw, int ubw, const Ref& A,
+                          const index_t* piv, T* B)
+{
+  const int ku = lbw + ubw;
+
+  // L y = P b, L unit lower triangular
+  for (int k = 0; k < n - 1; k++) {
+    const int imax = k + lbw < n - 1 ? k + lbw : n - 1;
+    const int p = piv[k] - 1;
+    if (p != k) {
+      T tmp = B[k];
+      B[k] = B[p];
+      B[p] = tmp;
+    }
+    T x = B[k];
+    for (int i = k + 1; i <= imax; i++) {
+      B[i] -= A(i, k) * x;
+    }
+  }
+
+  // U x = y
+  for (int i = n - 1; i >= 0; i--) {
+    const int jmax = i + ku < n - 1 ? i + ku : n - 1;
+    T tmp = B[i];
+    for (int j = i + 1; j <= jmax; j++) {
+      tmp -= A(i, j) * B[j];
+    }
+    B[i] = tmp / A(i, i);
+  }
+}
+
+} // namespace detail
+
 /**
  * Calculate max bandwidth in a batch of square matrices.
  *
@@ -373,6 +499,280 @@ inline void invert_banded_batched(handle_t& h, int n, T** d_Aarray, int lda,
     stream);
 }
 
+/**
+ * LU factor a batch of banded square matrices in place, with partial
+ * pivoting restricted to the band.
+ *
+ * Takes O(n * lbw * (lbw + ubw)) per matrix, rather than the O(n^3) of
+ * getrf_batched. Pivoting grows the upper bandwidth of U to lbw + ubw,
+ * and the row interchanges are not applied to the L part (as in LAPACK
+ * ?gbtrf), so the factors must be solved with getrs_banded_lu_batched(),
+ * not getrs_batched() or getrs_banded_batched().
+ *
+ * @see gt::blas::get_max_bandwidth()
+ * @see gt::blas::getrs_banded_lu_batched()
+ *
+ * @param h gt::blas::handle_t object
+ * @param n size of each A_i
+ * @param d_Aarray Array of device pointers to each input / output A_i
+ * @param lda leading distance of each A_i, >=n
+ * @param d_PivotArray output pivots, n per matrix, 1-based
+ * @param d_infoArray output info per matrix, k > 0 if U(k, k) is zero
+ * @param batchSize number of matrices [A_i] in batch
+ * @param lbw max lower bandwidth of all [A_i]
+ * @param ubw max upper bandwidth of all [A_i]
+ */
+template <typename T>
+inline void getrf_banded_batched(handle_t& h, int n, T** d_Aarray, int lda,
+                                 index_t* d_PivotArray, int* d_infoArray,
+                                 int batchSize, int lbw, int ubw)
+{
+#ifdef GTENSOR_HAVE_DEVICE
+  gt::launch<1>(
+    gt::shape(batchSize),
+    GT_LAMBDA(int batch) {
+      detail::band_getrf<T>(n, lbw, ubw,
+                            detail::dense_band_ref<T>{d_Aarray[batch], lda},
+                            d_PivotArray + batch * n, d_infoArray + batch);
+    },
+    h.get_stream());
+#else
+  h.wait_for_stream();
+  h.parallel_batch(batchSize, [&](int begin, int end) {
+    for (int batch = begin; batch < end; batch++) {
+      detail::band_getrf<T>(n, lbw, ubw,
+                            detail::dense_band_ref<T>{d_Aarray[batch], lda},
+                            d_PivotArray + batch * n, d_infoArray + batch);
+    }
+  });
+#endif
+}
+
+/**
+ * Solve a batch of banded square matrices factored by getrf_banded_batched.
+ *
+ * @see gt::blas::getrf_banded_batched()
+ *
+ * @param h gt::blas::handle_t object
+ * @param n size of each A_i and number of rows of each B_i
+ * @param nrhs number of RHS column vectors in each B_i
+ * @param d_Aarray Array of device pointers to LU factored input [A_i]
+ * @param lda leading distance of each A_i, >=n
+ * @param d_PivotArray pivots from getrf_banded_batched
+ * @param d_Barray Array of device pointers to each RHS/output [B_i]
+ * @param ldb leading distance of each B_i, >=n
+ * @param batchSize number of matrices [A_i] and [B_i] in batch
+ * @param lbw max lower bandwidth of all [A_i] (before factoring)
+ * @param ubw max upper bandwidth of all [A_i] (before factoring)
+ */
+template <typename T>
+inline void getrs_banded_lu_batched(handle_t& h, int n, int nrhs,
+                                    T** d_Aarray, int lda,
+                                    index_t* d_PivotArray, T** d_Barray,
+                                    int ldb, int batchSize, int lbw, int ubw)
+{
+  gt::launch<2>(
+    gt::shape(nrhs, batchSize),
+    GT_LAMBDA(int rhs, int batch) {
+      detail::band_getrs<T>(n, lbw, ubw,
+                            detail::dense_band_ref<T>{d_Aarray[batch], lda},
+                            d_PivotArray + batch * n,
+                            d_Barray[batch] + ldb * rhs);
+    },
+    h.get_stream());
+}
+
+// ======================================================================
+// band_matrix_batch
+//
+// A batch of n x n band matrices in LAPACK band storage (as for ?gbtrf):
+// column j of matrix b holds rows j - ubw .. j + lbw in
+// data(r, j, b), r = lbw + ubw + i - j, with lbw extra rows at the top for
+// the fill-in of the factorization, ldab = 2 * lbw + ubw + 1. This takes
+// ldab / n of the memory of full storage. Factor with
+// getrf_banded_batched(), solve with getrs_banded_lu_batched().
+
+template <typename T, typename S = gt::space::device>
+class band_matrix_batch
+{
+public:
+  using value_type = T;
+  using space_type = S;
+
+  band_matrix_batch(int n, matrix_bandwidth bw, int nbatches)
+    : n_(n),
+      nbatches_(nbatches),
+      bw_(bw),
+      data_(gt::shape(2 * bw.lower + bw.upper + 1, n, nbatches))
+  {
+    data_.fill(T(0));
+  }
+
+  // from dense n x n x nbatches data with (at most) bandwidth bw, see
+  // get_max_bandwidth(); entries outside of the band are ignored. The
+  // values are filled in on stream, which should be the stream of the handle
+  // used to factor (h.get_stream()) if that is not the default stream.
+  template <typename BatchData>
+  band_matrix_batch(BatchData& d_matrix_batches, matrix_bandwidth bw,
+                    gt::stream_view stream = gt::stream_view{})
+    : band_matrix_batch(d_matrix_batches.shape(0), bw,
+                        d_matrix_batches.shape(2))
+  {
+    update(d_matrix_batches, stream);
+  }
+
+  // replaces the values from dense data like the constructor, e.g. to
+  // refactor after getrf_banded_batched() overwrote them
+  template <typename BatchData>
+  void update(BatchData& d_matrix_batches,
+              gt::stream_view stream = gt::stream_view{})
+  {
+    static_assert(expr_dimension<BatchData>() == 3,
+                  "band_matrix_batch requires a 3d object");
+    if (d_matrix_batches.shape(0) != n_ || d_matrix_batches.shape(1) != n_ ||
+        d_matrix_batches.shape(2) != nbatches_) {
+      throw std::runtime_error(
+        "band_matrix_batch: cannot update from " +
+        to_string(d_matrix_batches.shape()) + ", expected " +
+        to_string(gt::shape(n_, n_, nbatches_)));
+    }
+    auto k_matrix = d_matrix_batches.to_kernel();
+    auto k_data = data_.to_kernel();
+    int n = n_;
+    int lbw = bw_.lower;
+    int kv = bw_.lower + bw_.upper;
+    gt::launch<3, S>(
+      data_.shape(), GT_LAMBDA(int r, int j, int b) {
+        int i = r - kv + j;
+        k_data(r, j, b) =
+          (r >= lbw && i >= 0 && i < n) ? k_matrix(i, j, b) : T(0);
+      },
+      stream);
+  }
+
+  int n() const { return n_; }
+  int nbatches() const { return nbatches_; }
+  matrix_bandwidth bandwidth() const { return bw_; }
+  int ldab() const { return data_.shape(0); }
+
+  // (i, j) of batch b is at data(lbw + ubw + i - j, j, b)
+  auto& data() { return data_; }
+  const auto& data() const { return data_; }
+
+  // band storage of batch b, ldab x n
+  T* batch_data(int b)
+  {
+    return gt::raw_pointer_cast(data_.data()) +
+           gt::size_type(b) * ldab() * n_;
+  }
+  const T* batch_data(int b) const
+  {
+    return gt::raw_pointer_cast(data_.data()) +
+           gt::size_type(b) * ldab() * n_;
+  }
+
+private:
+  int n_;
+  int nbatches_;
+  matrix_bandwidth bw_;
+  gt::gtensor<T, 3, S> data_;
+};
+
+namespace detail
+{
+
+// the handle's stream for device data; host data is worked on inline
+template <typename S>
+gt::stream_view band_stream(handle_t& h)
+{
+  return std::is_same<S, gt::space::device>::value ? h.get_stream()
+                                                   : gt::stream_view{};
+}
+
+} // namespace detail
+
+/**
+ * LU factor a batch of band matrices in band storage in place.
+ *
+ * Same as the full storage version, but only reads and writes the
+ * ldab x n band storage of each matrix.
+ *
+ * @see gt::blas::band_matrix_batch
+ *
+ * @param h gt::blas::handle_t object
+ * @param A batch of band matrices, overwritten with the LU factors
+ * @param d_PivotArray output pivots, n per matrix, 1-based, in space S
+ * @param d_infoArray output info per matrix, k > 0 if U(k, k) is zero, in
+ *   space S
+ */
+template <typename T, typename S>
+inline void getrf_banded_batched(handle_t& h, band_matrix_batch<T, S>& A,
+                                 index_t* d_PivotArray, int* d_infoArray)
+{
+  int n = A.n();
+  int lbw = A.bandwidth().lower;
+  int ubw = A.bandwidth().upper;
+  int ldab = A.ldab();
+  T* ab = A.batch_data(0);
+#ifdef GTENSOR_HAVE_DEVICE
+  gt::launch<1, S>(
+    gt::shape(A.nbatches()),
+    GT_LAMBDA(int batch) {
+      detail::band_getrf<T>(
+        n, lbw, ubw,
+        detail::compact_band_ref<T>{ab + gt::size_type(batch) * ldab * n,
+                                    ldab, lbw + ubw},
+        d_PivotArray + batch * n, d_infoArray + batch);
+    },
+    detail::band_stream<S>(h));
+#else
+  h.wait_for_stream();
+  h.parallel_batch(A.nbatches(), [&](int begin, int end) {
+    for (int batch = begin; batch < end; batch++) {
+      detail::band_getrf<T>(
+        n, lbw, ubw,
+        detail::compact_band_ref<T>{ab + gt::size_type(batch) * ldab * n,
+                                    ldab, lbw + ubw},
+        d_PivotArray + batch * n, d_infoArray + batch);
+    }
+  });
+#endif
+}
+
+/**
+ * Solve a batch of band matrices in band storage, factored by
+ * getrf_banded_batched().
+ *
+ * @param h gt::blas::handle_t object
+ * @param nrhs number of RHS column vectors in each B_i
+ * @param A batch of LU factored band matrices
+ * @param d_PivotArray pivots from getrf_banded_batched
+ * @param d_Barray Array of pointers to each RHS/output [B_i], all in space S
+ * @param ldb leading distance of each B_i, >=n
+ */
+template <typename T, typename S>
+inline void getrs_banded_lu_batched(handle_t& h, int nrhs,
+                                    const band_matrix_batch<T, S>& A,
+                                    index_t* d_PivotArray, T** d_Barray,
+                                    int ldb)
+{
+  int n = A.n();
+  int lbw = A.bandwidth().lower;
+  int ubw = A.bandwidth().upper;
+  int ldab = A.ldab();
+  const T* ab = A.batch_data(0);
+  gt::launch<2, S>(
+    gt::shape(nrhs, A.nbatches()),
+    GT_LAMBDA(int rhs, int batch) {
+      detail::band_getrs<T>(
+        n, lbw, ubw,
+        detail::compact_band_ref<const T>{ab + gt::size_type(batch) * ldab * n,
+                                          ldab, lbw + ubw},
+        d_PivotArray + batch * n, d_Barray[batch] + ldb * rhs);
+    },
+    detail::band_stream<S>(h));
+}
+
 /**
  * Naive batched matrix multiply for solving with inverted matrices C = A^-1 * B
  *
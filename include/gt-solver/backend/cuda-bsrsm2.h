@@ -181,21 +181,7 @@ public:
     l_buf_.resize(gt::shape(l_buf_size));
     u_buf_.resize(gt::shape(u_buf_size));
 
-    gtSparseCheck(FN::analysis(
-      h_.get_backend_handle(), CUSPARSE_DIRECTION_COLUMN,
-      CUSPARSE_OPERATION_NON_TRANSPOSE, CUSPARSE_OPERATION_NON_TRANSPOSE,
-      csr_mat_.shape(0), nrhs_, csr_mat_.nnz(), l_desc_,
-      FN::cast_pointer(csr_mat_.values_data()), csr_mat_.row_ptr_data(),
-      csr_mat_.col_ind_data(), 1, l_info_, policy_,
-      FN::cast_pointer(l_buf_.data())));
-
-    gtSparseCheck(FN::analysis(
-      h_.get_backend_handle(), CUSPARSE_DIRECTION_COLUMN,
-      CUSPARSE_OPERATION_NON_TRANSPOSE, CUSPARSE_OPERATION_NON_TRANSPOSE,
-      csr_mat_.shape(0), nrhs_, csr_mat_.nnz(), u_desc_,
-      FN::cast_pointer(csr_mat_.values_data()), csr_mat_.row_ptr_data(),
-      csr_mat_.col_ind_data(), 1, u_info_, policy_,
-      FN::cast_pointer(u_buf_.data())));
+    analyze();
   }
 
   ~csr_matrix_lu_cuda_bsrsm2()
@@ -204,6 +190,9 @@ public:
     cusparseDestroyBsrsm2Info(u_info_);
   }
 
+  // the values of csr_mat were updated in place, same sparsity pattern
+  void update() { analyze(); }
+
   void solve(T* rhs, T* result)
   {
     gt::copy_n(gt::device_pointer_cast(rhs), rhs_tmp_.size(), rhs_tmp_.data());
@@ -238,6 +227,25 @@ public:
   }
 
 private:
+  void analyze()
+  {
+    gtSparseCheck(FN::analysis(
+      h_.get_backend_handle(), CUSPARSE_DIRECTION_COLUMN,
+      CUSPARSE_OPERATION_NON_TRANSPOSE, CUSPARSE_OPERATION_NON_TRANSPOSE,
+      csr_mat_.shape(0), nrhs_, csr_mat_.nnz(), l_desc_,
+      FN::cast_pointer(csr_mat_.values_data()), csr_mat_.row_ptr_data(),
+      csr_mat_.col_ind_data(), 1, l_info_, policy_,
+      FN::cast_pointer(l_buf_.data())));
+
+    gtSparseCheck(FN::analysis(
+      h_.get_backend_handle(), CUSPARSE_DIRECTION_COLUMN,
+      CUSPARSE_OPERATION_NON_TRANSPOSE, CUSPARSE_OPERATION_NON_TRANSPOSE,
+      csr_mat_.shape(0), nrhs_, csr_mat_.nnz(), u_desc_,
+      FN::cast_pointer(csr_mat_.values_data()), csr_mat_.row_ptr_data(),
+      csr_mat_.col_ind_data(), 1, u_info_, policy_,
+      FN::cast_pointer(u_buf_.data())));
+  }
+
   gt::sparse::csr_matrix<T, space_type>& csr_mat_;
   const T alpha_;
   int nrhs_;
@@ -189,17 +189,7 @@ public:
     l_buf_.resize(gt::shape(l_buf_size));
     u_buf_.resize(gt::shape(u_buf_size));
 
-    gtSparseCheck(cusparseSpSM_analysis(
-      h_.get_backend_handle(), CUSPARSE_OPERATION_NON_TRANSPOSE,
-      CUSPARSE_OPERATION_NON_TRANSPOSE, FN::cast_pointer(&alpha_), l_desc_,
-      result_desc_, rhs_desc_, FN::dtype, algo_, l_spsm_desc_,
-      FN::cast_pointer(l_buf_.data())));
-
-    gtSparseCheck(cusparseSpSM_analysis(
-      h_.get_backend_handle(), CUSPARSE_OPERATION_NON_TRANSPOSE,
-      CUSPARSE_OPERATION_NON_TRANSPOSE, FN::cast_pointer(&alpha_), u_desc_,
-      rhs_desc_, result_desc_, FN::dtype, algo_, u_spsm_desc_,
-      FN::cast_pointer(u_buf_.data())));
+    analyze();
   }
 
   ~csr_matrix_lu_cuda_generic()
@@ -212,6 +202,9 @@ public:
     gtSparseCheck(cusparseDestroyDnMat(result_desc_));
   }
 
+  // the values of csr_mat were updated in place, same sparsity pattern
+  void update() { analyze(); }
+
   void solve(T* rhs, T* result)
   {
     gt::copy_n(gt::device_pointer_cast(rhs), result_tmp_.size(),
@@ -237,6 +230,21 @@ public:
   }
 
 private:
+  void analyze()
+  {
+    gtSparseCheck(cusparseSpSM_analysis(
+      h_.get_backend_handle(), CUSPARSE_OPERATION_NON_TRANSPOSE,
+      CUSPARSE_OPERATION_NON_TRANSPOSE, FN::cast_pointer(&alpha_), l_desc_,
+      result_desc_, rhs_desc_, FN::dtype, algo_, l_spsm_desc_,
+      FN::cast_pointer(l_buf_.data())));
+
+    gtSparseCheck(cusparseSpSM_analysis(
+      h_.get_backend_handle(), CUSPARSE_OPERATION_NON_TRANSPOSE,
+      CUSPARSE_OPERATION_NON_TRANSPOSE, FN::cast_pointer(&alpha_), u_desc_,
+      rhs_desc_, result_desc_, FN::dtype, algo_, u_spsm_desc_,
+      FN::cast_pointer(u_buf_.data())));
+  }
+
   gt::sparse::csr_matrix<T, space_type>& csr_mat_;
   const T alpha_;
   int nrhs_;
@@ -0,0 +1,234 @@
+#ifndef GTENSOR_SOLVER_HOST_H
+#define GTENSOR_SOLVER_HOST_H
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "gtensor/gtensor.h"
+#include "gtensor/sparse.h"
+
+#include "gt-blas/blas.h"
+
+namespace gt
+{
+
+namespace solver
+{
+
+class sparse_handle_host
+  : public gt::blas::detail::handle_base<sparse_handle_host,
+                                         gt::blas::dummy_handle>
+{
+public:
+  void set_stream(gt::stream_view sview) { stream_ = sview; }
+
+  gt::stream_view get_stream() { return stream_; }
+
+private:
+  gt::stream_view stream_;
+};
+
+using sparse_handle_t = sparse_handle_host;
+
+// ======================================================================
+// csr_matrix_lu_host
+//
+// Triangular solves with the L (unit diagonal) and U factors stored
+// together in one CSR matrix, as produced by factoring without pivoting.
+// The rows are grouped into levels ("wavefronts") at construction: a row
+// depends only on rows of earlier levels, so the rows within a level are
+// independent and are solved in parallel on the gt-blas batch thread pool.
+// For the block diagonal matrices of solver_sparse, each level contains
+// one row of every batch.
+
+template <typename T>
+class csr_matrix_lu_host
+{
+public:
+  using value_type = T;
+  using space_type = gt::space::device;
+
+  csr_matrix_lu_host(gt::sparse::csr_matrix<T, space_type>& csr_mat,
+                     const T alpha, int nrhs,
+                     gt::stream_view sview = gt::stream_view{})
+    : csr_mat_(csr_mat),
+      alpha_(alpha),
+      nrhs_(nrhs),
+      rhs_tmp_(gt::shape(csr_mat.shape(0), nrhs)),
+      diag_ind_(csr_mat.shape(0))
+  {
+    h_.set_stream(sview);
+    analyze();
+  }
+
+  // the values of csr_mat were updated in place, same sparsity pattern; the
+  // levels only depend on the pattern, so there is nothing to redo
+  void update() {}
+
+  // result = alpha * (LU)^-1 rhs, for nrhs column major right hand sides
+  void solve(T* rhs, T* result)
+  {
+    const int n = csr_mat_.shape(0);
+    const int* row_ptr = csr_mat_.row_ptr_data();
+    const int* col_ind = csr_mat_.col_ind_data();
+    const T* values = csr_mat_.values_data();
+    const int* diag_ind = diag_ind_.data();
+    T* x = rhs_tmp_.data();
+    const T alpha = alpha_;
+
+    // the solve runs on the calling thread, after the work queued on the
+    // stream
+    h_.get_stream().synchronize();
+    gt::copy_n(rhs, rhs_tmp_.size(), x);
+
+    // L y = alpha b, L unit lower triangular
+    for_each_level(l_levels_, [&](int i) {
+      for (int r = 0; r < nrhs_; r++) {
+        T* xr = x + r * n;
+        T sum = alpha * xr[i];
+        for (int idx = row_ptr[i]; idx < diag_ind[i]; idx++) {
+          sum -= values[idx] * xr[col_ind[idx]];
+        }
+        xr[i] = sum;
+      }
+    });
+
+    // U x = y
+    for_each_level(u_levels_, [&](int i) {
+      for (int r = 0; r < nrhs_; r++) {
+        T* xr = x + r * n;
+        T sum = xr[i];
+        for (int idx = diag_ind[i] + 1; idx < row_ptr[i + 1]; idx++) {
+          sum -= values[idx] * xr[col_ind[idx]];
+        }
+        xr[i] = sum / values[diag_ind[i]];
+      }
+    });
+
+    gt::copy_n(x, rhs_tmp_.size(), result);
+  }
+
+  std::size_t get_device_memory_usage()
+  {
+    size_t nelements = csr_mat_.nnz() + rhs_tmp_.size();
+    size_t nint = csr_mat_.nnz() + csr_mat_.shape(0) + 1 + diag_ind_.size() +
+                  l_levels_.memory_size() + u_levels_.memory_size();
+    return nelements * sizeof(T) + nint * sizeof(int);
+  }
+
+private:
+  // rows of level k are rows[ptr[k]], ..., rows[ptr[k + 1] - 1]
+  struct levels
+  {
+    std::vector<int> ptr;
+    std::vector<int> rows;
+
+    int size() const { return ptr.size() - 1; }
+    size_t memory_size() const { return ptr.size() + rows.size(); }
+  };
+
+  // levels with fewer rows than this are not worth waking up the pool for
+  static constexpr int min_parallel_rows = 64;
+
+  template <typename F>
+  void for_each_level(const levels& lv, const F& f)
+  {
+    auto& pool = gt::blas::detail::batch_thread_pool::instance();
+    for (int k = 0; k < lv.size(); k++) {
+      const int* rows = lv.rows.data() + lv.ptr[k];
+      int count = lv.ptr[k + 1] - lv.ptr[k];
+      auto body = [&](int begin, int end) {
+        for (int j = begin; j < end; j++) {
+          f(rows[j]);
+        }
+      };
+      if (count < min_parallel_rows || pool.num_threads() == 1) {
+        body(0, count);
+      } else {
+        int chunk = std::max(16, count / (4 * pool.num_threads()));
+        pool.parallel_for(count, chunk, pool.num_threads(), body);
+      }
+    }
+  }
+
+  // groups rows by level, given the level of each row
+  static levels group_levels(const std::vector<int>& level, int n_levels)
+  {
+    levels lv;
+    lv.ptr.assign(n_levels + 1, 0);
+    for (int l : level) {
+      lv.ptr[l + 1]++;
+    }
+    for (int k = 0; k < n_levels; k++) {
+      lv.ptr[k + 1] += lv.ptr[k];
+    }
+    int n = level.size();
+    lv.rows.resize(n);
+    std::vector<int> pos(lv.ptr.begin(), lv.ptr.end() - 1);
+    for (int i = 0; i < n; i++) {
+      lv.rows[pos[level[i]]++] = i;
+    }
+    return lv;
+  }
+
+  void analyze()
+  {
+    const int n = csr_mat_.shape(0);
+    const int* row_ptr = csr_mat_.row_ptr_data();
+    const int* col_ind = csr_mat_.col_ind_data();
+
+    // column indices are sorted within a row, find the diagonal
+    for (int i = 0; i < n; i++) {
+      int idx = row_ptr[i];
+      while (idx < row_ptr[i + 1] && col_ind[idx] < i) {
+        idx++;
+      }
+      assert(idx < row_ptr[i + 1] && col_ind[idx] == i);
+      diag_ind_[i] = idx;
+    }
+
+    // row i of L depends on the rows of the columns left of the diagonal
+    std::vector<int> level(n);
+    int n_levels = 0;
+    for (int i = 0; i < n; i++) {
+      int l = 0;
+      for (int idx = row_ptr[i]; idx < diag_ind_[i]; idx++) {
+        l = std::max(l, level[col_ind[idx]] + 1);
+      }
+      level[i] = l;
+      n_levels = std::max(n_levels, l + 1);
+    }
+    l_levels_ = group_levels(level, n_levels);
+
+    // row i of U depends on the rows of the columns right of the diagonal
+    n_levels = 0;
+    for (int i = n - 1; i >= 0; i--) {
+      int l = 0;
+      for (int idx = diag_ind_[i] + 1; idx < row_ptr[i + 1]; idx++) {
+        l = std::max(l, level[col_ind[idx]] + 1);
+      }
+      level[i] = l;
+      n_levels = std::max(n_levels, l + 1);
+    }
+    u_levels_ = group_levels(level, n_levels);
+  }
+
+  gt::sparse::csr_matrix<T, space_type>& csr_mat_;
+  const T alpha_;
+  int nrhs_;
+  gt::gtensor<T, 2, space_type> rhs_tmp_;
+  std::vector<int> diag_ind_;
+  levels l_levels_;
+  levels u_levels_;
+  sparse_handle_t h_;
+};
+
+template <typename T>
+using csr_matrix_lu = csr_matrix_lu_host<T>;
+
+} // namespace solver
+
+} // namespace gt
+
+#endif
@@ -73,6 +73,10 @@ public:
     // destroy matrix handle??
   }
 
+  // the values of csr_mat were updated in place, same sparsity pattern; the
+  // matrix handle points to them, so there is nothing to redo
+  void update() {}
+
   void solve(T* rhs, T* result)
   {
     gt::copy_n(gt::device_pointer_cast(rhs), result_tmp_.size(),
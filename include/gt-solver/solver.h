@@ -1,6 +1,8 @@
 #ifndef GTENSOR_SOLVE_H
 #define GTENSOR_SOLVE_H
 
+#include <stdexcept>
+
 #include "gtensor/gtensor.h"
 #include "gtensor/sparse.h"
 
@@ -30,6 +32,9 @@
 
 #elif defined(GTENSOR_DEVICE_SYCL)
 #include "gt-solver/backend/sycl.h"
+
+#else
+#include "gt-solver/backend/host.h"
 #endif
 
 namespace gt
@@ -38,20 +43,74 @@ namespace gt
 namespace solver
 {
 
+namespace detail
+{
+
+// single precision counterpart of a double precision type
+template <typename T>
+struct lower_precision;
+
+template <>
+struct lower_precision<double>
+{
+  using type = float;
+};
+
+template <>
+struct lower_precision<gt::complex<double>>
+{
+  using type = gt::complex<float>;
+};
+
+} // namespace detail
+
 template <typename T>
 class solver
 {
 public:
   using value_type = T;
+  using span_type = gt::gtensor_span_device<T, 3>;
+  using const_span_type = gt::gtensor_span_device<const T, 3>;
 
+  // rhs and result are device arrays of n x nrhs x nbatches (for
+  // solver_sparse, n x nbatches x nrhs), with the nrhs of the constructor
   virtual void solve(T* rhs, T* result) = 0;
+
+  // rhs and result have shape n x nrhs x nbatches for every solver, for any
+  // nrhs up to the one of the constructor, and may be strided or overlap.
+  // std::invalid_argument is thrown for other shapes. The internal buffers
+  // are reused, so nothing is allocated, except by solver_invert when
+  // neither rhs nor result is contiguous, and by solver_sparse on first use
+  // (see there).
+  // Solvers that do not support it throw std::logic_error.
+  virtual void solve(const_span_type /* rhs */, span_type /* result */)
+  {
+    throw std::logic_error("gt::solver: span solve not supported");
+  }
+
+  // solve(rhs, rhs), but without copying rhs into an internal buffer where
+  // the solver can work on it directly (if it is contiguous)
+  virtual void solve_inplace(span_type rhs)
+  {
+    solve(const_span_type(rhs), rhs);
+  }
+
   virtual std::size_t get_device_memory_usage() = 0;
-};
 
-#ifdef GTENSOR_DEVICE_SYCL
+  // refactors for new values of matrices of the same size, reusing the
+  // buffers (and for the sparse solvers, the sparsity pattern and its
+  // analysis) set up by the constructor. For the sparse solvers, the LU
+  // factors must have the same sparsity pattern as before, otherwise
+  // std::runtime_error is thrown. Solvers that do not support it throw
+  // std::logic_error.
+  virtual void update_matrices(T* const* /* matrix_batches */)
+  {
+    throw std::logic_error("gt::solver: update_matrices not supported");
+  }
+};
 
-// use contiguous strided dense API for SYCL, it has been better
-// optimized
+// batches are stored contiguously and use the strided batched API, which
+// needs no device pointer arrays
 
 template <typename T>
 class solver_dense : public solver<T>
@@ -59,12 +118,17 @@ class solver_dense : public solver<T>
 public:
   using base_type = solver<T>;
   using typename base_type::value_type;
+  using typename base_type::span_type;
+  using typename base_type::const_span_type;
 
   solver_dense(gt::blas::handle_t& h, int n, int nbatches, int nrhs,
                T* const* matrix_batches);
 
   virtual void solve(T* rhs, T* result);
+  virtual void solve(const_span_type rhs, span_type result);
+  virtual void solve_inplace(span_type rhs);
   virtual std::size_t get_device_memory_usage();
+  virtual void update_matrices(T* const* matrix_batches);
 
 protected:
   gt::blas::handle_t& h_;
@@ -76,22 +140,29 @@ protected:
   gt::gtensor_device<T, 3> rhs_data_;
   gt::blas::index_t scratch_count_;
   gt::space::device_vector<T> scratch_;
-};
 
-#else // HIP and CUDA
+private:
+  // in place on contiguous n x nrhs x nbatches rhs
+  void getrs(T* rhs, int nrhs);
+};
 
 template <typename T>
-class solver_dense : public solver<T>
+class solver_invert : solver<T>
 {
 public:
   using base_type = solver<T>;
   using typename base_type::value_type;
+  using typename base_type::span_type;
+  using typename base_type::const_span_type;
 
-  solver_dense(gt::blas::handle_t& h, int n, int nbatches, int nrhs,
-               T* const* matrix_batches);
+  solver_invert(gt::blas::handle_t& h, int n, int nbatches, int nrhs,
+                T* const* matrix_batches);
 
   virtual void solve(T* rhs, T* result);
+  virtual void solve(const_span_type rhs, span_type result);
+  virtual void solve_inplace(span_type rhs);
   virtual std::size_t get_device_memory_usage();
+  virtual void update_matrices(T* const* matrix_batches);
 
 protected:
   gt::blas::handle_t& h_;
@@ -99,65 +170,168 @@ protected:
   int nbatches_;
   int nrhs_;
   gt::gtensor_device<T, 3> matrix_data_;
-  gt::gtensor_device<T*, 1> matrix_pointers_;
   gt::gtensor_device<gt::blas::index_t, 2> pivot_data_;
-  gt::gtensor_device<int, 1> info_;
   gt::gtensor_device<T, 3> rhs_data_;
-  gt::gtensor_device<T*, 1> rhs_pointers_;
+
+private:
+  // result = A^-1 rhs, for contiguous n x nrhs x nbatches rhs and result
+  void multiply(const T* rhs, T* result, int nrhs);
 };
 
-#endif
+// The matrices are LU factored without pivoting and joined into one block
+// diagonal sparse matrix. Its right hand sides are stored column after
+// column, so the pointer solve takes n x nbatches x nrhs arrays, unlike the
+// other solvers. The span solve takes n x nrhs x nbatches like everywhere
+// else, and rearranges through an n x nbatches x nrhs buffer unless nrhs is
+// 1 and rhs and result are contiguous. The buffer is allocated by the first
+// span solve that needs it and reused after that.
 
 template <typename T>
-class solver_invert : solver<T>
+class solver_sparse : public solver<T>
 {
 public:
   using base_type = solver<T>;
   using typename base_type::value_type;
+  using typename base_type::span_type;
+  using typename base_type::const_span_type;
 
-  solver_invert(gt::blas::handle_t& h, int n, int nbatches, int nrhs,
+  solver_sparse(gt::blas::handle_t& blas_h, int n, int nbatches, int nrhs,
                 T* const* matrix_batches);
 
   virtual void solve(T* rhs, T* result);
+  virtual void solve(const_span_type rhs, span_type result);
+  virtual void solve_inplace(span_type rhs);
   virtual std::size_t get_device_memory_usage();
+  virtual void update_matrices(T* const* matrix_batches);
 
 protected:
   gt::blas::handle_t& h_;
   int n_;
   int nbatches_;
   int nrhs_;
+  gt::sparse::csr_matrix<T, gt::space::device> csr_mat_;
+  csr_matrix_lu<T> csr_mat_lu_;
+  // n x nbatches x nrhs, for the span API, allocated on first use
+  gt::gtensor_device<T, 3> rhs_data_;
+
+private:
+  static gt::sparse::csr_matrix<T, gt::space::device> lu_factor_batches_to_csr(
+    gt::blas::handle_t& h, int n, int nbatches, T* const* matrix_batches);
+};
+
+// Mixed precision iterative refinement, for double precision T: the
+// matrices are LU factored in single precision, and the single precision
+// solution is refined with residuals computed in double precision, until
+// ||r|| <= tolerance * ||A|| * ||x|| (infinity norms) for every batch, like
+// LAPACK's dsgesv. The default tolerance is sqrt(n) * eps. Batches that do
+// not converge within max_iterations fall back to a double precision
+// factorization (made once, on first need, into separate storage): their
+// solution is replaced by the double precision one, and later solves stop
+// waiting for them to converge. Batches that are singular in single
+// precision fall back right away. Other batches keep using refinement, and
+// update_matrices() resets the fallback.
+
+template <typename T>
+class solver_mixed : public solver<T>
+{
+public:
+  using base_type = solver<T>;
+  using typename base_type::value_type;
+  using typename base_type::span_type;
+  using typename base_type::const_span_type;
+  using low_type = typename detail::lower_precision<T>::type;
+  using real_type = gt::complex_subtype_t<T>;
+
+  solver_mixed(gt::blas::handle_t& h, int n, int nbatches, int nrhs,
+               T* const* matrix_batches, int max_iterations = 10,
+               real_type tolerance = 0);
+
+  virtual void solve(T* rhs, T* result);
+  virtual void solve(const_span_type rhs, span_type result);
+  virtual void solve_inplace(span_type rhs);
+  virtual std::size_t get_device_memory_usage();
+  virtual void update_matrices(T* const* matrix_batches);
+
+  // refinement steps taken by the last solve, 0 if it did not refine
+  int get_iterations() const { return iterations_; }
+
+  // true if some batch failed to converge and uses the double precision
+  // factorization, or batch b specifically
+  bool is_fallback() const { return n_fallback_ > 0; }
+  bool is_fallback(int b) const { return h_fallback_batches_(b) != 0; }
+
+protected:
+  T* solve_packed(int nrhs);
+  real_type max_backward_error(int nrhs);
+  void update_fallback_batches();
+  void count_fallback_batches();
+  void factor_fallback();
+
+  gt::blas::handle_t& h_;
+  int n_;
+  int nbatches_;
+  int nrhs_;
+  int max_iterations_;
+  real_type tolerance_;
+  int iterations_;
+  int n_fallback_;
   gt::gtensor_device<T, 3> matrix_data_;
-  gt::gtensor_device<T*, 1> matrix_pointers_;
+  gt::gtensor_device<low_type, 3> lu_data_;
   gt::gtensor_device<gt::blas::index_t, 2> pivot_data_;
-  gt::gtensor_device<int, 1> info_;
   gt::gtensor_device<T, 3> rhs_data_;
-  gt::gtensor_device<T*, 1> rhs_pointers_;
-  gt::gtensor_device<T, 3> rhs_input_data_;
-  gt::gtensor_device<T*, 1> rhs_input_pointers_;
+  gt::gtensor_device<T, 3> x_data_;
+  gt::gtensor_device<T, 3> residual_data_;
+  gt::gtensor_device<low_type, 3> correction_data_;
+  gt::gtensor_device<real_type, 1> norm_data_;
+  gt::gtensor_device<real_type, 1> error_data_;
+  gt::gtensor_device<int, 1> fallback_batches_;
+  gt::gtensor<int, 1> h_fallback_batches_;
+  gt::blas::index_t scratch_count_;
+  gt::space::device_vector<low_type> scratch_;
+  // double precision factorization, empty until first needed
+  gt::gtensor_device<T, 3> fallback_lu_data_;
+  gt::gtensor_device<gt::blas::index_t, 2> fallback_pivot_data_;
+  gt::blas::index_t fallback_scratch_count_;
+  gt::space::device_vector<T> fallback_scratch_;
 };
 
+// LU factored without pivoting like solver_sparse, but the factors are kept
+// as a csr_matrix_batch instead of one block diagonal matrix, and every
+// batch and right hand side is solved independently. Right hand sides are
+// stored like for solver_dense, n x nrhs x nbatches.
+
 template <typename T>
-class solver_sparse : public solver<T>
+class solver_sparse_batch : public solver<T>
 {
 public:
   using base_type = solver<T>;
   using typename base_type::value_type;
+  using typename base_type::span_type;
+  using typename base_type::const_span_type;
 
-  solver_sparse(gt::blas::handle_t& blas_h, int n, int nbatches, int nrhs,
-                T* const* matrix_batches);
+  solver_sparse_batch(gt::blas::handle_t& h, int n, int nbatches, int nrhs,
+                      T* const* matrix_batches);
 
   virtual void solve(T* rhs, T* result);
+  virtual void solve(const_span_type rhs, span_type result);
+  virtual void solve_inplace(span_type rhs);
   virtual std::size_t get_device_memory_usage();
+  virtual void update_matrices(T* const* matrix_batches);
 
 protected:
+  gt::blas::handle_t& h_;
   int n_;
   int nbatches_;
   int nrhs_;
-  gt::sparse::csr_matrix<T, gt::space::device> csr_mat_;
-  csr_matrix_lu<T> csr_mat_lu_;
+  gt::sparse::csr_matrix_batch<T, gt::space::device> csr_mat_;
+  gt::gtensor_device<int, 1> diag_ind_;
+  gt::gtensor_device<T, 3> rhs_data_;
 
 private:
-  static gt::sparse::csr_matrix<T, gt::space::device> lu_factor_batches_to_csr(
+  // in place on contiguous n x nrhs x nbatches rhs
+  void solve_contiguous(T* rhs, int nrhs);
+
+  static gt::sparse::csr_matrix_batch<T, gt::space::device> lu_factor_batches(
     gt::blas::handle_t& h, int n, int nbatches, T* const* matrix_batches);
 };
 
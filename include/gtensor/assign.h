@@ -3,9 +3,13 @@
 #define GTENSOR_ASSIGN_H
 
 #include <type_traits>
+#include <utility>
 
+#include "cursor.h"
 #include "defs.h"
+#include "meta.h"
 #include "space.h"
+#include "write_tracking.h"
 
 namespace gt
 {
@@ -26,110 +30,55 @@ struct assigner
   static_assert(!std::is_same<SP, SP>::value, "assigner not implemented.");
 };
 
-template <>
-struct assigner<1, space::host>
-{
-  template <typename E1, typename E2>
-  static void run(E1& lhs, const E2& rhs, stream_view stream)
-  {
-    // printf("assigner<1, host>\n");
-    for (int i = 0; i < lhs.shape(0); i++) {
-      lhs(i) = rhs(i);
-    }
-  }
-};
+// host assignment walks lhs and rhs with cursors (see cursor.h), so the
+// innermost loop only bumps pointers / offsets rather than recomputing the
+// full strided index for every element
 
-template <>
-struct assigner<2, space::host>
+template <size_type D>
+struct assign_cursor_loop
 {
-  template <typename E1, typename E2>
-  static void run(E1& lhs, const E2& rhs, stream_view stream)
+  template <typename S, typename C1, typename C2>
+  static void run(const S& shape, C1 lhs, C2 rhs)
   {
-    // printf("assigner<2, host>\n");
-    for (int j = 0; j < lhs.shape(1); j++) {
-      for (int i = 0; i < lhs.shape(0); i++) {
-        lhs(i, j) = rhs(i, j);
-      }
+    for (index_t i = 0; i < shape[D]; i++) {
+      assign_cursor_loop<D - 1>::run(shape, lhs, rhs);
+      lhs.step(D);
+      rhs.step(D);
     }
   }
 };
 
 template <>
-struct assigner<3, space::host>
+struct assign_cursor_loop<0>
 {
-  template <typename E1, typename E2>
-  static void run(E1& lhs, const E2& rhs, stream_view stream)
+  template <typename S, typename C1, typename C2>
+  static void run(const S& shape, C1 lhs, C2 rhs)
   {
-    // printf("assigner<3, host>\n");
-    for (int k = 0; k < lhs.shape(2); k++) {
-      for (int j = 0; j < lhs.shape(1); j++) {
-        for (int i = 0; i < lhs.shape(0); i++) {
-          lhs(i, j, k) = rhs(i, j, k);
-        }
-      }
+    for (index_t i = 0; i < shape[0]; i++) {
+      lhs[i] = rhs[i];
     }
   }
 };
 
-template <>
-struct assigner<4, space::host>
-{
-  template <typename E1, typename E2>
-  static void run(E1& lhs, const E2& rhs, stream_view stream)
-  {
-    // printf("assigner<4, host>\n");
-    for (int l = 0; l < lhs.shape(3); l++) {
-      for (int k = 0; k < lhs.shape(2); k++) {
-        for (int j = 0; j < lhs.shape(1); j++) {
-          for (int i = 0; i < lhs.shape(0); i++) {
-            lhs(i, j, k, l) = rhs(i, j, k, l);
-          }
-        }
-      }
-    }
-  }
-};
-
-template <>
-struct assigner<5, space::host>
-{
-  template <typename E1, typename E2>
-  static void run(E1& lhs, const E2& rhs, stream_view stream)
-  {
-    // printf("assigner<5, host>\n");
-    for (int m = 0; m < lhs.shape(4); m++) {
-      for (int l = 0; l < lhs.shape(3); l++) {
-        for (int k = 0; k < lhs.shape(2); k++) {
-          for (int j = 0; j < lhs.shape(1); j++) {
-            for (int i = 0; i < lhs.shape(0); i++) {
-              lhs(i, j, k, l, m) = rhs(i, j, k, l, m);
-            }
-          }
-        }
-      }
-    }
-  }
-};
-
-template <>
-struct assigner<6, space::host>
+template <size_type N>
+struct assigner<N, space::host>
 {
   template <typename E1, typename E2>
   static void run(E1& lhs, const E2& rhs, stream_view stream)
   {
-    // printf("assigner<6, host>\n");
-    for (int n = 0; n < lhs.shape(5); n++) {
-      for (int m = 0; m < lhs.shape(4); m++) {
-        for (int l = 0; l < lhs.shape(3); l++) {
-          for (int k = 0; k < lhs.shape(2); k++) {
-            for (int j = 0; j < lhs.shape(1); j++) {
-              for (int i = 0; i < lhs.shape(0); i++) {
-                lhs(i, j, k, l, m, n) = rhs(i, j, k, l, m, n);
-              }
-            }
-          }
-        }
-      }
+    // printf("assigner<%d, host>\n", int(N));
+    if (stream.is_default()) {
+      assign_cursor_loop<N - 1>::run(lhs.shape(), gt::cursor(lhs),
+                                     gt::cursor(rhs));
+    } else {
+      // queued work may run after the expressions went out of scope, so
+      // capture the kernel views rather than the expressions themselves
+      auto k_lhs = lhs.to_kernel();
+      auto k_rhs = rhs.to_kernel();
+      gt::backend::host::enqueue(stream, [k_lhs, k_rhs]() mutable {
+        assign_cursor_loop<N - 1>::run(k_lhs.shape(), gt::cursor(k_lhs),
+                                       gt::cursor(k_rhs));
+      });
     }
   }
 };
@@ -343,12 +292,13 @@ struct assigner<6, space::device>
 
 #else // not defined GTENSOR_PER_DIM_KERNELS
 
-template <typename Elhs, typename Erhs, size_type N>
-__global__ void kernel_assign_N(Elhs lhs, Erhs rhs, size_type size,
-                                gt::shape_type<N> strides)
+template <typename Elhs, typename Erhs, size_type N, typename I>
+__global__ void kernel_assign_N(Elhs lhs, Erhs rhs, I size,
+                                gt::sarray<I, N> strides)
 {
   // workaround ROCm 5.2.0 compiler bug
-  size_type i = threadIdx.x + static_cast<size_type>(blockIdx.x) * blockDim.x;
+  I i = static_cast<I>(threadIdx.x) +
+        static_cast<I>(blockIdx.x) * static_cast<I>(blockDim.x);
 
   if (i < size) {
     auto idx = unravel(i, strides);
@@ -363,7 +313,6 @@ struct assigner<N, space::device>
   static void run(E1& lhs, const E2& rhs, stream_view stream)
   {
     auto size = calc_size(lhs.shape());
-    auto strides = calc_strides(lhs.shape());
     unsigned int block_size = BS_LINEAR;
     if (block_size > size) {
       block_size = static_cast<unsigned int>(size);
@@ -373,9 +322,19 @@ struct assigner<N, space::device>
     dim3 numBlocks(gt::div_ceil(size, block_size));
 
     gpuSyncIfEnabledStream(stream);
-    gtLaunchKernel(kernel_assign_N, numBlocks, numThreads, 0,
-                   stream.get_backend_stream(), lhs.to_kernel(),
-                   rhs.to_kernel(), size, strides);
+    if (fits_index_32(size, block_size)) {
+      sarray<int, N> strides = calc_strides(sarray<int, N>(lhs.shape()));
+      gtLaunchKernel(kernel_assign_N, numBlocks, numThreads, 0,
+                     stream.get_backend_stream(), lhs.to_kernel(),
+                     rhs.to_kernel(), static_cast<int>(size), strides);
+    } else {
+      sarray<std::int64_t, N> strides =
+        calc_strides(sarray<std::int64_t, N>(lhs.shape()));
+      gtLaunchKernel(kernel_assign_N, numBlocks, numThreads, 0,
+                     stream.get_backend_stream(), lhs.to_kernel(),
+                     rhs.to_kernel(), static_cast<std::int64_t>(size),
+                     strides);
+    }
     gpuSyncIfEnabledStream(stream);
   }
 };
@@ -535,20 +494,25 @@ void assign(E1& lhs, const E2& rhs, gt::stream_view stream = gt::stream_view())
   static_assert(expr_dimension<E1>() == expr_dimension<E2>(),
                 "cannot assign expressions of different dimension");
   detail::valid_assign_broadcast_or_throw(lhs.shape(), rhs.shape());
+  detail::wait_write(rhs, stream);
+  detail::wait_write(lhs, stream);
   detail::assigner<
     expr_dimension<E1>(),
     space_t<expr_space_type<E1>, expr_space_type<E2>>>::run(lhs, rhs, stream);
+  detail::record_write(lhs, stream);
 }
 
 template <typename E1, typename T>
 void assign(E1& lhs, const gscalar<T>& val,
             gt::stream_view stream = gt::stream_view())
 {
+  detail::wait_write(lhs, stream);
   // FIXME, make more efficient
   detail::assigner<
     expr_dimension<E1>(),
     space_t<expr_space_type<E1>, expr_space_type<gscalar<T>>>>::run(lhs, val,
                                                                     stream);
+  detail::record_write(lhs, stream);
 }
 
 } // namespace gt
@@ -23,6 +23,28 @@
 namespace gt
 {
 
+// relative priority of a stream; backends without stream priorities treat all
+// streams the same
+enum class stream_priority
+{
+  low,
+  normal,
+  high,
+};
+
+// hints for managed memory, see gt::advise(); backends or memory types they
+// do not apply to ignore them
+enum class memory_advice
+{
+  read_mostly,
+  unset_read_mostly,
+  preferred_location_device,
+  preferred_location_host,
+  unset_preferred_location,
+  accessed_by_device,
+  unset_accessed_by_device,
+};
+
 namespace backend
 {
 
@@ -109,6 +131,13 @@ Stream create();
 template <typename Stream>
 void destroy(Stream s);
 
+// backends without stream priorities create a regular stream
+template <typename Stream>
+Stream create(gt::stream_priority /* priority */)
+{
+  return create<Stream>();
+}
+
 /**
  * CRTP static interface for backend specific stream wrapper, non owning view.
  *
@@ -127,6 +156,14 @@ public:
 
   stream_t& get_backend_stream() { return stream_; }
 
+  // make work submitted to this stream from now on wait for the event, without
+  // blocking the host
+  template <typename Event>
+  void wait(const Event& event)
+  {
+    event.stream_wait(stream_);
+  }
+
 protected:
   Stream stream_;
 };
@@ -152,6 +189,9 @@ public:
   using view_t = View;
 
   stream_base() : view_(gt::backend::stream_interface::create<stream_t>()) {}
+  explicit stream_base(gt::stream_priority priority)
+    : view_(gt::backend::stream_interface::create<stream_t>(priority))
+  {}
   ~stream_base() { sync_and_destroy(view_.get_backend_stream()); }
 
   // copy not allowed
@@ -169,6 +209,8 @@ public:
     view_ = other.view_;
     other.moved_from_ = true;
     sync_and_destroy(old_stream);
+    moved_from_ = false;
+    return *this;
   }
 
   view_t& get_view() { return view_; }
@@ -177,10 +219,18 @@ public:
 
   bool is_default() { return view_.is_default(); }
 
+  bool query() { return view_.query(); }
+
   void synchronize() { view_.synchronize(); }
 
+  template <typename Event>
+  void wait(const Event& event)
+  {
+    view_.wait(event);
+  }
+
 protected:
-  bool moved_from_;
+  bool moved_from_ = false;
   view_t view_;
 
   void sync_and_destroy(stream_t s)
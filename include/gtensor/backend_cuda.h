@@ -4,6 +4,8 @@
 
 #include "backend_common.h"
 
+#include <utility>
+
 #include <cuda_runtime_api.h>
 
 //#include "thrust/cuda/system/execution_policy.h"
@@ -129,6 +131,121 @@ inline void copy_n(gt::space::host tag_in, gt::space::host tag_out, InputPtr in,
 }
 #endif
 
+template <typename InputPtr, typename OutputPtr>
+inline void copy_n_async(gt::space::cuda tag_in, gt::space::cuda tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         cudaStream_t stream)
+{
+  gtGpuCheck(cudaMemcpyAsync(
+    gt::raw_pointer_cast(out), gt::raw_pointer_cast(in),
+    sizeof(typename gt::pointer_traits<InputPtr>::element_type) * count,
+    cudaMemcpyDeviceToDevice, stream));
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_n_async(gt::space::cuda tag_in, gt::space::host tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         cudaStream_t stream)
+{
+  gtGpuCheck(cudaMemcpyAsync(
+    gt::raw_pointer_cast(out), gt::raw_pointer_cast(in),
+    sizeof(typename gt::pointer_traits<InputPtr>::element_type) * count,
+    cudaMemcpyDeviceToHost, stream));
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_n_async(gt::space::host tag_in, gt::space::cuda tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         cudaStream_t stream)
+{
+  gtGpuCheck(cudaMemcpyAsync(
+    gt::raw_pointer_cast(out), gt::raw_pointer_cast(in),
+    sizeof(typename gt::pointer_traits<InputPtr>::element_type) * count,
+    cudaMemcpyHostToDevice, stream));
+}
+
+// pitched copies, pitches and width are in elements
+
+template <typename InputPtr, typename OutputPtr>
+inline void cuda_copy_2d(InputPtr in, size_type in_pitch, OutputPtr out,
+                         size_type out_pitch, size_type width,
+                         size_type height, cudaMemcpyKind kind)
+{
+  using T = typename gt::pointer_traits<InputPtr>::element_type;
+  gtGpuCheck(cudaMemcpy2D(gt::raw_pointer_cast(out), sizeof(T) * out_pitch,
+                          gt::raw_pointer_cast(in), sizeof(T) * in_pitch,
+                          sizeof(T) * width, height, kind));
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void cuda_copy_2d_async(InputPtr in, size_type in_pitch, OutputPtr out,
+                               size_type out_pitch, size_type width,
+                               size_type height, cudaMemcpyKind kind,
+                               cudaStream_t stream)
+{
+  using T = typename gt::pointer_traits<InputPtr>::element_type;
+  gtGpuCheck(cudaMemcpy2DAsync(gt::raw_pointer_cast(out), sizeof(T) * out_pitch,
+                               gt::raw_pointer_cast(in), sizeof(T) * in_pitch,
+                               sizeof(T) * width, height, kind, stream));
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::cuda tag_in, gt::space::cuda tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  cuda_copy_2d(in, in_pitch, out, out_pitch, width, height,
+               cudaMemcpyDeviceToDevice);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::cuda tag_in, gt::space::host tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  cuda_copy_2d(in, in_pitch, out, out_pitch, width, height,
+               cudaMemcpyDeviceToHost);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::host tag_in, gt::space::cuda tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  cuda_copy_2d(in, in_pitch, out, out_pitch, width, height,
+               cudaMemcpyHostToDevice);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d_async(gt::space::cuda tag_in, gt::space::cuda tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, cudaStream_t stream)
+{
+  cuda_copy_2d_async(in, in_pitch, out, out_pitch, width, height,
+                     cudaMemcpyDeviceToDevice, stream);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d_async(gt::space::cuda tag_in, gt::space::host tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, cudaStream_t stream)
+{
+  cuda_copy_2d_async(in, in_pitch, out, out_pitch, width, height,
+                     cudaMemcpyDeviceToHost, stream);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d_async(gt::space::host tag_in, gt::space::cuda tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, cudaStream_t stream)
+{
+  cuda_copy_2d_async(in, in_pitch, out, out_pitch, width, height,
+                     cudaMemcpyHostToDevice, stream);
+}
+
 } // namespace copy_impl
 
 namespace fill_impl
@@ -255,8 +372,214 @@ public:
 
     void synchronize() { gtGpuCheck(cudaStreamSynchronize(this->stream_)); }
 
+    // true if all work submitted to the stream has completed
+    bool query()
+    {
+      auto rc = cudaStreamQuery(this->stream_);
+      if (rc == cudaErrorNotReady) {
+        return false;
+      }
+      gtGpuCheck(rc);
+      return true;
+    }
+
     auto get_execution_policy() { return thrust::cuda::par.on(this->stream_); }
   };
+
+  class event
+  {
+  public:
+    explicit event(bool enable_timing = false)
+    {
+      gtGpuCheck(cudaEventCreateWithFlags(
+        &event_, enable_timing ? cudaEventDefault : cudaEventDisableTiming));
+    }
+
+    ~event()
+    {
+      if (event_ != nullptr) {
+        gtGpuCheck(cudaEventDestroy(event_));
+      }
+    }
+
+    // copy not allowed
+    event(const event& other) = delete;
+    event& operator=(const event& other) = delete;
+
+    event(event&& other) : event_(other.event_) { other.event_ = nullptr; }
+
+    event& operator=(event&& other)
+    {
+      std::swap(event_, other.event_);
+      return *this;
+    }
+
+    void record(stream_view stream)
+    {
+      gtGpuCheck(cudaEventRecord(event_, stream.get_backend_stream()));
+    }
+
+    void synchronize() { gtGpuCheck(cudaEventSynchronize(event_)); }
+
+    bool query()
+    {
+      auto rc = cudaEventQuery(event_);
+      if (rc == cudaErrorNotReady) {
+        return false;
+      }
+      gtGpuCheck(rc);
+      return true;
+    }
+
+    // make work submitted to `stream` after this call wait for the event
+    void stream_wait(cudaStream_t stream) const
+    {
+      gtGpuCheck(cudaStreamWaitEvent(stream, event_, 0));
+    }
+
+    // milliseconds between start and stop, both created with timing enabled
+    static float elapsed_time(const event& start, const event& stop)
+    {
+      float ms;
+      gtGpuCheck(cudaEventElapsedTime(&ms, start.event_, stop.event_));
+      return ms;
+    }
+
+    cudaEvent_t get_backend_event() { return event_; }
+
+  private:
+    cudaEvent_t event_;
+  };
+
+  // captures the work submitted to a stream into a cuda graph, which can be
+  // replayed on any stream. Capture is thread local, so operations that are
+  // not allowed while capturing (allocations, synchronization) fail rather
+  // than being silently left out of the graph.
+  class graph
+  {
+  public:
+    graph() : graph_(nullptr), exec_(nullptr) {}
+
+    ~graph() { destroy(); }
+
+    // copy not allowed
+    graph(const graph& other) = delete;
+    graph& operator=(const graph& other) = delete;
+
+    graph(graph&& other) : graph_(other.graph_), exec_(other.exec_)
+    {
+      other.graph_ = nullptr;
+      other.exec_ = nullptr;
+    }
+
+    graph& operator=(graph&& other)
+    {
+      std::swap(graph_, other.graph_);
+      std::swap(exec_, other.exec_);
+      return *this;
+    }
+
+    void begin_capture(stream_view stream)
+    {
+      gtGpuCheck(cudaStreamBeginCapture(stream.get_backend_stream(),
+                                       cudaStreamCaptureModeThreadLocal));
+    }
+
+    void end_capture(stream_view stream)
+    {
+      destroy();
+      gtGpuCheck(cudaStreamEndCapture(stream.get_backend_stream(), &graph_));
+      gtGpuCheck(cudaGraphInstantiateWithFlags(&exec_, graph_, 0));
+    }
+
+    void launch(stream_view stream)
+    {
+      gtGpuCheck(cudaGraphLaunch(exec_, stream.get_backend_stream()));
+    }
+
+  private:
+    void destroy()
+    {
+      if (exec_ != nullptr) {
+        gtGpuCheck(cudaGraphExecDestroy(exec_));
+        exec_ = nullptr;
+      }
+      if (graph_ != nullptr) {
+        gtGpuCheck(cudaGraphDestroy(graph_));
+        graph_ = nullptr;
+      }
+    }
+
+    cudaGraph_t graph_;
+    cudaGraphExec_t exec_;
+  };
+
+  // stream prefetches and advice only apply to managed memory, other
+  // pointers are left alone instead of failing in the runtime
+  template <typename T>
+  static bool is_managed(T* p, size_type n)
+  {
+    return n > 0 && get_memory_type(p) == memory_type::managed;
+  }
+
+  template <typename T>
+  static void prefetch_device(T* p, size_type n, stream_view stream)
+  {
+    if (!is_managed(p, n)) {
+      return;
+    }
+    int device_id;
+    gtGpuCheck(cudaGetDevice(&device_id));
+    gtGpuCheck(cudaMemPrefetchAsync(p, n * sizeof(T), device_id,
+                                   stream.get_backend_stream()));
+  }
+
+  template <typename T>
+  static void prefetch_host(T* p, size_type n, stream_view stream)
+  {
+    if (!is_managed(p, n)) {
+      return;
+    }
+    gtGpuCheck(cudaMemPrefetchAsync(p, n * sizeof(T), cudaCpuDeviceId,
+                                   stream.get_backend_stream()));
+  }
+
+  template <typename T>
+  static void advise(T* p, size_type n, gt::memory_advice advice)
+  {
+    if (!is_managed(p, n)) {
+      return;
+    }
+    int device_id;
+    gtGpuCheck(cudaGetDevice(&device_id));
+    cudaMemoryAdvise a;
+    switch (advice) {
+      case gt::memory_advice::read_mostly:
+        a = cudaMemAdviseSetReadMostly;
+        break;
+      case gt::memory_advice::unset_read_mostly:
+        a = cudaMemAdviseUnsetReadMostly;
+        break;
+      case gt::memory_advice::preferred_location_device:
+        a = cudaMemAdviseSetPreferredLocation;
+        break;
+      case gt::memory_advice::preferred_location_host:
+        a = cudaMemAdviseSetPreferredLocation;
+        device_id = cudaCpuDeviceId;
+        break;
+      case gt::memory_advice::unset_preferred_location:
+        a = cudaMemAdviseUnsetPreferredLocation;
+        break;
+      case gt::memory_advice::accessed_by_device:
+        a = cudaMemAdviseSetAccessedBy;
+        break;
+      case gt::memory_advice::unset_accessed_by_device:
+        a = cudaMemAdviseUnsetAccessedBy;
+        break;
+      default: return;
+    }
+    gtGpuCheck(cudaMemAdvise(p, n * sizeof(T), a, device_id));
+  }
 };
 
 namespace stream_interface
@@ -270,6 +593,23 @@ inline cudaStream_t create<cudaStream_t>()
   return s;
 }
 
+template <>
+inline cudaStream_t create<cudaStream_t>(gt::stream_priority priority)
+{
+  // numerically lower values are higher priorities
+  int least, greatest;
+  gtGpuCheck(cudaDeviceGetStreamPriorityRange(&least, &greatest));
+  int p = 0;
+  if (priority == gt::stream_priority::high) {
+    p = greatest;
+  } else if (priority == gt::stream_priority::low) {
+    p = least;
+  }
+  cudaStream_t s;
+  gtGpuCheck(cudaStreamCreateWithPriority(&s, cudaStreamDefault, p));
+  return s;
+}
+
 template <>
 inline void destroy<cudaStream_t>(cudaStream_t s)
 {
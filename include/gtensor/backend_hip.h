@@ -4,6 +4,8 @@
 
 #include "backend_common.h"
 
+#include <utility>
+
 #include <hip/hip_runtime.h>
 
 #include <thrust/system/hip/execution_policy.h>
@@ -142,6 +144,121 @@ inline void copy_n(gt::space::host tag_in, gt::space::host tag_out, InputPtr in,
 }
 #endif
 
+template <typename InputPtr, typename OutputPtr>
+inline void copy_n_async(gt::space::hip tag_in, gt::space::hip tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         hipStream_t stream)
+{
+  gtGpuCheck(hipMemcpyAsync(
+    gt::raw_pointer_cast(out), gt::raw_pointer_cast(in),
+    sizeof(typename gt::pointer_traits<InputPtr>::element_type) * count,
+    hipMemcpyDeviceToDevice, stream));
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_n_async(gt::space::hip tag_in, gt::space::host tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         hipStream_t stream)
+{
+  gtGpuCheck(hipMemcpyAsync(
+    gt::raw_pointer_cast(out), gt::raw_pointer_cast(in),
+    sizeof(typename gt::pointer_traits<InputPtr>::element_type) * count,
+    hipMemcpyDeviceToHost, stream));
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_n_async(gt::space::host tag_in, gt::space::hip tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         hipStream_t stream)
+{
+  gtGpuCheck(hipMemcpyAsync(
+    gt::raw_pointer_cast(out), gt::raw_pointer_cast(in),
+    sizeof(typename gt::pointer_traits<InputPtr>::element_type) * count,
+    hipMemcpyHostToDevice, stream));
+}
+
+// pitched copies, pitches and width are in elements
+
+template <typename InputPtr, typename OutputPtr>
+inline void hip_copy_2d(InputPtr in, size_type in_pitch, OutputPtr out,
+                        size_type out_pitch, size_type width, size_type height,
+                        hipMemcpyKind kind)
+{
+  using T = typename gt::pointer_traits<InputPtr>::element_type;
+  gtGpuCheck(hipMemcpy2D(gt::raw_pointer_cast(out), sizeof(T) * out_pitch,
+                         gt::raw_pointer_cast(in), sizeof(T) * in_pitch,
+                         sizeof(T) * width, height, kind));
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void hip_copy_2d_async(InputPtr in, size_type in_pitch, OutputPtr out,
+                              size_type out_pitch, size_type width,
+                              size_type height, hipMemcpyKind kind,
+                              hipStream_t stream)
+{
+  using T = typename gt::pointer_traits<InputPtr>::element_type;
+  gtGpuCheck(hipMemcpy2DAsync(gt::raw_pointer_cast(out), sizeof(T) * out_pitch,
+                              gt::raw_pointer_cast(in), sizeof(T) * in_pitch,
+                              sizeof(T) * width, height, kind, stream));
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::hip tag_in, gt::space::hip tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  hip_copy_2d(in, in_pitch, out, out_pitch, width, height,
+              hipMemcpyDeviceToDevice);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::hip tag_in, gt::space::host tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  hip_copy_2d(in, in_pitch, out, out_pitch, width, height,
+              hipMemcpyDeviceToHost);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::host tag_in, gt::space::hip tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  hip_copy_2d(in, in_pitch, out, out_pitch, width, height,
+              hipMemcpyHostToDevice);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d_async(gt::space::hip tag_in, gt::space::hip tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, hipStream_t stream)
+{
+  hip_copy_2d_async(in, in_pitch, out, out_pitch, width, height,
+                    hipMemcpyDeviceToDevice, stream);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d_async(gt::space::hip tag_in, gt::space::host tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, hipStream_t stream)
+{
+  hip_copy_2d_async(in, in_pitch, out, out_pitch, width, height,
+                    hipMemcpyDeviceToHost, stream);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d_async(gt::space::host tag_in, gt::space::hip tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, hipStream_t stream)
+{
+  hip_copy_2d_async(in, in_pitch, out, out_pitch, width, height,
+                    hipMemcpyHostToDevice, stream);
+}
+
 } // namespace copy_impl
 
 namespace fill_impl
@@ -265,8 +382,214 @@ public:
 
     void synchronize() { gtGpuCheck(hipStreamSynchronize(this->stream_)); }
 
+    // true if all work submitted to the stream has completed
+    bool query()
+    {
+      auto rc = hipStreamQuery(this->stream_);
+      if (rc == hipErrorNotReady) {
+        return false;
+      }
+      gtGpuCheck(rc);
+      return true;
+    }
+
     auto get_execution_policy() { return thrust::hip::par.on(this->stream_); }
   };
+
+  class event
+  {
+  public:
+    explicit event(bool enable_timing = false)
+    {
+      gtGpuCheck(hipEventCreateWithFlags(
+        &event_, enable_timing ? hipEventDefault : hipEventDisableTiming));
+    }
+
+    ~event()
+    {
+      if (event_ != nullptr) {
+        gtGpuCheck(hipEventDestroy(event_));
+      }
+    }
+
+    // copy not allowed
+    event(const event& other) = delete;
+    event& operator=(const event& other) = delete;
+
+    event(event&& other) : event_(other.event_) { other.event_ = nullptr; }
+
+    event& operator=(event&& other)
+    {
+      std::swap(event_, other.event_);
+      return *this;
+    }
+
+    void record(stream_view stream)
+    {
+      gtGpuCheck(hipEventRecord(event_, stream.get_backend_stream()));
+    }
+
+    void synchronize() { gtGpuCheck(hipEventSynchronize(event_)); }
+
+    bool query()
+    {
+      auto rc = hipEventQuery(event_);
+      if (rc == hipErrorNotReady) {
+        return false;
+      }
+      gtGpuCheck(rc);
+      return true;
+    }
+
+    // make work submitted to `stream` after this call wait for the event
+    void stream_wait(hipStream_t stream) const
+    {
+      gtGpuCheck(hipStreamWaitEvent(stream, event_, 0));
+    }
+
+    // milliseconds between start and stop, both created with timing enabled
+    static float elapsed_time(const event& start, const event& stop)
+    {
+      float ms;
+      gtGpuCheck(hipEventElapsedTime(&ms, start.event_, stop.event_));
+      return ms;
+    }
+
+    hipEvent_t get_backend_event() { return event_; }
+
+  private:
+    hipEvent_t event_;
+  };
+
+  // captures the work submitted to a stream into a hip graph, which can be
+  // replayed on any stream. Capture is thread local, so operations that are
+  // not allowed while capturing (allocations, synchronization) fail rather
+  // than being silently left out of the graph.
+  class graph
+  {
+  public:
+    graph() : graph_(nullptr), exec_(nullptr) {}
+
+    ~graph() { destroy(); }
+
+    // copy not allowed
+    graph(const graph& other) = delete;
+    graph& operator=(const graph& other) = delete;
+
+    graph(graph&& other) : graph_(other.graph_), exec_(other.exec_)
+    {
+      other.graph_ = nullptr;
+      other.exec_ = nullptr;
+    }
+
+    graph& operator=(graph&& other)
+    {
+      std::swap(graph_, other.graph_);
+      std::swap(exec_, other.exec_);
+      return *this;
+    }
+
+    void begin_capture(stream_view stream)
+    {
+      gtGpuCheck(hipStreamBeginCapture(stream.get_backend_stream(),
+                                       hipStreamCaptureModeThreadLocal));
+    }
+
+    void end_capture(stream_view stream)
+    {
+      destroy();
+      gtGpuCheck(hipStreamEndCapture(stream.get_backend_stream(), &graph_));
+      gtGpuCheck(hipGraphInstantiate(&exec_, graph_, nullptr, nullptr, 0));
+    }
+
+    void launch(stream_view stream)
+    {
+      gtGpuCheck(hipGraphLaunch(exec_, stream.get_backend_stream()));
+    }
+
+  private:
+    void destroy()
+    {
+      if (exec_ != nullptr) {
+        gtGpuCheck(hipGraphExecDestroy(exec_));
+        exec_ = nullptr;
+      }
+      if (graph_ != nullptr) {
+        gtGpuCheck(hipGraphDestroy(graph_));
+        graph_ = nullptr;
+      }
+    }
+
+    hipGraph_t graph_;
+    hipGraphExec_t exec_;
+  };
+
+  // stream prefetches and advice only apply to managed memory, other
+  // pointers are left alone instead of failing in the runtime
+  template <typename T>
+  static bool is_managed(T* p, size_type n)
+  {
+    return n > 0 && get_memory_type(p) == memory_type::managed;
+  }
+
+  template <typename T>
+  static void prefetch_device(T* p, size_type n, stream_view stream)
+  {
+    if (!is_managed(p, n)) {
+      return;
+    }
+    int device_id;
+    gtGpuCheck(hipGetDevice(&device_id));
+    gtGpuCheck(hipMemPrefetchAsync(p, n * sizeof(T), device_id,
+                                   stream.get_backend_stream()));
+  }
+
+  template <typename T>
+  static void prefetch_host(T* p, size_type n, stream_view stream)
+  {
+    if (!is_managed(p, n)) {
+      return;
+    }
+    gtGpuCheck(hipMemPrefetchAsync(p, n * sizeof(T), hipCpuDeviceId,
+                                   stream.get_backend_stream()));
+  }
+
+  template <typename T>
+  static void advise(T* p, size_type n, gt::memory_advice advice)
+  {
+    if (!is_managed(p, n)) {
+      return;
+    }
+    int device_id;
+    gtGpuCheck(hipGetDevice(&device_id));
+    hipMemoryAdvise a;
+    switch (advice) {
+      case gt::memory_advice::read_mostly:
+        a = hipMemAdviseSetReadMostly;
+        break;
+      case gt::memory_advice::unset_read_mostly:
+        a = hipMemAdviseUnsetReadMostly;
+        break;
+      case gt::memory_advice::preferred_location_device:
+        a = hipMemAdviseSetPreferredLocation;
+        break;
+      case gt::memory_advice::preferred_location_host:
+        a = hipMemAdviseSetPreferredLocation;
+        device_id = hipCpuDeviceId;
+        break;
+      case gt::memory_advice::unset_preferred_location:
+        a = hipMemAdviseUnsetPreferredLocation;
+        break;
+      case gt::memory_advice::accessed_by_device:
+        a = hipMemAdviseSetAccessedBy;
+        break;
+      case gt::memory_advice::unset_accessed_by_device:
+        a = hipMemAdviseUnsetAccessedBy;
+        break;
+      default: return;
+    }
+    gtGpuCheck(hipMemAdvise(p, n * sizeof(T), a, device_id));
+  }
 };
 
 namespace stream_interface
@@ -280,6 +603,23 @@ inline hipStream_t create<hipStream_t>()
   return s;
 }
 
+template <>
+inline hipStream_t create<hipStream_t>(gt::stream_priority priority)
+{
+  // numerically lower values are higher priorities
+  int least, greatest;
+  gtGpuCheck(hipDeviceGetStreamPriorityRange(&least, &greatest));
+  int p = 0;
+  if (priority == gt::stream_priority::high) {
+    p = greatest;
+  } else if (priority == gt::stream_priority::low) {
+    p = least;
+  }
+  hipStream_t s;
+  gtGpuCheck(hipStreamCreateWithPriority(&s, hipStreamDefault, p));
+  return s;
+}
+
 template <>
 inline void destroy<hipStream_t>(hipStream_t s)
 {
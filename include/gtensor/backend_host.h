@@ -5,6 +5,25 @@
 #include "backend_common.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define GTENSOR_HAVE_POSIX_MADVISE
+#endif
 
 // ======================================================================
 // gt::backend::host
@@ -14,42 +33,383 @@ namespace gt
 namespace backend
 {
 
+namespace host
+{
+
+// ======================================================================
+// stream_queue
+//
+// in-order queue of work executed by a dedicated worker thread, the host
+// equivalent of a device stream. Work submitted to the default stream
+// (nullptr) runs inline instead. While capturing, submitted work is recorded
+// for later replay (see graph below) rather than queued, so synchronizing
+// the queue or waiting on an event recorded in it throws std::logic_error
+// until the capture ends, as in CUDA stream capture. An exception thrown by
+// queued work is kept and rethrown by the next synchronize(), like it would
+// be thrown directly for the default stream; only the first one is kept
+// until then.
+
+class stream_queue;
+
+inline std::mutex& stream_queues_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+inline std::unordered_set<stream_queue*>& stream_queues()
+{
+  static std::unordered_set<stream_queue*> queues;
+  return queues;
+}
+
+class stream_queue
+{
+public:
+  stream_queue()
+    : busy_(false),
+      stop_(false),
+      capturing_(false),
+      worker_([this] { run(); })
+  {
+    std::lock_guard<std::mutex> lock(stream_queues_mutex());
+    stream_queues().insert(this);
+  }
+
+  ~stream_queue()
+  {
+    {
+      // wait for synchronize_all() to let go of this queue
+      std::unique_lock<std::mutex> lock(stream_queues_mutex());
+      stream_queues().erase(this);
+      pinned_cv().wait(lock, [this] { return pins_ == 0; });
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_one();
+    worker_.join();
+  }
+
+  stream_queue(const stream_queue&) = delete;
+  stream_queue& operator=(const stream_queue&) = delete;
+
+  void enqueue(std::function<void()> task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (capturing_) {
+        captured_.push_back(std::move(task));
+        return;
+      }
+      tasks_.push_back(std::move(task));
+    }
+    work_cv_.notify_one();
+  }
+
+  void begin_capture()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capturing_) {
+      throw std::runtime_error("gt::stream: capture already in progress");
+    }
+    capturing_ = true;
+    capture_ = std::make_shared<std::atomic<bool>>(true);
+    captured_.clear();
+  }
+
+  std::vector<std::function<void()>> end_capture()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!capturing_) {
+      throw std::runtime_error("gt::stream: no capture in progress");
+    }
+    capturing_ = false;
+    *capture_ = false;
+    capture_ = nullptr;
+    return std::move(captured_);
+  }
+
+  // while capturing, a flag that is cleared when the capture ends, nullptr
+  // otherwise
+  std::shared_ptr<const std::atomic<bool>> capture_flag()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capture_;
+  }
+
+  bool is_idle()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.empty() && !busy_;
+  }
+
+  // wait until all work submitted so far has completed, and rethrow the
+  // first exception thrown by it since the last synchronize()
+  void synchronize()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (capturing_) {
+      throw std::logic_error(
+        "gt::stream: cannot synchronize a stream during graph capture");
+    }
+    idle_cv_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+    if (error_) {
+      auto error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  // the error that synchronize() would rethrow, for work running on the
+  // calling thread's queue; nullptr when not called from queued work
+  static std::exception_ptr current_error()
+  {
+    auto queue = current();
+    if (!queue) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(queue->mutex_);
+    return queue->error_;
+  }
+
+  // synchronize every live queue. The registry lock is only held to take a
+  // snapshot, as work running on a queue may itself create or destroy
+  // streams; queues in the snapshot are pinned so they stay alive meanwhile.
+  static void synchronize_all()
+  {
+    std::vector<stream_queue*> queues;
+    {
+      std::lock_guard<std::mutex> lock(stream_queues_mutex());
+      queues.assign(stream_queues().begin(), stream_queues().end());
+      for (auto queue : queues) {
+        queue->pins_++;
+      }
+    }
+    std::exception_ptr error;
+    for (auto queue : queues) {
+      try {
+        queue->synchronize();
+      } catch (...) {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(stream_queues_mutex());
+      for (auto queue : queues) {
+        queue->pins_--;
+      }
+    }
+    pinned_cv().notify_all();
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+private:
+  static std::condition_variable& pinned_cv()
+  {
+    static std::condition_variable cv;
+    return cv;
+  }
+
+  // the queue whose worker is the calling thread
+  static stream_queue*& current()
+  {
+    static thread_local stream_queue* queue = nullptr;
+    return queue;
+  }
+
+  void run()
+  {
+    current() = this;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      work_cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        // stop_ is set and all submitted work is done
+        return;
+      }
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      std::exception_ptr error;
+      try {
+        task();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      if (error && !error_) {
+        error_ = error;
+      }
+      busy_ = false;
+      if (tasks_.empty()) {
+        idle_cv_.notify_all();
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable idle_cv_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::function<void()>> captured_;
+  std::shared_ptr<std::atomic<bool>> capture_;
+  std::exception_ptr error_;
+  bool busy_;
+  bool stop_;
+  bool capturing_;
+  int pins_ = 0; // guarded by stream_queues_mutex()
+  std::thread worker_;
+};
+
+inline void synchronize_all_streams()
+{
+  stream_queue::synchronize_all();
+}
+
+template <typename F>
+inline void enqueue(stream_queue* queue, F&& f)
+{
+  if (queue) {
+    queue->enqueue(std::forward<F>(f));
+  } else {
+    std::forward<F>(f)();
+  }
+}
+
+// backend streams other than host stream queues (device builds): host work
+// runs inline
+template <typename Stream, typename F>
+inline void enqueue(const Stream&, F&& f)
+{
+  std::forward<F>(f)();
+}
+
+// ======================================================================
+// event_state
+//
+// completion flag and timestamp shared between an event and the work that
+// marks it complete, along with the error of the stream at that point, which
+// wait() rethrows. For an event recorded during a capture, wait() throws
+// until the capture has ended.
+
+class event_state
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  explicit event_state(
+    std::shared_ptr<const std::atomic<bool>> capture = nullptr)
+    : capture_(std::move(capture))
+  {}
+
+  void complete(std::exception_ptr error = nullptr)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      time_ = clock::now();
+      error_ = error;
+      complete_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  void wait()
+  {
+    if (capture_ && *capture_) {
+      throw std::logic_error(
+        "gt::event: cannot wait on an event recorded during graph capture");
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return complete_; });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  bool query()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return complete_;
+  }
+
+  clock::time_point time()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return time_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool complete_ = false;
+  clock::time_point time_;
+  std::exception_ptr error_;
+  std::shared_ptr<const std::atomic<bool>> capture_;
+};
+
+#ifdef GTENSOR_HAVE_POSIX_MADVISE
+// posix_madvise() on the pages overlapping [p, p + nbytes). Advice is only a
+// hint, so failures are ignored.
+inline void madvise(const void* p, std::size_t nbytes, int advice)
+{
+  if (nbytes == 0) {
+    return;
+  }
+  auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+  auto begin = reinterpret_cast<std::uintptr_t>(p) & ~(page - 1);
+  auto end = reinterpret_cast<std::uintptr_t>(p) + nbytes;
+  posix_madvise(reinterpret_cast<void*>(begin), end - begin, advice);
+}
+#endif
+
+} // namespace host
+
 template <>
 class backend_ops<gt::space::host>
 {
 public:
-  static void device_synchronize() {}
+  static void device_synchronize() { host::synchronize_all_streams(); }
 
   static int device_get_count() { return 1; }
 
-  static void device_set(int device_id) { assert(device_id == 0); }
+  static void device_set(int device_id)
+  {
+    assert(device_id == 0);
+    (void)device_id;
+  }
 
   static int device_get() { return 0; }
 
-  static uint32_t device_get_vendor_id(int device_id) { return 0; }
+  static uint32_t device_get_vendor_id(int) { return 0; }
 
   template <typename Ptr>
-  static bool is_device_accessible(const Ptr p)
+  static bool is_device_accessible(const Ptr)
   {
     return true;
   }
 
   template <typename Ptr>
-  static memory_type get_memory_type(const Ptr ptr)
+  static memory_type get_memory_type(const Ptr)
   {
     return memory_type::host;
   }
 
   template <typename T>
-  static void prefetch_device(T* p, size_type n)
+  static void prefetch_device(T*, size_type)
   {}
 
   template <typename T>
-  static void prefetch_host(T* p, size_type n)
+  static void prefetch_host(T*, size_type)
   {}
 
-  class hostStream_t
-  {};
+  using hostStream_t = host::stream_queue*;
 
   class stream_view : public stream_interface::stream_view_base<hostStream_t>
   {
@@ -57,12 +417,130 @@ public:
     using base_type = stream_view_base<hostStream_t>;
     using base_type::base_type;
 
-    stream_view() : base_type({}) {}
+    stream_view() : base_type(nullptr) {}
+
+    bool is_default() { return this->stream_ == nullptr; }
+
+    void synchronize()
+    {
+      if (this->stream_) {
+        this->stream_->synchronize();
+      }
+    }
+
+    // true if all work submitted to the stream has completed
+    bool query()
+    {
+      return this->stream_ == nullptr || this->stream_->is_idle();
+    }
+
+    // run f after previously submitted work, inline for the default stream
+    template <typename F>
+    void enqueue(F&& f)
+    {
+      host::enqueue(this->stream_, std::forward<F>(f));
+    }
+  };
 
-    bool is_default() { return true; }
+  class event
+  {
+  public:
+    explicit event(bool /* enable_timing */ = false)
+      : state_(std::make_shared<host::event_state>())
+    {
+      state_->complete();
+    }
+
+    // each record gets a fresh state, so work waiting on an earlier record
+    // is not affected
+    void record(stream_view stream)
+    {
+      auto queue = stream.get_backend_stream();
+      auto state = std::make_shared<host::event_state>(
+        queue ? queue->capture_flag() : nullptr);
+      state_ = state;
+      stream.enqueue(
+        [state]() { state->complete(host::stream_queue::current_error()); });
+    }
+
+    void synchronize() { state_->wait(); }
+
+    bool query() { return state_->query(); }
+
+    void stream_wait(hostStream_t stream) const
+    {
+      auto state = state_;
+      host::enqueue(stream, [state]() { state->wait(); });
+    }
+
+    static float elapsed_time(const event& start, const event& stop)
+    {
+      return std::chrono::duration<float, std::milli>(stop.state_->time() -
+                                                      start.state_->time())
+        .count();
+    }
+
+  private:
+    std::shared_ptr<host::event_state> state_;
+  };
 
-    void synchronize() {}
+  // work submitted to a stream between begin_capture() and end_capture() is
+  // recorded instead of executed; launch() queues the recorded work on a
+  // stream as a single task
+  class graph
+  {
+  public:
+    void begin_capture(stream_view stream)
+    {
+      if (stream.is_default()) {
+        throw std::runtime_error("gt::graph: cannot capture default stream");
+      }
+      stream.get_backend_stream()->begin_capture();
+    }
+
+    void end_capture(stream_view stream)
+    {
+      tasks_ = std::make_shared<std::vector<std::function<void()>>>(
+        stream.get_backend_stream()->end_capture());
+    }
+
+    void launch(stream_view stream)
+    {
+      assert(tasks_);
+      auto tasks = tasks_;
+      stream.enqueue([tasks]() {
+        for (auto& task : *tasks) {
+          task();
+        }
+      });
+    }
+
+  private:
+    std::shared_ptr<std::vector<std::function<void()>>> tasks_;
   };
+
+  // host and "device" memory are the same, both prefetches ask the OS to
+  // page the range in ahead of use
+  template <typename T>
+  static void prefetch_device(T* p, size_type n, stream_view stream)
+  {
+    prefetch_host(p, n, stream);
+  }
+
+  template <typename T>
+  static void prefetch_host(T* p, size_type n, stream_view stream)
+  {
+#ifdef GTENSOR_HAVE_POSIX_MADVISE
+    stream.enqueue(
+      [p, n]() { host::madvise(p, n * sizeof(T), POSIX_MADV_WILLNEED); });
+#endif
+  }
+
+  // the access hints are about placement in a separate device memory, which
+  // does not exist here
+  template <typename T>
+  static void advise(T*, size_type, gt::memory_advice)
+  {}
 };
 
 namespace allocator_impl
@@ -93,7 +571,7 @@ struct selector<T, gt::space::host_only>
 namespace copy_impl
 {
 template <typename InputPtr, typename OutputPtr>
-inline void copy_n(gt::space::host tag_in, gt::space::host tag_out, InputPtr in,
+inline void copy_n(gt::space::host, gt::space::host, InputPtr in,
                    size_type count, OutputPtr out)
 {
   // This may be used to copy between a gtensor and its host mirror, which are
@@ -103,43 +581,84 @@ inline void copy_n(gt::space::host tag_in, gt::space::host tag_out, InputPtr in,
     std::copy_n(in, count, out);
   }
 }
+
+template <typename InputPtr, typename OutputPtr, typename Stream>
+inline void copy_n_async(gt::space::host tag_in, gt::space::host tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         Stream stream)
+{
+  host::enqueue(stream, [=]() { copy_n(tag_in, tag_out, in, count, out); });
+}
+
+// pitched copy of `height` rows of `width` elements each; pitches are in
+// elements
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::host tag_in, gt::space::host tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  for (size_type j = 0; j < height; j++) {
+    copy_n(tag_in, tag_out, in + j * in_pitch, width, out + j * out_pitch);
+  }
+}
+
+template <typename InputPtr, typename OutputPtr, typename Stream>
+inline void copy_2d_async(gt::space::host tag_in, gt::space::host tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, Stream stream)
+{
+  host::enqueue(stream, [=]() {
+    copy_2d(tag_in, tag_out, in, in_pitch, out, out_pitch, width, height);
+  });
+}
 } // namespace copy_impl
 
 namespace fill_impl
 {
 template <typename Ptr, typename T>
-inline void fill(gt::space::host tag, Ptr first, Ptr last, const T& value)
+inline void fill(gt::space::host, Ptr first, Ptr last, const T& value)
 {
   std::fill(first, last, value);
 }
 } // namespace fill_impl
 
-namespace stream_interface
+namespace host
 {
-using hostStream_t = gt::backend::backend_ops<gt::space::host>::hostStream_t;
 
-} // namespace stream_interface
+template <typename F>
+inline void enqueue(backend_ops<gt::space::host>::stream_view stream, F&& f)
+{
+  stream.enqueue(std::forward<F>(f));
+}
 
-} // namespace backend
+} // namespace host
 
-#ifndef GTENSOR_HAVE_DEVICE
+namespace stream_interface
+{
+using hostStream_t = gt::backend::backend_ops<gt::space::host>::hostStream_t;
 
-class stream
+template <>
+inline hostStream_t create<hostStream_t>()
 {
-public:
-  stream() {}
+  return new host::stream_queue();
+}
+
+template <>
+inline void destroy<hostStream_t>(hostStream_t s)
+{
+  delete s;
+}
 
-  auto get_backend_stream() { return nullptr; }
+} // namespace stream_interface
 
-  bool is_default() { return true; }
+} // namespace backend
 
-  auto get_view()
-  {
-    return gt::backend::backend_ops<gt::space::host>::stream_view();
-  }
+#ifndef GTENSOR_HAVE_DEVICE
 
-  void synchronize() {}
-};
+using stream = backend::stream_interface::stream_base<
+  backend::stream_interface::hostStream_t,
+  backend::backend_ops<gt::space::host>::stream_view>;
 
 #endif
 
@@ -2,9 +2,13 @@
 #ifndef GTENSOR_BACKEND_SYCL_H
 #define GTENSOR_BACKEND_SYCL_H
 
+#include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <exception>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <unordered_map>
 
 #include "backend_common.h"
@@ -164,6 +168,136 @@ inline void copy_n(gt::space::host tag_in, gt::space::host tag_out, InputPtr in,
 }
 #endif
 
+// stream ordered copies, no implicit wait regardless of the allocation types
+template <typename InputPtr, typename OutputPtr>
+inline void sycl_copy_n_async(InputPtr in, size_type count, OutputPtr out,
+                              ::sycl::queue& q)
+{
+  q.copy(gt::raw_pointer_cast(in), gt::raw_pointer_cast(out), count);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_n_async(gt::space::sycl tag_in, gt::space::sycl tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         ::sycl::queue& q)
+{
+  sycl_copy_n_async(in, count, out, q);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_n_async(gt::space::sycl tag_in, gt::space::host tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         ::sycl::queue& q)
+{
+  sycl_copy_n_async(in, count, out, q);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_n_async(gt::space::host tag_in, gt::space::sycl tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         ::sycl::queue& q)
+{
+  sycl_copy_n_async(in, count, out, q);
+}
+
+// pitched copies: use the oneAPI 2D copy extension where available. Without
+// it, SYCL 2020 has no 2D memcpy, so device to device copies run as a single
+// kernel and copies involving host memory fall back to one copy per row.
+template <typename InputPtr, typename OutputPtr>
+inline void sycl_copy_2d_async(InputPtr in, size_type in_pitch, OutputPtr out,
+                               size_type out_pitch, size_type width,
+                               size_type height, ::sycl::queue& q)
+{
+  auto in_raw = gt::raw_pointer_cast(in);
+  auto out_raw = gt::raw_pointer_cast(out);
+#ifdef SYCL_EXT_ONEAPI_MEMCPY2D
+  q.ext_oneapi_copy2d(in_raw, in_pitch, out_raw, out_pitch, width, height);
+#else
+  for (size_type j = 0; j < height; j++) {
+    q.copy(in_raw + j * in_pitch, out_raw + j * out_pitch, width);
+  }
+#endif
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void sycl_copy_2d_device_async(InputPtr in, size_type in_pitch,
+                                      OutputPtr out, size_type out_pitch,
+                                      size_type width, size_type height,
+                                      ::sycl::queue& q)
+{
+#ifdef SYCL_EXT_ONEAPI_MEMCPY2D
+  sycl_copy_2d_async(in, in_pitch, out, out_pitch, width, height, q);
+#else
+  auto in_raw = gt::raw_pointer_cast(in);
+  auto out_raw = gt::raw_pointer_cast(out);
+  if (width == 0 || height == 0) {
+    return;
+  }
+  q.parallel_for(::sycl::range<2>(height, width), [=](::sycl::item<2> item) {
+    auto j = item.get_id(0);
+    auto i = item.get_id(1);
+    out_raw[j * out_pitch + i] = in_raw[j * in_pitch + i];
+  });
+#endif
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::sycl tag_in, gt::space::sycl tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  ::sycl::queue& q = gt::backend::sycl::get_queue();
+  sycl_copy_2d_device_async(in, in_pitch, out, out_pitch, width, height, q);
+  q.wait();
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::sycl tag_in, gt::space::host tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  ::sycl::queue& q = gt::backend::sycl::get_queue();
+  sycl_copy_2d_async(in, in_pitch, out, out_pitch, width, height, q);
+  q.wait();
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::host tag_in, gt::space::sycl tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  ::sycl::queue& q = gt::backend::sycl::get_queue();
+  sycl_copy_2d_async(in, in_pitch, out, out_pitch, width, height, q);
+  q.wait();
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d_async(gt::space::sycl tag_in, gt::space::sycl tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, ::sycl::queue& q)
+{
+  sycl_copy_2d_device_async(in, in_pitch, out, out_pitch, width, height, q);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d_async(gt::space::sycl tag_in, gt::space::host tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, ::sycl::queue& q)
+{
+  sycl_copy_2d_async(in, in_pitch, out, out_pitch, width, height, q);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d_async(gt::space::host tag_in, gt::space::sycl tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, ::sycl::queue& q)
+{
+  sycl_copy_2d_async(in, in_pitch, out, out_pitch, width, height, q);
+}
+
 } // namespace copy_impl
 
 namespace fill_impl
@@ -253,7 +387,7 @@ public:
   static void prefetch_device(T* p, size_type n)
   {
     auto& q = gt::backend::sycl::get_queue();
-    q.prefetch(p, n);
+    q.prefetch(p, n * sizeof(T));
   }
 
   // Not available in SYCL 2020, make it a no-op
@@ -290,7 +424,138 @@ public:
     }
 
     void synchronize() { stream_.wait(); }
+
+    // true if all work submitted to the queue has completed
+    bool query() { return stream_.ext_oneapi_empty(); }
   };
+
+  class event
+  {
+  public:
+    explicit event(bool enable_timing = false)
+    {
+      if (enable_timing) {
+        time_ = std::make_shared<clock::time_point>();
+      }
+    }
+
+    // the stream queues are in-order, so a barrier marks completion of all
+    // previously submitted work. Timing events use a host task instead, which
+    // takes a timestamp once that work is done; profiling info is only
+    // available for queues created with enable_profiling.
+    void record(stream_view stream)
+    {
+      auto& q = stream.get_backend_stream();
+      if (time_) {
+        auto time = time_;
+        event_ = q.submit([&](::sycl::handler& cgh) {
+          cgh.host_task([=]() { *time = clock::now(); });
+        });
+      } else {
+        event_ = q.ext_oneapi_submit_barrier();
+      }
+    }
+
+    void synchronize() { event_.wait(); }
+
+    bool query()
+    {
+      return event_.get_info<::sycl::info::event::command_execution_status>() ==
+             ::sycl::info::event_command_status::complete;
+    }
+
+    // make work submitted to `stream` after this call wait for the event
+    void stream_wait(::sycl::queue& stream) const
+    {
+      stream.ext_oneapi_submit_barrier({event_});
+    }
+
+    // milliseconds between start and stop, both created with timing enabled
+    static float elapsed_time(event& start, event& stop)
+    {
+      assert(start.time_ && stop.time_);
+      start.synchronize();
+      stop.synchronize();
+      return std::chrono::duration<float, std::milli>(*stop.time_ -
+                                                      *start.time_)
+        .count();
+    }
+
+    ::sycl::event& get_backend_event() { return event_; }
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    ::sycl::event event_;
+    std::shared_ptr<clock::time_point> time_;
+  };
+
+  // uses the sycl_ext_oneapi_graph command graphs where available
+  class graph
+  {
+  public:
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+    void begin_capture(stream_view stream)
+    {
+      auto& q = stream.get_backend_stream();
+      graph_ = std::make_unique<modifiable_graph>(q.get_context(),
+                                                  q.get_device());
+      graph_->begin_recording(q);
+    }
+
+    void end_capture(stream_view stream)
+    {
+      graph_->end_recording(stream.get_backend_stream());
+      exec_ = std::make_unique<executable_graph>(graph_->finalize());
+    }
+
+    void launch(stream_view stream)
+    {
+      stream.get_backend_stream().ext_oneapi_graph(*exec_);
+    }
+
+  private:
+    using modifiable_graph = ::sycl::ext::oneapi::experimental::command_graph<
+      ::sycl::ext::oneapi::experimental::graph_state::modifiable>;
+    using executable_graph = ::sycl::ext::oneapi::experimental::command_graph<
+      ::sycl::ext::oneapi::experimental::graph_state::executable>;
+
+    std::unique_ptr<modifiable_graph> graph_;
+    std::unique_ptr<executable_graph> exec_;
+#else
+    void begin_capture(stream_view stream) { not_supported(); }
+
+    void end_capture(stream_view stream) { not_supported(); }
+
+    void launch(stream_view stream) { not_supported(); }
+
+  private:
+    void not_supported()
+    {
+      throw std::runtime_error(
+        "gt::graph: SYCL implementation lacks sycl_ext_oneapi_graph");
+    }
+#endif
+  };
+
+  template <typename T>
+  static void prefetch_device(T* p, size_type n, stream_view stream)
+  {
+    // only shared (managed) allocations migrate, others are left alone
+    if (n > 0 && get_memory_type(p) == memory_type::managed) {
+      stream.get_backend_stream().prefetch(p, n * sizeof(T));
+    }
+  }
+
+  // Not available in SYCL 2020, make it a no-op
+  template <typename T>
+  static void prefetch_host(T* p, size_type n, stream_view stream)
+  {}
+
+  // mem_advise() takes backend specific advice values, make it a no-op
+  template <typename T>
+  static void advise(T* p, size_type n, gt::memory_advice advice)
+  {}
 };
 
 namespace stream_interface
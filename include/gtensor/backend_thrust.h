@@ -70,6 +70,93 @@ inline void copy_n(gt::space::host tag_in, gt::space::thrust tag_out,
   ::thrust::copy_n(in, count, out);
 }
 
+// Note: thrust copies are not stream ordered, these are synchronous
+template <typename InputPtr, typename OutputPtr, typename Stream>
+inline void copy_n_async(gt::space::thrust tag_in, gt::space::thrust tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         Stream stream)
+{
+  ::thrust::copy_n(in, count, out);
+}
+
+template <typename InputPtr, typename OutputPtr, typename Stream>
+inline void copy_n_async(gt::space::thrust tag_in, gt::space::host tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         Stream stream)
+{
+  ::thrust::copy_n(in, count, out);
+}
+
+template <typename InputPtr, typename OutputPtr, typename Stream>
+inline void copy_n_async(gt::space::host tag_in, gt::space::thrust tag_out,
+                         InputPtr in, size_type count, OutputPtr out,
+                         Stream stream)
+{
+  ::thrust::copy_n(in, count, out);
+}
+
+// pitched copies, one thrust::copy_n per row
+template <typename InputPtr, typename OutputPtr>
+inline void thrust_copy_2d(InputPtr in, size_type in_pitch, OutputPtr out,
+                           size_type out_pitch, size_type width,
+                           size_type height)
+{
+  for (size_type j = 0; j < height; j++) {
+    ::thrust::copy_n(in + j * in_pitch, width, out + j * out_pitch);
+  }
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::thrust tag_in, gt::space::thrust tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  thrust_copy_2d(in, in_pitch, out, out_pitch, width, height);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::thrust tag_in, gt::space::host tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  thrust_copy_2d(in, in_pitch, out, out_pitch, width, height);
+}
+
+template <typename InputPtr, typename OutputPtr>
+inline void copy_2d(gt::space::host tag_in, gt::space::thrust tag_out,
+                    InputPtr in, size_type in_pitch, OutputPtr out,
+                    size_type out_pitch, size_type width, size_type height)
+{
+  thrust_copy_2d(in, in_pitch, out, out_pitch, width, height);
+}
+
+template <typename InputPtr, typename OutputPtr, typename Stream>
+inline void copy_2d_async(gt::space::thrust tag_in, gt::space::thrust tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, Stream stream)
+{
+  thrust_copy_2d(in, in_pitch, out, out_pitch, width, height);
+}
+
+template <typename InputPtr, typename OutputPtr, typename Stream>
+inline void copy_2d_async(gt::space::thrust tag_in, gt::space::host tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, Stream stream)
+{
+  thrust_copy_2d(in, in_pitch, out, out_pitch, width, height);
+}
+
+template <typename InputPtr, typename OutputPtr, typename Stream>
+inline void copy_2d_async(gt::space::host tag_in, gt::space::thrust tag_out,
+                          InputPtr in, size_type in_pitch, OutputPtr out,
+                          size_type out_pitch, size_type width,
+                          size_type height, Stream stream)
+{
+  thrust_copy_2d(in, in_pitch, out, out_pitch, width, height);
+}
+
 } // namespace copy_impl
 
 namespace fill_impl
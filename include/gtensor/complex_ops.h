@@ -121,16 +121,94 @@ GT_INLINE auto norm(thrust::device_reference<const T> a)
   return gt::norm(thrust::raw_reference_cast(a));
 }
 
+// ======================================================================
+// elementary functions with complex overloads
+//
+// The real versions come from the std library (which are usable on device),
+// the complex versions from thrust.
+
+#define GT_MAKE_COMPLEX_MATH_FUNC(NAME)                                        \
+  using std::NAME;                                                             \
+  using thrust::NAME;                                                          \
+                                                                               \
+  template <typename T>                                                        \
+  GT_INLINE auto NAME(thrust::device_reference<T> a)                           \
+  {                                                                            \
+    return gt::NAME(thrust::raw_reference_cast(a));                            \
+  }                                                                            \
+                                                                               \
+  template <typename T>                                                        \
+  GT_INLINE auto NAME(thrust::device_reference<const T> a)                     \
+  {                                                                            \
+    return gt::NAME(thrust::raw_reference_cast(a));                            \
+  }
+
+GT_MAKE_COMPLEX_MATH_FUNC(sqrt)
+GT_MAKE_COMPLEX_MATH_FUNC(log)
+GT_MAKE_COMPLEX_MATH_FUNC(log10)
+GT_MAKE_COMPLEX_MATH_FUNC(sin)
+GT_MAKE_COMPLEX_MATH_FUNC(cos)
+GT_MAKE_COMPLEX_MATH_FUNC(tan)
+GT_MAKE_COMPLEX_MATH_FUNC(asin)
+GT_MAKE_COMPLEX_MATH_FUNC(acos)
+GT_MAKE_COMPLEX_MATH_FUNC(atan)
+GT_MAKE_COMPLEX_MATH_FUNC(sinh)
+GT_MAKE_COMPLEX_MATH_FUNC(cosh)
+GT_MAKE_COMPLEX_MATH_FUNC(tanh)
+GT_MAKE_COMPLEX_MATH_FUNC(asinh)
+GT_MAKE_COMPLEX_MATH_FUNC(acosh)
+GT_MAKE_COMPLEX_MATH_FUNC(atanh)
+
+#undef GT_MAKE_COMPLEX_MATH_FUNC
+
+// ======================================================================
+// pow
+
+using std::pow;
+using thrust::pow;
+
 #elif defined(GTENSOR_DEVICE_SYCL)
 
 using gt::sycl_cplx::abs;
 using gt::sycl_cplx::conj;
 using gt::sycl_cplx::exp;
 using gt::sycl_cplx::norm;
+using gt::sycl_cplx::sqrt;
+using gt::sycl_cplx::log;
+using gt::sycl_cplx::log10;
+using gt::sycl_cplx::pow;
+using gt::sycl_cplx::sin;
+using gt::sycl_cplx::cos;
+using gt::sycl_cplx::tan;
+using gt::sycl_cplx::asin;
+using gt::sycl_cplx::acos;
+using gt::sycl_cplx::atan;
+using gt::sycl_cplx::sinh;
+using gt::sycl_cplx::cosh;
+using gt::sycl_cplx::tanh;
+using gt::sycl_cplx::asinh;
+using gt::sycl_cplx::acosh;
+using gt::sycl_cplx::atanh;
 
 // real version from stdlib
 using std::abs;
 using std::exp;
+using std::sqrt;
+using std::log;
+using std::log10;
+using std::pow;
+using std::sin;
+using std::cos;
+using std::tan;
+using std::asin;
+using std::acos;
+using std::atan;
+using std::sinh;
+using std::cosh;
+using std::tanh;
+using std::asinh;
+using std::acosh;
+using std::atanh;
 
 #else // host, use std lib
 
@@ -138,6 +216,22 @@ using std::abs;
 using std::conj;
 using std::exp;
 using std::norm;
+using std::sqrt;
+using std::log;
+using std::log10;
+using std::pow;
+using std::sin;
+using std::cos;
+using std::tan;
+using std::asin;
+using std::acos;
+using std::atan;
+using std::sinh;
+using std::cosh;
+using std::tanh;
+using std::asinh;
+using std::acosh;
+using std::atanh;
 
 #endif
 
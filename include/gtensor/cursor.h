@@ -0,0 +1,278 @@
+
+// ======================================================================
+// cursor.h
+//
+// cursors: a position inside an expression that is moved one dimension at a
+// time. Nested loops copy the cursor at the start of each loop level and call
+// step(d) at the end of each iteration; the innermost loop accesses c[i], the
+// element i steps along dimension 0. That way the per-element work is a
+// single strided access off a base pointer / offset instead of a full
+// offset + sum(idx[d] * strides[d]) computation.
+//
+// Expressions opt in via a cursor() member (gstrided, gcontainer,
+// gtensor_span, gscalar, gfunction); anything else gets an index_cursor that
+// falls back to regular multi-d indexing.
+
+#ifndef GTENSOR_CURSOR_H
+#define GTENSOR_CURSOR_H
+
+#include <type_traits>
+#include <utility>
+
+#include "defs.h"
+#include "expression.h"
+#include "macros.h"
+#include "meta.h"
+#include "sarray.h"
+
+namespace gt
+{
+
+// ======================================================================
+// pointer_cursor
+//
+// walks raw storage with the given strides, used for containers and spans
+
+template <typename P, size_type N>
+class pointer_cursor
+{
+public:
+  using strides_type = gt::shape_type<N>;
+
+  GT_INLINE pointer_cursor(P p, const strides_type& strides)
+    : p_(p), strides_(strides)
+  {}
+
+  GT_INLINE decltype(auto) operator*() const { return *p_; }
+
+  GT_INLINE decltype(auto) operator[](index_t i) const
+  {
+    return p_[i * strides_[0]];
+  }
+
+  GT_INLINE void step(int d) { p_ += strides_[d]; }
+
+  GT_INLINE P data() const { return p_; }
+  GT_INLINE const strides_type& strides() const { return strides_; }
+
+private:
+  P p_;
+  strides_type strides_;
+};
+
+// ======================================================================
+// strided_cursor
+//
+// walks the linear offset of a gstrided expression, accessing elements via
+// data_access(); used for gview, where the underlying expression applies its
+// own offset.
+
+template <typename D, size_type N>
+class strided_cursor
+{
+public:
+  using strides_type = gt::shape_type<N>;
+
+  GT_INLINE strided_cursor(D& e, const strides_type& strides)
+    : e_(&e), offset_(0), strides_(strides)
+  {}
+
+  GT_INLINE decltype(auto) operator*() const
+  {
+    return e_->data_access(size_type(offset_));
+  }
+
+  GT_INLINE decltype(auto) operator[](index_t i) const
+  {
+    return e_->data_access(size_type(offset_ + i * strides_[0]));
+  }
+
+  GT_INLINE void step(int d) { offset_ += strides_[d]; }
+
+private:
+  D* e_;
+  // signed, strides may be negative; only the offsets of elements that are
+  // accessed are non-negative
+  index_t offset_;
+  strides_type strides_;
+};
+
+// ======================================================================
+// index_cursor
+//
+// fallback for expressions without a cursor() member, keeps a multi-d index
+
+template <typename E>
+class index_cursor
+{
+public:
+  using shape_type = gt::shape_type<expr_dimension<E>()>;
+
+  GT_INLINE index_cursor(E& e) : e_(&e), idx_() {}
+
+  GT_INLINE decltype(auto) operator*() const
+  {
+    return index_expression(*e_, idx_);
+  }
+
+  GT_INLINE decltype(auto) operator[](index_t i) const
+  {
+    shape_type idx = idx_;
+    idx[0] += i;
+    return index_expression(*e_, idx);
+  }
+
+  GT_INLINE void step(int d) { idx_[d]++; }
+
+private:
+  E* e_;
+  shape_type idx_;
+};
+
+// ======================================================================
+// scalar_cursor
+
+template <typename T>
+class scalar_cursor
+{
+public:
+  GT_INLINE scalar_cursor(const T& value) : value_(value) {}
+
+  GT_INLINE T operator*() const { return value_; }
+
+  GT_INLINE T operator[](index_t) const { return value_; }
+
+  GT_INLINE void step(int) {}
+
+private:
+  T value_;
+};
+
+// ======================================================================
+// function_cursor
+//
+// applies the function of a gfunction / gfunction_ternary to the values of
+// the operand cursors
+
+template <typename F, typename... C>
+class function_cursor;
+
+template <typename F, typename C>
+class function_cursor<F, C>
+{
+public:
+  GT_INLINE function_cursor(const F& f, C c) : f_(&f), c_(c) {}
+
+  GT_INLINE decltype(auto) operator*() const { return (*f_)(*c_); }
+
+  GT_INLINE decltype(auto) operator[](index_t i) const { return (*f_)(c_[i]); }
+
+  GT_INLINE void step(int d) { c_.step(d); }
+
+private:
+  const F* f_;
+  C c_;
+};
+
+template <typename F, typename C1, typename C2>
+class function_cursor<F, C1, C2>
+{
+public:
+  GT_INLINE function_cursor(const F& f, C1 c1, C2 c2)
+    : f_(&f), c1_(c1), c2_(c2)
+  {}
+
+  GT_INLINE decltype(auto) operator*() const { return (*f_)(*c1_, *c2_); }
+
+  GT_INLINE decltype(auto) operator[](index_t i) const
+  {
+    return (*f_)(c1_[i], c2_[i]);
+  }
+
+  GT_INLINE void step(int d)
+  {
+    c1_.step(d);
+    c2_.step(d);
+  }
+
+private:
+  const F* f_;
+  C1 c1_;
+  C2 c2_;
+};
+
+template <typename F, typename C1, typename C2, typename C3>
+class function_cursor<F, C1, C2, C3>
+{
+public:
+  GT_INLINE function_cursor(const F& f, C1 c1, C2 c2, C3 c3)
+    : f_(&f), c1_(c1), c2_(c2), c3_(c3)
+  {}
+
+  GT_INLINE decltype(auto) operator*() const
+  {
+    return (*f_)(*c1_, *c2_, *c3_);
+  }
+
+  GT_INLINE decltype(auto) operator[](index_t i) const
+  {
+    return (*f_)(c1_[i], c2_[i], c3_[i]);
+  }
+
+  GT_INLINE void step(int d)
+  {
+    c1_.step(d);
+    c2_.step(d);
+    c3_.step(d);
+  }
+
+private:
+  const F* f_;
+  C1 c1_;
+  C2 c2_;
+  C3 c3_;
+};
+
+template <typename F, typename... C>
+GT_INLINE auto make_function_cursor(const F& f, C... c)
+{
+  return function_cursor<F, C...>(f, c...);
+}
+
+// ======================================================================
+// cursor
+//
+// returns e.cursor() if the expression provides one, an index_cursor
+// otherwise
+
+namespace detail
+{
+
+template <typename E, typename Enable = void>
+struct has_cursor : std::false_type
+{};
+
+template <typename E>
+struct has_cursor<E, gt::meta::void_t<decltype(std::declval<E&>().cursor())>>
+  : std::true_type
+{};
+
+} // namespace detail
+
+template <typename E,
+          std::enable_if_t<detail::has_cursor<E>::value, int> = 0>
+GT_INLINE auto cursor(E& e)
+{
+  return e.cursor();
+}
+
+template <typename E,
+          std::enable_if_t<!detail::has_cursor<E>::value, int> = 0>
+GT_INLINE auto cursor(E& e)
+{
+  return index_cursor<E>(e);
+}
+
+} // namespace gt
+
+#endif
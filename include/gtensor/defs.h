@@ -3,6 +3,7 @@
 #define GTENSOR_DEFS_H
 
 #include <cstddef>
+#include <cstdint>
 
 // This really should be defined by the build system, but it'll cause
 // compatibility issues with plain old make, so let's be cautious.
@@ -15,6 +16,15 @@ namespace gt
 
 using size_type = std::size_t;
 
+// index type used for shapes, strides and launch indices. 32-bit by default;
+// define GTENSOR_INDEX_64 (cmake option of the same name) for arrays with more
+// than 2^31 elements.
+#ifdef GTENSOR_INDEX_64
+using index_t = std::int64_t;
+#else
+using index_t = int;
+#endif
+
 // forward declarations
 
 template <typename T, size_type N>
@@ -23,7 +33,7 @@ class sarray;
 // some commonly used types
 
 template <size_type N>
-using shape_type = sarray<int, N>;
+using shape_type = sarray<index_t, N>;
 
 template <typename T1, typename T2>
 auto div_ceil(const T1 n, const T2 d)
@@ -39,6 +39,37 @@ using clib = backend_ops<gt::space::host>;
 } // namespace backend
 
 using stream_view = backend::clib::stream_view;
+using event = backend::clib::event;
+using graph = backend::clib::graph;
+
+// records the work f() submits to `stream` into a graph for later replay with
+// graph.launch(stream). If f() throws, the capture is ended (and the partial
+// graph dropped) before the exception propagates, so the stream stays usable.
+template <typename F>
+inline gt::graph capture_graph(gt::stream_view stream, F&& f)
+{
+  gt::graph g;
+  g.begin_capture(stream);
+  try {
+    std::forward<F>(f)();
+  } catch (...) {
+    try {
+      g.end_capture(stream);
+    } catch (...) {
+    }
+    throw;
+  }
+  g.end_capture(stream);
+  return g;
+}
+
+// milliseconds between two recorded events, which must have been created with
+// timing enabled. Waits for `stop` to complete.
+inline float elapsed_time(gt::event& start, gt::event& stop)
+{
+  stop.synchronize();
+  return gt::event::elapsed_time(start, stop);
+}
 
 template <typename T, typename S = gt::space::device>
 using device_allocator = typename backend::allocator_impl::selector<T, S>::type;
@@ -80,6 +111,64 @@ inline void copy_n(InputPtr in, gt::size_type count, OutputPtr out)
     typename pointer_traits<OutputPtr>::space_type{}, in, count, out);
 }
 
+// ======================================================================
+// copy_n_async
+//
+// enqueues the copy on the given stream and returns without waiting for it
+
+template <
+  typename InputPtr, typename OutputPtr,
+  std::enable_if_t<is_allowed_element_type_conversion<
+                     typename pointer_traits<OutputPtr>::element_type,
+                     typename pointer_traits<InputPtr>::element_type>::value,
+                   int> = 0>
+inline void copy_n_async(InputPtr in, gt::size_type count, OutputPtr out,
+                         gt::stream_view stream)
+{
+  return gt::backend::copy_impl::copy_n_async(
+    typename pointer_traits<InputPtr>::space_type{},
+    typename pointer_traits<OutputPtr>::space_type{}, in, count, out,
+    stream.get_backend_stream());
+}
+
+// ======================================================================
+// copy_2d, copy_2d_async
+//
+// pitched copy of `height` rows of `width` elements, row j starting at
+// in + j * in_pitch / out + j * out_pitch
+
+template <
+  typename InputPtr, typename OutputPtr,
+  std::enable_if_t<is_allowed_element_type_conversion<
+                     typename pointer_traits<OutputPtr>::element_type,
+                     typename pointer_traits<InputPtr>::element_type>::value,
+                   int> = 0>
+inline void copy_2d(InputPtr in, gt::size_type in_pitch, OutputPtr out,
+                    gt::size_type out_pitch, gt::size_type width,
+                    gt::size_type height)
+{
+  gt::backend::copy_impl::copy_2d(
+    typename pointer_traits<InputPtr>::space_type{},
+    typename pointer_traits<OutputPtr>::space_type{}, in, in_pitch, out,
+    out_pitch, width, height);
+}
+
+template <
+  typename InputPtr, typename OutputPtr,
+  std::enable_if_t<is_allowed_element_type_conversion<
+                     typename pointer_traits<OutputPtr>::element_type,
+                     typename pointer_traits<InputPtr>::element_type>::value,
+                   int> = 0>
+inline void copy_2d_async(InputPtr in, gt::size_type in_pitch, OutputPtr out,
+                          gt::size_type out_pitch, gt::size_type width,
+                          gt::size_type height, gt::stream_view stream)
+{
+  gt::backend::copy_impl::copy_2d_async(
+    typename pointer_traits<InputPtr>::space_type{},
+    typename pointer_traits<OutputPtr>::space_type{}, in, in_pitch, out,
+    out_pitch, width, height, stream.get_backend_stream());
+}
+
 // ======================================================================
 // synchronize
 
@@ -87,39 +87,42 @@ using to_kernel_t =
 
 // ======================================================================
 // index expression helper
+//
+// templated on the index element type, so 32-bit fast path kernels do not
+// widen their indices when GTENSOR_INDEX_64 is enabled
 
-template <typename E>
-GT_INLINE decltype(auto) index_expression(E&& expr, shape_type<1> idx)
+template <typename E, typename I>
+GT_INLINE decltype(auto) index_expression(E&& expr, sarray<I, 1> idx)
 {
   return expr(idx[0]);
 }
 
-template <typename E>
-GT_INLINE decltype(auto) index_expression(E&& expr, shape_type<2> idx)
+template <typename E, typename I>
+GT_INLINE decltype(auto) index_expression(E&& expr, sarray<I, 2> idx)
 {
   return expr(idx[0], idx[1]);
 }
 
-template <typename E>
-GT_INLINE decltype(auto) index_expression(E&& expr, shape_type<3> idx)
+template <typename E, typename I>
+GT_INLINE decltype(auto) index_expression(E&& expr, sarray<I, 3> idx)
 {
   return expr(idx[0], idx[1], idx[2]);
 }
 
-template <typename E>
-GT_INLINE decltype(auto) index_expression(E&& expr, shape_type<4> idx)
+template <typename E, typename I>
+GT_INLINE decltype(auto) index_expression(E&& expr, sarray<I, 4> idx)
 {
   return expr(idx[0], idx[1], idx[2], idx[3]);
 }
 
-template <typename E>
-GT_INLINE decltype(auto) index_expression(E&& expr, shape_type<5> idx)
+template <typename E, typename I>
+GT_INLINE decltype(auto) index_expression(E&& expr, sarray<I, 5> idx)
 {
   return expr(idx[0], idx[1], idx[2], idx[3], idx[4]);
 }
 
-template <typename E>
-GT_INLINE decltype(auto) index_expression(E&& expr, shape_type<6> idx)
+template <typename E, typename I>
+GT_INLINE decltype(auto) index_expression(E&& expr, sarray<I, 6> idx)
 {
   return expr(idx[0], idx[1], idx[2], idx[3], idx[4], idx[5]);
 }
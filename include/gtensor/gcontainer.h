@@ -61,6 +61,9 @@ public:
   GT_INLINE const_pointer data() const;
   GT_INLINE pointer data();
 
+  GT_INLINE auto cursor() const;
+  GT_INLINE auto cursor();
+
   GT_INLINE const storage_type& storage() const;
   GT_INLINE storage_type& storage();
 
@@ -133,6 +136,20 @@ GT_INLINE auto gcontainer<D>::data() -> pointer
   return storage().data();
 }
 
+template <typename D>
+GT_INLINE auto gcontainer<D>::cursor() const
+{
+  return pointer_cursor<const_pointer, base_type::dimension()>(
+    data(), this->strides());
+}
+
+template <typename D>
+GT_INLINE auto gcontainer<D>::cursor()
+{
+  return pointer_cursor<pointer, base_type::dimension()>(data(),
+                                                         this->strides());
+}
+
 template <typename D>
 template <typename... Args>
 GT_INLINE auto gcontainer<D>::operator()(Args&&... args) const
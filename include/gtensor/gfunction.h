@@ -13,6 +13,7 @@
 #include "gstrided.h"
 #include "helper.h"
 #include "macros.h"
+#include "write_tracking.h"
 
 #include <numeric>
 
@@ -225,12 +226,17 @@ public:
   }
 
   GT_INLINE shape_type shape() const;
-  GT_INLINE int shape(int i) const;
+  GT_INLINE index_t shape(int i) const;
   GT_INLINE size_type size() const { return calc_size(shape()); }
 
   template <typename... Args>
   GT_INLINE value_type operator()(Args... args) const;
 
+  GT_INLINE auto cursor() const
+  {
+    return make_function_cursor(f_, gt::cursor(e_));
+  }
+
   const_kernel_type to_kernel() const;
 
   template <typename... Args>
@@ -242,6 +248,12 @@ public:
 
   inline std::string typestr() const&;
 
+  // for write tracking, see write_tracking.h
+  void wait_write(gt::stream_view stream) const
+  {
+    detail::wait_write(e_, stream);
+  }
+
 private:
   F f_;
   E e_;
@@ -278,12 +290,17 @@ public:
   }
 
   GT_INLINE shape_type shape() const;
-  GT_INLINE int shape(int i) const;
+  GT_INLINE index_t shape(int i) const;
   GT_INLINE size_type size() const { return calc_size(shape()); }
 
   template <typename... Args>
   GT_INLINE value_type operator()(Args... args) const;
 
+  GT_INLINE auto cursor() const
+  {
+    return make_function_cursor(f_, gt::cursor(e1_), gt::cursor(e2_));
+  }
+
   const_kernel_type to_kernel() const;
 
   template <typename... Args>
@@ -295,6 +312,12 @@ public:
 
   inline std::string typestr() const&;
 
+  void wait_write(gt::stream_view stream) const
+  {
+    detail::wait_write(e1_, stream);
+    detail::wait_write(e2_, stream);
+  }
+
 private:
   F f_;
   E1 e1_;
@@ -313,7 +336,7 @@ GT_INLINE auto gfunction<F, E, gt_empty_expr>::shape() const -> shape_type
 }
 
 template <typename F, typename E>
-GT_INLINE int gfunction<F, E, gt_empty_expr>::shape(int i) const
+GT_INLINE index_t gfunction<F, E, gt_empty_expr>::shape(int i) const
 {
   return shape()[i];
 }
@@ -327,7 +350,7 @@ GT_INLINE auto gfunction<F, E1, E2>::shape() const -> shape_type
 }
 
 template <typename F, typename E1, typename E2>
-GT_INLINE int gfunction<F, E1, E2>::shape(int i) const
+GT_INLINE index_t gfunction<F, E1, E2>::shape(int i) const
 {
   return shape()[i];
 }
@@ -450,6 +473,14 @@ MAKE_BINARY_OP(minus, -)
 MAKE_BINARY_OP(multiply, *)
 MAKE_BINARY_OP(divide, /)
 
+// element-wise comparisons, evaluate to bool. Note that operator== /
+// operator!= compare whole expressions (see operator.h), so element-wise
+// equality is provided by gt::equal / gt::not_equal below.
+MAKE_BINARY_OP(less, <)
+MAKE_BINARY_OP(less_equal, <=)
+MAKE_BINARY_OP(greater, >)
+MAKE_BINARY_OP(greater_equal, >=)
+
 #undef MAKE_BINARY_OP
 
 // FIXME: The nv_exec_check_disable removes a warning cause by std::abs
@@ -478,14 +509,126 @@ MAKE_BINARY_OP(divide, /)
     return function(funcs::NAME{}, std::forward<E>(e));                        \
   }
 
+// Note: the functions below are plain, inlineable function objects rather
+// than opaque lambdas, so the host loops in assign can be auto-vectorized
+// (e.g. gcc maps std math calls to libmvec under -ffast-math), and on device
+// they resolve to the native math intrinsics.
+
+// real or complex argument
 MAKE_UNARY_FUNC(abs, gt::abs)
-MAKE_UNARY_FUNC(sin, std::sin)
-MAKE_UNARY_FUNC(cos, std::cos)
-MAKE_UNARY_FUNC(tan, std::tan)
+MAKE_UNARY_FUNC(sqrt, gt::sqrt)
 MAKE_UNARY_FUNC(exp, gt::exp)
+MAKE_UNARY_FUNC(log, gt::log)
+MAKE_UNARY_FUNC(log10, gt::log10)
+MAKE_UNARY_FUNC(sin, gt::sin)
+MAKE_UNARY_FUNC(cos, gt::cos)
+MAKE_UNARY_FUNC(tan, gt::tan)
+MAKE_UNARY_FUNC(asin, gt::asin)
+MAKE_UNARY_FUNC(acos, gt::acos)
+MAKE_UNARY_FUNC(atan, gt::atan)
+MAKE_UNARY_FUNC(sinh, gt::sinh)
+MAKE_UNARY_FUNC(cosh, gt::cosh)
+MAKE_UNARY_FUNC(tanh, gt::tanh)
+MAKE_UNARY_FUNC(asinh, gt::asinh)
+MAKE_UNARY_FUNC(acosh, gt::acosh)
+MAKE_UNARY_FUNC(atanh, gt::atanh)
+
+// real argument only
+MAKE_UNARY_FUNC(cbrt, std::cbrt)
+MAKE_UNARY_FUNC(exp2, std::exp2)
+MAKE_UNARY_FUNC(expm1, std::expm1)
+MAKE_UNARY_FUNC(log2, std::log2)
+MAKE_UNARY_FUNC(log1p, std::log1p)
+MAKE_UNARY_FUNC(erf, std::erf)
+MAKE_UNARY_FUNC(erfc, std::erfc)
+MAKE_UNARY_FUNC(tgamma, std::tgamma)
+MAKE_UNARY_FUNC(lgamma, std::lgamma)
+MAKE_UNARY_FUNC(floor, std::floor)
+MAKE_UNARY_FUNC(ceil, std::ceil)
+MAKE_UNARY_FUNC(trunc, std::trunc)
+MAKE_UNARY_FUNC(round, std::round)
 
 #undef MAKE_UNARY_FUNC
 
+#define MAKE_BINARY_FUNC(NAME, FUNC)                                           \
+                                                                               \
+  namespace funcs                                                              \
+  {                                                                            \
+  struct NAME                                                                  \
+  {                                                                            \
+    _Pragma("nv_exec_check_disable") template <typename T, typename U>         \
+    GT_INLINE auto operator()(T a, U b) const                                  \
+    {                                                                          \
+      return FUNC(a, b);                                                       \
+    }                                                                          \
+    const char* typestr = #NAME;                                               \
+  };                                                                           \
+  }                                                                            \
+                                                                               \
+  template <typename E1, typename E2,                                          \
+            typename Enable = std::enable_if_t<has_expression<E1, E2>::value>> \
+  auto NAME(E1&& e1, E2&& e2)                                                  \
+  {                                                                            \
+    return function(funcs::NAME{}, std::forward<E1>(e1),                       \
+                    std::forward<E2>(e2));                                     \
+  }
+
+MAKE_BINARY_FUNC(pow, gt::pow)
+MAKE_BINARY_FUNC(atan2, std::atan2)
+MAKE_BINARY_FUNC(hypot, std::hypot)
+MAKE_BINARY_FUNC(fmod, std::fmod)
+MAKE_BINARY_FUNC(copysign, std::copysign)
+MAKE_BINARY_FUNC(fmin, std::fmin)
+MAKE_BINARY_FUNC(fmax, std::fmax)
+
+#undef MAKE_BINARY_FUNC
+
+// ----------------------------------------------------------------------
+// minimum, maximum
+//
+// element-wise, like numpy's minimum / maximum; not called min / max to avoid
+// clashing with the reductions. Written as a select so it lowers to min/max
+// or blend instructions rather than a branch.
+
+namespace funcs
+{
+
+struct minimum
+{
+  template <typename T, typename U>
+  GT_INLINE auto operator()(T a, U b) const
+  {
+    return b < a ? b : a;
+  }
+  const char* typestr = "minimum";
+};
+
+struct maximum
+{
+  template <typename T, typename U>
+  GT_INLINE auto operator()(T a, U b) const
+  {
+    return a < b ? b : a;
+  }
+  const char* typestr = "maximum";
+};
+
+} // namespace funcs
+
+template <typename E1, typename E2,
+          typename Enable = std::enable_if_t<has_expression<E1, E2>::value>>
+auto minimum(E1&& e1, E2&& e2)
+{
+  return function(funcs::minimum{}, std::forward<E1>(e1), std::forward<E2>(e2));
+}
+
+template <typename E1, typename E2,
+          typename Enable = std::enable_if_t<has_expression<E1, E2>::value>>
+auto maximum(E1&& e1, E2&& e2)
+{
+  return function(funcs::maximum{}, std::forward<E1>(e1), std::forward<E2>(e2));
+}
+
 // ======================================================================
 // gfunction::typestr
 
@@ -523,6 +666,265 @@ inline std::string gfunction<F, E1, gt_empty_expr>::typestr() const&
   return s.str();
 }
 
+// ======================================================================
+// gfunction_ternary
+//
+// function of three expressions, used for where / select
+
+template <typename F, typename E1, typename E2, typename E3>
+class gfunction_ternary;
+
+template <typename F, typename E1, typename E2, typename E3>
+struct gtensor_inner_types<gfunction_ternary<F, E1, E2, E3>>
+{
+  using space_type =
+    space_t<expr_space_type<E1>, expr_space_type<E2>, expr_space_type<E3>>;
+  constexpr static size_type dimension =
+    helper::calc_dimension<E1, E2, E3>();
+
+  using value_type = decltype(std::declval<F>()(
+    std::declval<expr_value_type<E1>>(), std::declval<expr_value_type<E2>>(),
+    std::declval<expr_value_type<E3>>()));
+  using reference = value_type;
+  using const_reference = value_type;
+};
+
+template <typename F, typename E1, typename E2, typename E3>
+class gfunction_ternary : public expression<gfunction_ternary<F, E1, E2, E3>>
+{
+public:
+  using self_type = gfunction_ternary<F, E1, E2, E3>;
+  using base_type = expression<self_type>;
+  using inner_types = gtensor_inner_types<self_type>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  // Note: important for const correctness. See gview for explanation.
+  using const_kernel_type =
+    gfunction_ternary<F, to_kernel_t<std::add_const_t<E1>>,
+                      to_kernel_t<std::add_const_t<E2>>,
+                      to_kernel_t<std::add_const_t<E3>>>;
+  using kernel_type = const_kernel_type;
+
+  constexpr static size_type dimension() { return inner_types::dimension; };
+
+  using shape_type = gt::shape_type<dimension()>;
+
+  gfunction_ternary(F&& f, E1&& e1, E2&& e2, E3&& e3)
+    : f_(std::forward<F>(f)),
+      e1_(std::forward<E1>(e1)),
+      e2_(std::forward<E2>(e2)),
+      e3_(std::forward<E3>(e3))
+  {
+    // force shape check on host
+    shape();
+  }
+
+  GT_INLINE shape_type shape() const
+  {
+    shape_type shape;
+    calc_shape(shape, e1_, e2_, e3_);
+    return shape;
+  }
+  GT_INLINE index_t shape(int i) const { return shape()[i]; }
+  GT_INLINE size_type size() const { return calc_size(shape()); }
+
+  template <typename... Args>
+  GT_INLINE value_type operator()(Args... args) const
+  {
+    return f_(e1_(args...), e2_(args...), e3_(args...));
+  }
+
+  GT_INLINE auto cursor() const
+  {
+    return make_function_cursor(f_, gt::cursor(e1_), gt::cursor(e2_),
+                                gt::cursor(e3_));
+  }
+
+  const_kernel_type to_kernel() const;
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "fn:" << detail::fnstr<F>::str(f_) << "(" << e1_.typestr() << ", "
+      << e2_.typestr() << ", " << e3_.typestr() << ")";
+    return s.str();
+  }
+
+  void wait_write(gt::stream_view stream) const
+  {
+    detail::wait_write(e1_, stream);
+    detail::wait_write(e2_, stream);
+    detail::wait_write(e3_, stream);
+  }
+
+private:
+  F f_;
+  E1 e1_;
+  E2 e2_;
+  E3 e3_;
+};
+
+template <typename F, typename E1, typename E2, typename E3>
+auto function(F&& f, E1&& e1, E2&& e2, E3&& e3)
+{
+  return gfunction_ternary<F, to_expression_t<E1>, to_expression_t<E2>,
+                           to_expression_t<E3>>(
+    std::forward<F>(f), std::forward<E1>(e1), std::forward<E2>(e2),
+    std::forward<E3>(e3));
+}
+
+template <typename F, typename E1, typename E2, typename E3>
+inline auto gfunction_ternary<F, E1, E2, E3>::to_kernel() const
+  -> const_kernel_type
+{
+  return function(F(f_), e1_.to_kernel(), e2_.to_kernel(), e3_.to_kernel());
+}
+
+// ======================================================================
+// element-wise equality and logical ops
+
+namespace funcs
+{
+
+struct equal
+{
+  template <typename T, typename U>
+  GT_INLINE bool operator()(T a, U b) const
+  {
+    return a == b;
+  }
+  const char* typestr = "equal";
+};
+
+struct not_equal
+{
+  template <typename T, typename U>
+  GT_INLINE bool operator()(T a, U b) const
+  {
+    return a != b;
+  }
+  const char* typestr = "not_equal";
+};
+
+struct logical_and
+{
+  template <typename T, typename U>
+  GT_INLINE bool operator()(T a, U b) const
+  {
+    return bool(a) & bool(b);
+  }
+  const char* typestr = "logical_and";
+};
+
+struct logical_or
+{
+  template <typename T, typename U>
+  GT_INLINE bool operator()(T a, U b) const
+  {
+    return bool(a) | bool(b);
+  }
+  const char* typestr = "logical_or";
+};
+
+struct logical_not
+{
+  template <typename T>
+  GT_INLINE bool operator()(T a) const
+  {
+    return !bool(a);
+  }
+  const char* typestr = "logical_not";
+};
+
+} // namespace funcs
+
+template <typename E1, typename E2,
+          typename Enable = std::enable_if_t<has_expression<E1, E2>::value>>
+auto equal(E1&& e1, E2&& e2)
+{
+  return function(funcs::equal{}, std::forward<E1>(e1), std::forward<E2>(e2));
+}
+
+template <typename E1, typename E2,
+          typename Enable = std::enable_if_t<has_expression<E1, E2>::value>>
+auto not_equal(E1&& e1, E2&& e2)
+{
+  return function(funcs::not_equal{}, std::forward<E1>(e1),
+                  std::forward<E2>(e2));
+}
+
+template <typename E1, typename E2,
+          typename Enable = std::enable_if_t<has_expression<E1, E2>::value>>
+auto logical_and(E1&& e1, E2&& e2)
+{
+  return function(funcs::logical_and{}, std::forward<E1>(e1),
+                  std::forward<E2>(e2));
+}
+
+template <typename E1, typename E2,
+          typename Enable = std::enable_if_t<has_expression<E1, E2>::value>>
+auto logical_or(E1&& e1, E2&& e2)
+{
+  return function(funcs::logical_or{}, std::forward<E1>(e1),
+                  std::forward<E2>(e2));
+}
+
+template <typename E,
+          typename Enable = std::enable_if_t<has_expression<E>::value>>
+auto logical_not(E&& e)
+{
+  return function(funcs::logical_not{}, std::forward<E>(e));
+}
+
+// ======================================================================
+// where
+//
+// element-wise cond ? a : b. Both a and b are evaluated for every element,
+// so this is a select (blend / predicated move) rather than a branch.
+
+namespace funcs
+{
+
+struct where
+{
+  template <typename C, typename T, typename U>
+  GT_INLINE auto operator()(C cond, T a, U b) const
+  {
+    return bool(cond) ? a : b;
+  }
+  const char* typestr = "where";
+};
+
+} // namespace funcs
+
+template <typename EC, typename E1, typename E2,
+          typename Enable =
+            std::enable_if_t<has_expression<EC, E1, E2>::value>>
+auto where(EC&& cond, E1&& e1, E2&& e2)
+{
+  return function(funcs::where{}, std::forward<EC>(cond), std::forward<E1>(e1),
+                  std::forward<E2>(e2));
+}
+
 // ======================================================================
 // ggenerator
 
@@ -538,7 +940,7 @@ public:
   ggenerator(const shape_type& shape, const F& f) : shape_(shape), f_(f) {}
 
   GT_INLINE shape_type shape() const { return shape_; }
-  GT_INLINE int shape(int i) const { return shape_[i]; }
+  GT_INLINE index_t shape(int i) const { return shape_[i]; }
   GT_INLINE size_type size() const { return calc_size(shape()); }
 
   template <typename... Args>
@@ -4,6 +4,7 @@
 
 #include <sstream>
 
+#include "cursor.h"
 #include "expression.h"
 #include "sarray.h"
 
@@ -30,6 +31,8 @@ public:
     return value_;
   }
 
+  GT_INLINE scalar_cursor<value_type> cursor() const { return value_; }
+
   gscalar<value_type> to_kernel() const { return gscalar<value_type>(value_); }
 
   inline std::string typestr() const&
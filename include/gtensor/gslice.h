@@ -4,6 +4,8 @@
 
 #include <limits>
 
+#include "defs.h"
+
 namespace gt
 {
 
@@ -20,22 +22,23 @@ constexpr gnone none;
 
 struct gslice
 {
-  static const int none = std::numeric_limits<int>::min();
+  static const index_t none = std::numeric_limits<index_t>::min();
 
   gslice() = default;
-  gslice(int start, int stop, int step) : start(start), stop(stop), step(step)
+  gslice(index_t start, index_t stop, index_t step)
+    : start(start), stop(stop), step(step)
   {}
-  gslice(int start, int stop, gnone) : start(start), stop(stop) {}
-  gslice(int start, gnone, int step) : start(start), step(step) {}
-  gslice(gnone, int stop, int step) : stop(stop), step(step) {}
-  gslice(int start, gnone, gnone) : start(start) {}
-  gslice(gnone, int stop, gnone) : stop(stop) {}
-  gslice(gnone, gnone, int step) : step(step) {}
+  gslice(index_t start, index_t stop, gnone) : start(start), stop(stop) {}
+  gslice(index_t start, gnone, index_t step) : start(start), step(step) {}
+  gslice(gnone, index_t stop, index_t step) : stop(stop), step(step) {}
+  gslice(index_t start, gnone, gnone) : start(start) {}
+  gslice(gnone, index_t stop, gnone) : stop(stop) {}
+  gslice(gnone, gnone, index_t step) : step(step) {}
   gslice(gnone, gnone, gnone) {}
 
-  int start = none;
-  int stop = none;
-  int step = none;
+  index_t start = none;
+  index_t stop = none;
+  index_t step = none;
 };
 
 // ======================================================================
@@ -81,12 +84,12 @@ public:
   };
 
   gdesc(gnewaxis) : type_(NEWAXIS) {}
-  gdesc(int value) : type_(VALUE), value_(value) {}
+  gdesc(index_t value) : type_(VALUE), value_(value) {}
   gdesc(const gslice& slice) : type_(SLICE), slice_(slice) {}
 
   Type type() const { return type_; }
 
-  int value() const
+  index_t value() const
   {
     assert(type_ == VALUE);
     return value_;
@@ -102,7 +105,7 @@ private:
   enum Type type_;
   union
   {
-    int value_;
+    index_t value_;
     gslice slice_;
   };
 };
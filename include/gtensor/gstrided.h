@@ -4,6 +4,7 @@
 
 #include <cstddef>
 
+#include "cursor.h"
 #include "defs.h"
 #include "expression.h"
 #include "gslice.h"
@@ -16,7 +17,7 @@ template <typename E, typename... Args>
 constexpr int view_dimension()
 {
   constexpr std::size_t N_new = detail::count_convertible<gnewaxis, Args...>();
-  constexpr std::size_t N_value = detail::count_convertible<int, Args...>();
+  constexpr std::size_t N_value = detail::count_convertible<index_t, Args...>();
   constexpr std::size_t N_expr = expr_dimension<E>();
   constexpr std::size_t N_args = sizeof...(Args);
   static_assert(N_args <= N_expr + N_new, "too many view args for expression");
@@ -55,11 +56,16 @@ public:
   gstrided() = default;
   GT_INLINE gstrided(const shape_type& shape, const strides_type& strides);
 
-  GT_INLINE int shape(int i) const;
+  GT_INLINE index_t shape(int i) const;
   GT_INLINE const shape_type& shape() const;
   GT_INLINE const strides_type& strides() const;
   GT_INLINE size_type size() const;
 
+  // see cursor.h; derived classes with plain storage override these with
+  // pointer cursors
+  GT_INLINE auto cursor() const;
+  GT_INLINE auto cursor();
+
   template <typename... Args>
   inline auto view(Args&&... args) &;
   template <typename... Args>
@@ -85,7 +91,7 @@ GT_INLINE gstrided<D>::gstrided(const shape_type& shape,
 {}
 
 template <typename D>
-GT_INLINE int gstrided<D>::shape(int i) const
+GT_INLINE index_t gstrided<D>::shape(int i) const
 {
   return shape_[i];
 }
@@ -108,6 +114,18 @@ GT_INLINE size_type gstrided<D>::size() const
   return calc_size(shape());
 }
 
+template <typename D>
+GT_INLINE auto gstrided<D>::cursor() const
+{
+  return strided_cursor<const D, dimension()>(derived(), strides_);
+}
+
+template <typename D>
+GT_INLINE auto gstrided<D>::cursor()
+{
+  return strided_cursor<D, dimension()>(derived(), strides_);
+}
+
 template <typename D>
 template <typename... Args>
 inline auto gstrided<D>::view(Args&&... args) const&
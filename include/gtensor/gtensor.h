@@ -2,8 +2,12 @@
 #ifndef GTENSOR_GTENSOR_H
 #define GTENSOR_GTENSOR_H
 
+#include <algorithm>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "defs.h"
 #include "device_backend.h"
@@ -18,6 +22,7 @@
 #include "helper.h"
 #include "operator.h"
 #include "space.h"
+#include "stensor.h"
 
 namespace gt
 {
@@ -83,6 +88,13 @@ public:
 
   bool is_f_contiguous() const;
 
+  // last-writer tracking, see "write tracking" below
+  void track_writes(bool enable = true);
+  bool is_tracking_writes() const;
+  void record_write(gt::stream_view stream);
+  void wait_write(gt::stream_view stream) const;
+  void synchronize_write() const;
+
 private:
   GT_INLINE const storage_type& storage_impl() const;
   GT_INLINE storage_type& storage_impl();
@@ -90,6 +102,8 @@ private:
   GT_INLINE reference data_access_impl(size_type i);
 
   storage_type storage_;
+  bool track_writes_ = false;
+  std::shared_ptr<gt::event> last_write_;
 
   friend class gstrided<self_type>;
   friend class gcontainer<self_type>;
@@ -203,6 +217,70 @@ inline bool gtensor_container<T, N>::is_f_contiguous() const
   return true;
 }
 
+// ======================================================================
+// write tracking
+//
+// A container with write tracking enabled remembers an event recorded after
+// the last gt::assign / gt::copy_async into it. Work reading it on another
+// stream, or the host, can then wait for just that work rather than the
+// whole device:
+//
+//   a.track_writes();
+//   gt::assign(a, ..., stream1);
+//   gt::assign(b, 2. * a, stream2); // stream2 waits for the write of a
+//   a.synchronize_write();          // host waits for the write of a
+//
+// gt::assign, gt::copy and gt::copy_async wait for / record the writers of
+// containers passed to them, including through views: reads through views
+// and expressions wait for the last write, writes through views record it.
+// Spans and gt::adapt() do not track, and work submitted by other means
+// (gt::launch, BLAS, ...) needs explicit wait_write() / record_write() calls.
+// Without tracking, these calls do nothing.
+
+template <typename T, size_type N>
+inline void gtensor_container<T, N>::track_writes(bool enable)
+{
+  track_writes_ = enable;
+  if (!enable) {
+    last_write_.reset();
+  }
+}
+
+template <typename T, size_type N>
+inline bool gtensor_container<T, N>::is_tracking_writes() const
+{
+  return track_writes_;
+}
+
+template <typename T, size_type N>
+inline void gtensor_container<T, N>::record_write(gt::stream_view stream)
+{
+  if (!track_writes_) {
+    return;
+  }
+  // copies of a container share the event until one of them is written
+  if (!last_write_ || last_write_.use_count() > 1) {
+    last_write_ = std::make_shared<gt::event>();
+  }
+  last_write_->record(stream);
+}
+
+template <typename T, size_type N>
+inline void gtensor_container<T, N>::wait_write(gt::stream_view stream) const
+{
+  if (last_write_) {
+    stream.wait(*last_write_);
+  }
+}
+
+template <typename T, size_type N>
+inline void gtensor_container<T, N>::synchronize_write() const
+{
+  if (last_write_) {
+    last_write_->synchronize();
+  }
+}
+
 // ======================================================================
 // launch
 
@@ -295,11 +373,12 @@ __global__ void kernel_launch(gt::shape_type<6> shape, F f)
 
 #else // not GTENSOR_PER_DIM_KERNELS
 
-template <typename F, size_type N>
-__global__ void kernel_launch_N(F f, size_type size, gt::shape_type<N> strides)
+template <typename F, size_type N, typename I>
+__global__ void kernel_launch_N(F f, I size, gt::sarray<I, N> strides)
 {
   // workaround ROCm 5.2.0 compiler bug
-  size_type i = threadIdx.x + static_cast<size_type>(blockIdx.x) * blockDim.x;
+  I i = static_cast<I>(threadIdx.x) +
+        static_cast<I>(blockIdx.x) * static_cast<I>(blockDim.x);
 
   if (i < size) {
     auto idx = unravel(i, strides);
@@ -316,15 +395,30 @@ namespace detail
 template <int N, typename Sp>
 struct launch;
 
+// runs loop(f) inline on the default stream, where f can be used in place,
+// and otherwise queues a task owning f
+template <typename F, typename Loop>
+inline void host_launch(gt::stream_view stream, F&& f, const Loop& loop)
+{
+  if (stream.is_default()) {
+    loop(f);
+  } else {
+    gt::backend::host::enqueue(
+      stream, [loop, f = std::forward<F>(f)]() mutable { loop(f); });
+  }
+}
+
 template <>
 struct launch<1, space::host>
 {
   template <typename F>
   static void run(const gt::shape_type<1>& shape, F&& f, gt::stream_view stream)
   {
-    for (int i = 0; i < shape[0]; i++) {
-      std::forward<F>(f)(i);
-    }
+    host_launch(stream, std::forward<F>(f), [shape](auto& body) {
+      for (index_t i = 0; i < shape[0]; i++) {
+        body(i);
+      }
+    });
   }
 };
 
@@ -334,11 +428,13 @@ struct launch<2, space::host>
   template <typename F>
   static void run(const gt::shape_type<2>& shape, F&& f, gt::stream_view stream)
   {
-    for (int j = 0; j < shape[1]; j++) {
-      for (int i = 0; i < shape[0]; i++) {
-        std::forward<F>(f)(i, j);
+    host_launch(stream, std::forward<F>(f), [shape](auto& body) {
+      for (index_t j = 0; j < shape[1]; j++) {
+        for (index_t i = 0; i < shape[0]; i++) {
+          body(i, j);
+        }
       }
-    }
+    });
   }
 };
 
@@ -348,13 +444,15 @@ struct launch<3, space::host>
   template <typename F>
   static void run(const gt::shape_type<3>& shape, F&& f, gt::stream_view stream)
   {
-    for (int k = 0; k < shape[2]; k++) {
-      for (int j = 0; j < shape[1]; j++) {
-        for (int i = 0; i < shape[0]; i++) {
-          std::forward<F>(f)(i, j, k);
+    host_launch(stream, std::forward<F>(f), [shape](auto& body) {
+      for (index_t k = 0; k < shape[2]; k++) {
+        for (index_t j = 0; j < shape[1]; j++) {
+          for (index_t i = 0; i < shape[0]; i++) {
+            body(i, j, k);
+          }
         }
       }
-    }
+    });
   }
 };
 
@@ -364,15 +462,17 @@ struct launch<4, space::host>
   template <typename F>
   static void run(const gt::shape_type<4>& shape, F&& f, gt::stream_view stream)
   {
-    for (int l = 0; l < shape[3]; l++) {
-      for (int k = 0; k < shape[2]; k++) {
-        for (int j = 0; j < shape[1]; j++) {
-          for (int i = 0; i < shape[0]; i++) {
-            std::forward<F>(f)(i, j, k, l);
+    host_launch(stream, std::forward<F>(f), [shape](auto& body) {
+      for (index_t l = 0; l < shape[3]; l++) {
+        for (index_t k = 0; k < shape[2]; k++) {
+          for (index_t j = 0; j < shape[1]; j++) {
+            for (index_t i = 0; i < shape[0]; i++) {
+              body(i, j, k, l);
+            }
           }
         }
       }
-    }
+    });
   }
 };
 
@@ -382,17 +482,19 @@ struct launch<5, space::host>
   template <typename F>
   static void run(const gt::shape_type<5>& shape, F&& f, gt::stream_view stream)
   {
-    for (int m = 0; m < shape[4]; m++) {
-      for (int l = 0; l < shape[3]; l++) {
-        for (int k = 0; k < shape[2]; k++) {
-          for (int j = 0; j < shape[1]; j++) {
-            for (int i = 0; i < shape[0]; i++) {
-              std::forward<F>(f)(i, j, k, l, m);
+    host_launch(stream, std::forward<F>(f), [shape](auto& body) {
+      for (index_t m = 0; m < shape[4]; m++) {
+        for (index_t l = 0; l < shape[3]; l++) {
+          for (index_t k = 0; k < shape[2]; k++) {
+            for (index_t j = 0; j < shape[1]; j++) {
+              for (index_t i = 0; i < shape[0]; i++) {
+                body(i, j, k, l, m);
+              }
             }
           }
         }
       }
-    }
+    });
   }
 };
 
@@ -402,19 +504,21 @@ struct launch<6, space::host>
   template <typename F>
   static void run(const gt::shape_type<6>& shape, F&& f, gt::stream_view stream)
   {
-    for (int n = 0; n < shape[5]; n++) {
-      for (int m = 0; m < shape[4]; m++) {
-        for (int l = 0; l < shape[3]; l++) {
-          for (int k = 0; k < shape[2]; k++) {
-            for (int j = 0; j < shape[1]; j++) {
-              for (int i = 0; i < shape[0]; i++) {
-                std::forward<F>(f)(i, j, k, l, m, n);
+    host_launch(stream, std::forward<F>(f), [shape](auto& body) {
+      for (index_t n = 0; n < shape[5]; n++) {
+        for (index_t m = 0; m < shape[4]; m++) {
+          for (index_t l = 0; l < shape[3]; l++) {
+            for (index_t k = 0; k < shape[2]; k++) {
+              for (index_t j = 0; j < shape[1]; j++) {
+                for (index_t i = 0; i < shape[0]; i++) {
+                  body(i, j, k, l, m, n);
+                }
               }
             }
           }
         }
       }
-    }
+    });
   }
 };
 
@@ -528,7 +632,6 @@ struct launch<N, space::device>
   static void run(const gt::shape_type<N>& shape, F&& f, gt::stream_view stream)
   {
     auto size = calc_size(shape);
-    auto strides = calc_strides(shape);
     unsigned int block_size = BS_LINEAR;
     if (block_size > size) {
       block_size = static_cast<unsigned int>(size);
@@ -538,9 +641,18 @@ struct launch<N, space::device>
     dim3 numBlocks(gt::div_ceil(size, block_size));
 
     gpuSyncIfEnabledStream(stream);
-    gtLaunchKernel(kernel_launch_N, numBlocks, numThreads, 0,
-                   stream.get_backend_stream(), std::forward<F>(f), size,
-                   strides);
+    if (fits_index_32(size, block_size)) {
+      sarray<int, N> strides = calc_strides(sarray<int, N>(shape));
+      gtLaunchKernel(kernel_launch_N, numBlocks, numThreads, 0,
+                     stream.get_backend_stream(), std::forward<F>(f),
+                     static_cast<int>(size), strides);
+    } else {
+      sarray<std::int64_t, N> strides =
+        calc_strides(sarray<std::int64_t, N>(shape));
+      gtLaunchKernel(kernel_launch_N, numBlocks, numThreads, 0,
+                     stream.get_backend_stream(), std::forward<F>(f),
+                     static_cast<std::int64_t>(size), strides);
+    }
     gpuSyncIfEnabledStream(stream);
   }
 };
@@ -689,7 +801,7 @@ inline auto empty(const gt::shape_type<N> shape)
 }
 
 template <typename T, typename S = gt::space::host, size_type N>
-inline auto empty(const int (&shape)[N])
+inline auto empty(const index_t (&shape)[N])
 {
   return gtensor<T, N, S>(gt::shape_type<N>(shape));
 }
@@ -701,7 +813,7 @@ inline auto empty_device(const gt::shape_type<N> shape)
 }
 
 template <typename T, size_type N>
-inline auto empty_device(const int (&shape)[N])
+inline auto empty_device(const index_t (&shape)[N])
 {
   return gtensor<T, N, gt::space::device>(gt::shape_type<N>(shape));
 }
@@ -716,7 +828,7 @@ inline auto full(const gt::shape_type<N> shape, T fill_value)
 }
 
 template <typename T, typename S = gt::space::host, size_type N>
-inline auto full(const int (&shape)[N], T fill_value)
+inline auto full(const index_t (&shape)[N], T fill_value)
 {
   return gtensor<T, N, S>(gt::shape_type<N>(shape), fill_value);
 }
@@ -728,7 +840,7 @@ inline auto full_device(const gt::shape_type<N> shape, T fill_value)
 }
 
 template <typename T, size_type N>
-inline auto full_device(const int (&shape)[N], T fill_value)
+inline auto full_device(const index_t (&shape)[N], T fill_value)
 {
   return gtensor<T, N, gt::space::device>(gt::shape_type<N>(shape), fill_value);
 }
@@ -743,7 +855,7 @@ inline auto zeros(const gt::shape_type<N> shape)
 }
 
 template <typename T, typename S = gt::space::host, size_type N>
-inline auto zeros(const int (&shape)[N])
+inline auto zeros(const index_t (&shape)[N])
 {
   return gtensor<T, N, S>(gt::shape_type<N>(shape), 0);
 }
@@ -755,7 +867,7 @@ inline auto zeros_device(const gt::shape_type<N> shape)
 }
 
 template <typename T, size_type N>
-inline auto zeros_device(const int (&shape)[N])
+inline auto zeros_device(const index_t (&shape)[N])
 {
   return gtensor<T, N, gt::space::device>(gt::shape_type<N>(shape), 0);
 }
@@ -813,6 +925,20 @@ eval(E&& e)
   return {std::forward<E>(e)};
 }
 
+// ======================================================================
+// assign_masked
+//
+// lhs = where(mask, rhs, lhs), i.e. only elements where mask is true are
+// changed. Implemented as a select over the whole lhs, so there is no
+// branching in the generated kernel / host loop.
+
+template <typename E1, typename EM, typename E2>
+inline void assign_masked(E1&& lhs, const EM& mask, const E2& rhs,
+                          gt::stream_view stream = gt::stream_view())
+{
+  gt::assign(lhs, gt::where(mask, rhs, lhs), stream);
+}
+
 // ======================================================================
 // has_data_and_size
 
@@ -827,14 +953,216 @@ struct has_data_and_size<E,
   : std::true_type
 {};
 
+// ======================================================================
+// strided copies
+//
+// Containers, spans and views of either address their elements through a base
+// pointer plus strides (they have a pointer_cursor). Copies between two such
+// objects avoid temporaries: extent 1 dimensions are dropped, dimensions that
+// are contiguous on both sides are merged, and if the fastest remaining
+// dimension has unit stride on both sides the copy is done as pitched 2d
+// copies, one per index of the dimensions beyond the second. Otherwise the
+// side without unit stride is packed into / unpacked from a temporary that
+// is the size of the copied region, not of the underlying array.
+
+namespace detail
+{
+
+template <typename C>
+struct is_pointer_cursor : std::false_type
+{};
+
+template <typename P, size_type N>
+struct is_pointer_cursor<pointer_cursor<P, N>> : std::true_type
+{};
+
+template <typename E>
+using has_strided_storage = is_pointer_cursor<
+  decltype(gt::cursor(std::declval<std::remove_reference_t<E>&>()))>;
+
+template <typename E>
+using strided_storage_pointer =
+  decltype(gt::cursor(std::declval<std::remove_reference_t<E>&>()).data());
+
+template <typename SRC, typename DST, typename Enable = void>
+struct is_strided_copy : std::false_type
+{};
+
+template <typename SRC, typename DST>
+struct is_strided_copy<
+  SRC, DST,
+  std::enable_if_t<has_strided_storage<const SRC>::value &&
+                   has_strided_storage<DST>::value &&
+                   expr_dimension<SRC>() == expr_dimension<DST>()>>
+  : is_allowed_element_type_conversion<
+      typename pointer_traits<strided_storage_pointer<DST>>::element_type,
+      typename pointer_traits<
+        strided_storage_pointer<const SRC>>::element_type>
+{};
+
+template <size_type N>
+struct strided_copy_layout
+{
+  int dim = 0;
+  index_t shape[N + 1] = {};
+  index_t src_strides[N + 1] = {};
+  index_t dst_strides[N + 1] = {};
+
+  // rows of shape[0] elements can be copied as a pitched 2d copy
+  bool is_pitched() const
+  {
+    return dim == 0 || (src_strides[0] == 1 && dst_strides[0] == 1);
+  }
+
+  // number of dimensions handled by a single 2d copy
+  int pitched_dim() const
+  {
+    if (N >= 2 && dim >= 2 && src_strides[1] >= shape[0] &&
+        dst_strides[1] >= shape[0]) {
+      return 2;
+    }
+    return std::min(dim, 1);
+  }
+};
+
+template <size_type N, typename S1, typename S2, typename S3>
+inline strided_copy_layout<N> make_strided_copy_layout(
+  const S1& shape, const S2& src_strides, const S3& dst_strides)
+{
+  strided_copy_layout<N> l{};
+  for (size_type d = 0; d < N; d++) {
+    if (shape[d] == 1) {
+      continue;
+    }
+    if (l.dim > 0) {
+      int k = l.dim - 1;
+      if (src_strides[d] == l.src_strides[k] * l.shape[k] &&
+          dst_strides[d] == l.dst_strides[k] * l.shape[k]) {
+        l.shape[k] *= shape[d];
+        continue;
+      }
+    }
+    l.shape[l.dim] = shape[d];
+    l.src_strides[l.dim] = src_strides[d];
+    l.dst_strides[l.dim] = dst_strides[d];
+    l.dim++;
+  }
+  return l;
+}
+
+// calls copy(in, in_pitch, out, out_pitch, width, height) for each index of
+// the dimensions not covered by a single pitched copy
+template <size_type N, typename InputPtr, typename OutputPtr, typename F>
+inline void strided_copy_pitched(const strided_copy_layout<N>& l, InputPtr in,
+                                 OutputPtr out, F&& copy)
+{
+  int pd = l.pitched_dim();
+  size_type width = pd > 0 ? l.shape[0] : 1;
+  size_type height = pd > 1 ? l.shape[1] : 1;
+  size_type in_pitch = pd > 1 ? l.src_strides[1] : width;
+  size_type out_pitch = pd > 1 ? l.dst_strides[1] : width;
+
+  size_type n_outer = 1;
+  for (int d = pd; d < l.dim; d++) {
+    n_outer *= l.shape[d];
+  }
+
+  for (size_type i = 0; i < n_outer; i++) {
+    index_t in_offset = 0, out_offset = 0;
+    index_t r = i;
+    for (int d = pd; d < l.dim; d++) {
+      index_t idx = r % l.shape[d];
+      r /= l.shape[d];
+      in_offset += idx * l.src_strides[d];
+      out_offset += idx * l.dst_strides[d];
+    }
+    copy(in + in_offset, in_pitch, out + out_offset, out_pitch, width, height);
+  }
+}
+
+template <size_type N, typename S1, typename S2>
+inline bool is_contiguous_layout(const S1& shape, const S2& strides)
+{
+  auto l = make_strided_copy_layout<N>(shape, strides, strides);
+  return l.dim == 0 || (l.dim == 1 && l.src_strides[0] == 1);
+}
+
+// Like the other copies, arrays of different shapes but the same size can be
+// copied if both are contiguous, as a flat copy. Other shape mismatches throw.
+template <typename SRC, typename DST>
+inline auto strided_copy_layout_for(const SRC& src, DST& dst)
+{
+  constexpr size_type N = expr_dimension<SRC>();
+  auto src_strides = gt::cursor(src).strides();
+  auto dst_strides = gt::cursor(dst).strides();
+  if (src.shape() == dst.shape()) {
+    return make_strided_copy_layout<N>(src.shape(), src_strides, dst_strides);
+  }
+  if (src.size() == dst.size() &&
+      is_contiguous_layout<N>(src.shape(), src_strides) &&
+      is_contiguous_layout<N>(dst.shape(), dst_strides)) {
+    strided_copy_layout<N> l{};
+    if (src.size() > 0) {
+      l.dim = 1;
+      l.shape[0] = src.size();
+      l.src_strides[0] = 1;
+      l.dst_strides[0] = 1;
+    }
+    return l;
+  }
+  throw std::runtime_error("cannot copy " + to_string(src.shape()) +
+                           " to " + to_string(dst.shape()));
+}
+
+// pack / unpack copies, defined after gt::copy below
+template <typename SRC, typename DST>
+inline void copy_packed(const SRC& src, DST& dst, bool, std::true_type);
+
+template <typename SRC, typename DST>
+inline void copy_packed(const SRC& src, DST& dst, bool pack_src,
+                        std::false_type);
+
+template <typename SRC, typename DST>
+using is_same_space =
+  std::is_same<expr_space_type<SRC>, expr_space_type<DST>>;
+
+} // namespace detail
+
 // ======================================================================
 // copies
 
 template <typename SRC, typename DST>
-std::enable_if_t<gt::has_data_and_size<SRC>::value &&
+std::enable_if_t<detail::is_strided_copy<SRC, DST>::value> copy(const SRC& src,
+                                                                DST&& dst)
+{
+  detail::synchronize_write(src);
+  detail::synchronize_write(dst);
+  auto layout = detail::strided_copy_layout_for(src, dst);
+  if (layout.is_pitched()) {
+    detail::strided_copy_pitched(
+      layout, gt::cursor(src).data(), gt::cursor(dst).data(),
+      [](auto in, size_type in_pitch, auto out, size_type out_pitch,
+         size_type width, size_type height) {
+        if (height == 1) {
+          gt::copy_n(in, width, out);
+        } else {
+          gt::copy_2d(in, in_pitch, out, out_pitch, width, height);
+        }
+      });
+  } else {
+    detail::copy_packed(src, dst, layout.src_strides[0] != 1,
+                        detail::is_same_space<SRC, DST>{});
+  }
+}
+
+template <typename SRC, typename DST>
+std::enable_if_t<!detail::is_strided_copy<SRC, DST>::value &&
+                 gt::has_data_and_size<SRC>::value &&
                  gt::has_data_and_size<DST>::value>
 copy(const SRC& src, DST&& dst)
 {
+  detail::synchronize_write(src);
+  detail::synchronize_write(dst);
   if (!dst.is_f_contiguous()) {
     auto dst_tmp = gt::empty_like(dst);
     gt::copy(src, dst_tmp);
@@ -852,6 +1180,7 @@ copy(const SRC& src, DST&& dst)
 // if both expressions are in the same space, we can just assign
 template <typename SRC, typename DST>
 std::enable_if_t<
+  !detail::is_strided_copy<SRC, DST>::value &&
   std::is_same<expr_space_type<SRC>, expr_space_type<DST>>::value &&
   !(gt::has_data_and_size<SRC>::value && gt::has_data_and_size<DST>::value)>
 copy(const SRC& src, DST&& dst)
@@ -862,6 +1191,7 @@ copy(const SRC& src, DST&& dst)
 // different spaces, source not storage like, destination is storage-like
 template <typename SRC, typename DST>
 std::enable_if_t<
+  !detail::is_strided_copy<SRC, DST>::value &&
   !std::is_same<expr_space_type<SRC>, expr_space_type<DST>>::value &&
   (!gt::has_data_and_size<SRC>::value && gt::has_data_and_size<DST>::value)>
 copy(const SRC& src, DST&& dst)
@@ -872,6 +1202,7 @@ copy(const SRC& src, DST&& dst)
 // different spaces, destination is not storage-like
 template <typename SRC, typename DST>
 std::enable_if_t<
+  !detail::is_strided_copy<SRC, DST>::value &&
   !std::is_same<expr_space_type<SRC>, expr_space_type<DST>>::value &&
   !gt::has_data_and_size<DST>::value>
 copy(const SRC& src, DST&& dst)
@@ -881,6 +1212,217 @@ copy(const SRC& src, DST&& dst)
   dst = dst_tmp;
 }
 
+namespace detail
+{
+
+// same space: scatter / gather with an assignment
+template <typename SRC, typename DST>
+inline void copy_packed(const SRC& src, DST& dst, bool, std::true_type)
+{
+  dst = src;
+}
+
+// different spaces: pack the source, or unpack into the destination
+template <typename SRC, typename DST>
+inline void copy_packed(const SRC& src, DST& dst, bool pack_src,
+                        std::false_type)
+{
+  if (pack_src) {
+    auto src_tmp = gt::eval(src);
+    gt::copy(src_tmp, dst);
+  } else {
+    auto dst_tmp = gt::empty_like(dst);
+    gt::copy(src, dst_tmp);
+    dst = dst_tmp;
+  }
+}
+
+} // namespace detail
+
+// ======================================================================
+// copy_async
+//
+// Stream ordered copy: the copy is enqueued on `stream` after previously
+// submitted work, and the returned event completes once the copy is done.
+// Copies that map onto (pitched) memory copies, see "strided copies" above,
+// and copies within one space never block the host. Other combinations need
+// a temporary, which is staged synchronously before returning.
+
+namespace detail
+{
+
+// same space: assign on the stream
+template <typename SRC, typename DST>
+inline void copy_async_assign(const SRC& src, DST& dst, gt::stream_view stream,
+                              std::true_type)
+{
+  gt::assign(dst, src, stream);
+}
+
+template <typename SRC, typename DST>
+inline void copy_async_dispatch(const SRC& src, DST& dst,
+                                gt::stream_view stream);
+
+// different spaces: stage through a contiguous temporary, on the stream.
+// The temporary is freed on return, so the stream is synchronized.
+template <typename SRC, typename DST>
+inline void copy_async_stage(const SRC& src, DST& dst, gt::stream_view stream,
+                             std::false_type)
+{
+  using T = std::remove_const_t<expr_value_type<DST>>;
+  constexpr size_type N = expr_dimension<DST>();
+  // copy into a contiguous temporary in the destination space, then scatter
+  gt::gtensor<T, N, expr_space_type<DST>> dst_tmp(dst.shape());
+  copy_async_dispatch(src, dst_tmp, stream);
+  gt::assign(dst, dst_tmp, stream);
+  stream.synchronize();
+}
+
+template <typename SRC, typename DST>
+inline void copy_async_stage(const SRC& src, DST& dst, gt::stream_view stream,
+                             std::true_type)
+{
+  using T = std::remove_const_t<expr_value_type<DST>>;
+  constexpr size_type N = expr_dimension<DST>();
+  if (dst.is_f_contiguous()) {
+    // gather the source in its own space, then one contiguous copy
+    gt::gtensor<T, N, eval_space_t<SRC>> src_tmp(src.shape());
+    gt::assign(src_tmp, src, stream);
+    gt::copy_n_async(src_tmp.data(), src_tmp.size(), dst.data(), stream);
+    stream.synchronize();
+  } else {
+    copy_async_stage(src, dst, stream, std::false_type{});
+  }
+}
+
+template <typename SRC, typename DST>
+inline void copy_async_assign(const SRC& src, DST& dst, gt::stream_view stream,
+                              std::false_type)
+{
+  copy_async_stage(src, dst, stream, gt::has_data_and_size<DST>{});
+}
+
+template <typename SRC, typename DST>
+std::enable_if_t<is_strided_copy<SRC, DST>::value> copy_async(
+  const SRC& src, DST& dst, gt::stream_view stream)
+{
+  auto layout = strided_copy_layout_for(src, dst);
+  if (layout.is_pitched()) {
+    strided_copy_pitched(
+      layout, gt::cursor(src).data(), gt::cursor(dst).data(),
+      [stream](auto in, size_type in_pitch, auto out, size_type out_pitch,
+               size_type width, size_type height) {
+        if (height == 1) {
+          gt::copy_n_async(in, width, out, stream);
+        } else {
+          gt::copy_2d_async(in, in_pitch, out, out_pitch, width, height,
+                            stream);
+        }
+      });
+  } else {
+    copy_async_assign(src, dst, stream, is_same_space<SRC, DST>{});
+  }
+}
+
+template <typename SRC, typename DST>
+std::enable_if_t<!is_strided_copy<SRC, DST>::value &&
+                 gt::has_data_and_size<SRC>::value &&
+                 gt::has_data_and_size<DST>::value>
+copy_async(const SRC& src, DST& dst, gt::stream_view stream)
+{
+  if (src.is_f_contiguous() && dst.is_f_contiguous()) {
+    assert(src.size() == dst.size());
+    gt::copy_n_async(src.data(), src.size(), dst.data(), stream);
+  } else {
+    copy_async_assign(src, dst, stream, is_same_space<SRC, DST>{});
+  }
+}
+
+template <typename SRC, typename DST>
+std::enable_if_t<!is_strided_copy<SRC, DST>::value &&
+                 !(gt::has_data_and_size<SRC>::value &&
+                   gt::has_data_and_size<DST>::value)>
+copy_async(const SRC& src, DST& dst, gt::stream_view stream)
+{
+  copy_async_assign(src, dst, stream, is_same_space<SRC, DST>{});
+}
+
+template <typename SRC, typename DST>
+inline void copy_async_dispatch(const SRC& src, DST& dst,
+                                gt::stream_view stream)
+{
+  copy_async(src, dst, stream);
+}
+
+} // namespace detail
+
+template <typename SRC, typename DST>
+inline gt::event copy_async(const SRC& src, DST&& dst,
+                            gt::stream_view stream = gt::stream_view{})
+{
+  detail::wait_write(src, stream);
+  detail::wait_write(dst, stream);
+  detail::copy_async(src, dst, stream);
+  detail::record_write(dst, stream);
+  gt::event event;
+  event.record(stream);
+  return event;
+}
+
+// ======================================================================
+// prefetch / advise
+//
+// Stream-ordered migration of managed memory ahead of use, and hints on how
+// it will be accessed, for containers, spans and views thereof. For views,
+// the storage range between the first and last element is covered. Memory
+// that is not managed is left alone.
+
+namespace detail
+{
+
+template <typename E>
+inline auto strided_storage_range(E& e)
+{
+  auto c = gt::cursor(e);
+  index_t lo = 0, hi = 0;
+  for (size_type d = 0; d < expr_dimension<E>(); d++) {
+    index_t extent = (e.shape(d) - 1) * c.strides()[d];
+    if (extent < 0) {
+      lo += extent;
+    } else {
+      hi += extent;
+    }
+  }
+  size_type n = e.size() > 0 ? hi - lo + 1 : 0;
+  return std::make_pair(gt::raw_pointer_cast(c.data()) + lo, n);
+}
+
+} // namespace detail
+
+template <typename E>
+inline std::enable_if_t<detail::has_strided_storage<E>::value> prefetch_device(
+  E& e, gt::stream_view stream = gt::stream_view{})
+{
+  auto range = detail::strided_storage_range(e);
+  gt::backend::clib::prefetch_device(range.first, range.second, stream);
+}
+
+template <typename E>
+inline std::enable_if_t<detail::has_strided_storage<E>::value> prefetch_host(
+  E& e, gt::stream_view stream = gt::stream_view{})
+{
+  auto range = detail::strided_storage_range(e);
+  gt::backend::clib::prefetch_host(range.first, range.second, stream);
+}
+
+template <typename E>
+inline std::enable_if_t<detail::has_strided_storage<E>::value> advise(
+  E& e, gt::memory_advice advice)
+{
+  auto range = detail::strided_storage_range(e);
+  gt::backend::clib::advise(range.first, range.second, advice);
+}
+
 // ======================================================================
 // arange
 
@@ -103,6 +103,8 @@ public:
 
   GT_INLINE pointer data() const;
 
+  GT_INLINE auto cursor() const;
+
   template <typename... Args>
   GT_INLINE reference operator()(Args&&... args) const;
 
@@ -189,6 +191,12 @@ GT_INLINE auto gtensor_span<T, N, S>::data() const -> pointer
   return storage_.data();
 }
 
+template <typename T, size_type N, typename S>
+GT_INLINE auto gtensor_span<T, N, S>::cursor() const
+{
+  return pointer_cursor<pointer, N>(data(), this->strides());
+}
+
 template <typename T, size_type N, typename S>
 GT_INLINE auto gtensor_span<T, N, S>::data_access(size_t i) const -> reference
 {
@@ -244,7 +252,8 @@ GT_INLINE auto adapt(T* data, const shape_type<N>& shape)
 template <size_type N, typename T>
 GT_INLINE auto adapt(T* data, const int* shape_data)
 {
-  return adapt<N, gt::space::host, T>(data, {shape_data, N});
+  return adapt<N, gt::space::host, T>(
+    data, shape_type<N>(sarray<int, N>(shape_data, N)));
 }
 
 // device
@@ -257,8 +266,9 @@ GT_INLINE auto adapt_device(T* data, const shape_type<N>& shape)
 template <size_type N, typename T>
 GT_INLINE auto adapt_device(T* data, const int* shape_data)
 {
-  return adapt<N, gt::space::device, T>(gt::device_pointer_cast(data),
-                                        {shape_data, N});
+  return adapt<N, gt::space::device, T>(
+    gt::device_pointer_cast(data),
+    shape_type<N>(sarray<int, N>(shape_data, N)));
 }
 
 // ======================================================================
@@ -215,8 +215,24 @@ public:
   GT_INLINE decltype(auto) data_access(size_type i) const;
   GT_INLINE decltype(auto) data_access(size_type i);
 
+  GT_INLINE auto cursor() const;
+  GT_INLINE auto cursor();
+
   inline std::string typestr() const&;
 
+  // for write tracking, see write_tracking.h
+  void wait_write(gt::stream_view stream) const
+  {
+    detail::wait_write(e_, stream);
+  }
+
+  void record_write(gt::stream_view stream)
+  {
+    detail::record_write(e_, stream);
+  }
+
+  void synchronize_write() const { detail::synchronize_write(e_); }
+
 private:
   EC e_;
   size_type offset_;
@@ -296,6 +312,48 @@ GT_INLINE decltype(auto) gview<EC, N>::data_access(size_t i)
   return e_.data_access(offset_ + i);
 }
 
+namespace detail
+{
+
+// views of containers and spans walk the underlying storage pointer directly,
+// other views go through data_access() of the underlying expression
+
+template <typename E>
+using has_storage_pointer =
+  std::integral_constant<bool, is_gcontainer<E>::value ||
+                                 is_gtensor_span<std::decay_t<E>>::value>;
+
+template <typename V, typename E>
+GT_INLINE auto gview_cursor(V& v, E& e, size_type offset, std::true_type)
+{
+  using pointer = decltype(e.data());
+  return pointer_cursor<pointer, V::dimension()>(e.data() + offset,
+                                                 v.strides());
+}
+
+template <typename V, typename E>
+GT_INLINE auto gview_cursor(V& v, E& /* e */, size_type /* offset */,
+                            std::false_type)
+{
+  return strided_cursor<V, V::dimension()>(v, v.strides());
+}
+
+} // namespace detail
+
+template <typename EC, size_type N>
+GT_INLINE auto gview<EC, N>::cursor() const
+{
+  return detail::gview_cursor(*this, e_, offset_,
+                              detail::has_storage_pointer<EC>{});
+}
+
+template <typename EC, size_type N>
+GT_INLINE auto gview<EC, N>::cursor()
+{
+  return detail::gview_cursor(*this, e_, offset_,
+                              detail::has_storage_pointer<EC>{});
+}
+
 template <typename EC, size_type N>
 inline std::string gview<EC, N>::typestr() const&
 {
@@ -365,9 +423,9 @@ auto view(E&& _e, const std::vector<gdesc>& descs)
       new_i++;
     } else if (descs[i].type() == gdesc::SLICE) {
       auto slice = descs[i].slice();
-      int start = slice.start;
-      int stop = slice.stop;
-      int step = slice.step;
+      index_t start = slice.start;
+      index_t stop = slice.stop;
+      index_t step = slice.step;
       if (step == gslice::none) {
         step = 1;
       }
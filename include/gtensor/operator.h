@@ -150,14 +150,30 @@ struct expression_printer<N, space::device>
 
 #endif
 
+// expressions without a fixed space (e.g. of stensors) evaluate on the host
+template <typename S>
+struct eval_space
+{
+  using type = S;
+};
+
+template <>
+struct eval_space<space::any>
+{
+  using type = space::host;
+};
+
+template <typename E>
+using eval_space_t = typename eval_space<expr_space_type<E>>::type;
+
 } // namespace detail
 
 template <typename E,
           typename Enable = std::enable_if_t<is_expression<E>::value>>
 inline std::ostream& operator<<(std::ostream& os, const E& e)
 {
-  detail::expression_printer<expr_dimension<E>(), expr_space_type<E>>::print_to(
-    os, e);
+  detail::expression_printer<expr_dimension<E>(),
+                             detail::eval_space_t<E>>::print_to(os, e);
   return os;
 }
 
@@ -427,8 +443,10 @@ struct equals<N1, N2, space::host, space::device>
 template <typename E1, typename E2>
 bool operator==(const expression<E1>& e1, const expression<E2>& e2)
 {
-  return detail::equals<E1::dimension(), E2::dimension(), expr_space_type<E1>,
-                        expr_space_type<E2>>::run(e1.derived(), e2.derived());
+  return detail::equals<E1::dimension(), E2::dimension(),
+                        detail::eval_space_t<E1>,
+                        detail::eval_space_t<E2>>::run(e1.derived(),
+                                                       e2.derived());
 }
 
 template <typename E1, typename E2>
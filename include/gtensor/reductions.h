@@ -5,13 +5,21 @@
 
 #if defined(GTENSOR_DEVICE_CUDA) || defined(GTENSOR_DEVICE_HIP)
 #include <thrust/extrema.h>
+#include <thrust/iterator/transform_iterator.h>
 #include <thrust/reduce.h>
 #include <thrust/transform_reduce.h>
 #endif
 
+#if defined(GTENSOR_DEVICE_CUDA)
+#include <cub/device/device_reduce.cuh>
+#elif defined(GTENSOR_DEVICE_HIP)
+#include <rocprim/device/device_reduce.hpp>
+#endif
+
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <type_traits>
 
@@ -20,6 +28,35 @@
 namespace gt
 {
 
+namespace detail
+{
+
+template <typename T>
+struct UnaryOpIdentity
+{
+  GT_INLINE T operator()(T a) const { return a; }
+};
+
+template <typename T>
+struct BinaryOpPlus
+{
+  GT_INLINE T operator()(T a, T b) const { return a + b; }
+};
+
+template <typename T>
+struct BinaryOpMax
+{
+  GT_INLINE T operator()(T a, T b) const { return a < b ? b : a; }
+};
+
+template <typename T>
+struct BinaryOpMin
+{
+  GT_INLINE T operator()(T a, T b) const { return b < a ? b : a; }
+};
+
+} // namespace detail
+
 #if defined(GTENSOR_DEVICE_CUDA) || defined(GTENSOR_DEVICE_HIP)
 
 namespace detail
@@ -239,17 +276,6 @@ inline auto min(const Container& a, gt::stream_view stream = gt::stream_view{})
   return min_buf.get_host_access()[0];
 }
 
-namespace detail
-{
-
-template <typename T>
-struct UnaryOpIdentity
-{
-  GT_INLINE T operator()(T a) const { return a; }
-};
-
-} // namespace detail
-
 template <typename Container, typename OutputType, typename BinaryReductionOp,
           typename = std::enable_if_t<
             has_data_method_v<Container> &&
@@ -300,6 +326,8 @@ template <typename Container,
 inline auto sum(const Container& a, gt::stream_view stream = gt::stream_view{})
 {
   using T = typename Container::value_type;
+  // the result is returned to the caller, so wait for work queued on stream
+  stream.synchronize();
   auto data = a.data();
   // TODO: this assumes type has an initializer from int(0), which should be
   // true for all numeric types encountered in practice, but this is ugly
@@ -318,6 +346,7 @@ template <typename Container,
 inline auto max(const Container& a, gt::stream_view stream = gt::stream_view{})
 {
   using T = typename Container::value_type;
+  stream.synchronize();
   auto data = a.data();
   T max_value = data[0];
   T current_value;
@@ -337,6 +366,7 @@ template <typename Container,
 inline auto min(const Container& a, gt::stream_view stream = gt::stream_view{})
 {
   using T = typename Container::value_type;
+  stream.synchronize();
   auto data = a.data();
   T min_value = data[0];
   T current_value;
@@ -358,6 +388,7 @@ inline OutputType reduce(const Container& a, OutputType init,
                          gt::stream_view stream = gt::stream_view{})
 {
   using P = const typename Container::value_type*;
+  stream.synchronize();
   P begin(a.data());
   P end(a.data() + a.size());
   return std::accumulate(begin, end, init, reduction_op);
@@ -375,6 +406,7 @@ inline OutputType transform_reduce(const Container& a, OutputType init,
                                    gt::stream_view stream = gt::stream_view{})
 {
   using P = const typename Container::value_type*;
+  stream.synchronize();
   P begin(a.data());
   P end(a.data() + a.size());
 #if __cplusplus >= 201703L
@@ -387,6 +419,203 @@ inline OutputType transform_reduce(const Container& a, OutputType init,
 #endif
 }
 
+// ======================================================================
+// asynchronous reductions
+//
+// Like the reductions above, but the result is written to result[0], a
+// container in the same space as the input, in stream order. Nothing is
+// copied back to the host, so the result can feed later kernels on the
+// stream (e.g. a timestep computed from a max) without stalling it. The
+// returned event completes once the result has been written.
+
+#if defined(GTENSOR_DEVICE_CUDA) || defined(GTENSOR_DEVICE_HIP)
+
+namespace detail
+{
+
+// stream ordered device-wide reduction of n elements starting at in, with
+// temporary storage allocated and freed on the stream
+template <typename InputIt, typename T, typename BinaryReductionOp>
+inline void device_reduce_async(InputIt in, T* out, size_type n, T init,
+                                BinaryReductionOp reduction_op,
+                                gt::stream_view stream)
+{
+  auto s = stream.get_backend_stream();
+  void* temp = nullptr;
+  std::size_t temp_bytes = 0;
+#if defined(GTENSOR_DEVICE_CUDA)
+  gtGpuCheck(cub::DeviceReduce::Reduce(temp, temp_bytes, in, out, n,
+                                       reduction_op, init, s));
+  gtGpuCheck(cudaMallocAsync(&temp, temp_bytes, s));
+  gtGpuCheck(cub::DeviceReduce::Reduce(temp, temp_bytes, in, out, n,
+                                       reduction_op, init, s));
+  gtGpuCheck(cudaFreeAsync(temp, s));
+#else
+  gtGpuCheck(
+    rocprim::reduce(temp, temp_bytes, in, out, init, n, reduction_op, s));
+  gtGpuCheck(hipMallocAsync(&temp, temp_bytes, s));
+  gtGpuCheck(
+    rocprim::reduce(temp, temp_bytes, in, out, init, n, reduction_op, s));
+  gtGpuCheck(hipFreeAsync(temp, s));
+#endif
+}
+
+} // namespace detail
+
+template <typename Container, typename Result, typename OutputType,
+          typename BinaryReductionOp, typename UnaryTransformOp,
+          typename = std::enable_if_t<
+            has_data_method_v<Container> &&
+            std::is_same<typename Container::space_type, space::device>::value>>
+inline gt::event transform_reduce_async(
+  const Container& a, Result& result, OutputType init,
+  BinaryReductionOp reduction_op, UnaryTransformOp transform_op,
+  gt::stream_view stream = gt::stream_view{})
+{
+  static_assert(std::is_same<expr_space_type<Result>, space::device>::value,
+                "result must be in the same space as the input");
+  auto in = thrust::make_transform_iterator(gt::raw_pointer_cast(a.data()),
+                                            transform_op);
+  OutputType* out = gt::raw_pointer_cast(result.data());
+  detail::device_reduce_async(in, out, a.size(), init, reduction_op, stream);
+  gt::event event;
+  event.record(stream);
+  return event;
+}
+
+#elif defined(GTENSOR_DEVICE_SYCL)
+
+template <typename Container, typename Result, typename OutputType,
+          typename BinaryReductionOp, typename UnaryTransformOp,
+          typename = std::enable_if_t<
+            has_data_method_v<Container> &&
+            std::is_same<typename Container::space_type, space::device>::value>>
+inline gt::event transform_reduce_async(
+  const Container& a, Result& result, OutputType init,
+  BinaryReductionOp reduction_op, UnaryTransformOp transform_op,
+  gt::stream_view stream = gt::stream_view{})
+{
+  static_assert(std::is_same<expr_space_type<Result>, space::device>::value,
+                "result must be in the same space as the input");
+  sycl::queue& q = stream.get_backend_stream();
+  auto data = gt::raw_pointer_cast(a.data());
+  OutputType* out = gt::raw_pointer_cast(result.data());
+  size_type n = a.size();
+
+  // group algorithms are not supported with the host backend
+  if (gt::backend::sycl::is_host_backend() || n == 0) {
+    q.single_task([=]() {
+      OutputType r = init;
+      for (size_type i = 0; i < n; i++) {
+        r = reduction_op(r, transform_op(data[i]));
+      }
+      *out = r;
+    });
+  } else {
+    // the identity argument of sycl::reduction must be the operator's true
+    // identity, as it seeds every partial result. Reduce without one, then
+    // fold init into the result, in the order the host loop would.
+    q.submit([&](sycl::handler& cgh) {
+      auto reducer =
+        sycl::reduction(out, reduction_op,
+                        sycl::property::reduction::initialize_to_identity{});
+      cgh.parallel_for(sycl::range<1>(n), reducer,
+                       [=](sycl::id<1> idx, auto& r) {
+                         r.combine(transform_op(data[idx]));
+                       });
+    });
+    q.single_task([=]() { *out = reduction_op(init, *out); });
+  }
+  gt::event event;
+  event.record(stream);
+  return event;
+}
+
+#endif // device implementations
+
+namespace detail
+{
+
+// runs f after the work on stream: queued on host streams, inline after
+// synchronizing device streams
+template <typename F>
+inline void host_after(gt::stream_view stream, F&& f)
+{
+#ifdef GTENSOR_HAVE_DEVICE
+  stream.synchronize();
+  std::forward<F>(f)();
+#else
+  stream.enqueue(std::forward<F>(f));
+#endif
+}
+
+} // namespace detail
+
+template <typename Container, typename Result, typename OutputType,
+          typename BinaryReductionOp, typename UnaryTransformOp,
+          typename = std::enable_if_t<
+            has_data_method_v<Container> &&
+            std::is_same<typename Container::space_type, space::host>::value>,
+          typename = int>
+inline gt::event transform_reduce_async(
+  const Container& a, Result& result, OutputType init,
+  BinaryReductionOp reduction_op, UnaryTransformOp transform_op,
+  gt::stream_view stream = gt::stream_view{})
+{
+  static_assert(std::is_same<expr_space_type<Result>, space::host>::value,
+                "result must be in the same space as the input");
+  auto data = a.data();
+  OutputType* out = result.data();
+  size_type n = a.size();
+  detail::host_after(stream, [=]() {
+    OutputType r = init;
+    for (size_type i = 0; i < n; i++) {
+      r = reduction_op(r, transform_op(data[i]));
+    }
+    *out = r;
+  });
+  gt::event event;
+  event.record(stream);
+  return event;
+}
+
+template <typename Container, typename Result, typename OutputType,
+          typename BinaryReductionOp>
+inline gt::event reduce_async(const Container& a, Result& result,
+                              OutputType init, BinaryReductionOp reduction_op,
+                              gt::stream_view stream = gt::stream_view{})
+{
+  using T = typename Container::value_type;
+  return transform_reduce_async(a, result, init, reduction_op,
+                                detail::UnaryOpIdentity<T>{}, stream);
+}
+
+template <typename Container, typename Result>
+inline gt::event sum_async(const Container& a, Result& result,
+                           gt::stream_view stream = gt::stream_view{})
+{
+  using T = typename Container::value_type;
+  return reduce_async(a, result, T(0), detail::BinaryOpPlus<T>{}, stream);
+}
+
+template <typename Container, typename Result>
+inline gt::event max_async(const Container& a, Result& result,
+                           gt::stream_view stream = gt::stream_view{})
+{
+  using T = typename Container::value_type;
+  return reduce_async(a, result, std::numeric_limits<T>::lowest(),
+                      detail::BinaryOpMax<T>{}, stream);
+}
+
+template <typename Container, typename Result>
+inline gt::event min_async(const Container& a, Result& result,
+                           gt::stream_view stream = gt::stream_view{})
+{
+  using T = typename Container::value_type;
+  return reduce_async(a, result, std::numeric_limits<T>::max(),
+                      detail::BinaryOpMin<T>{}, stream);
+}
+
 template <typename Eout, typename Ein>
 inline void sum_axis_to(Eout&& out, Ein&& in, int axis,
                         gt::stream_view stream = gt::stream_view{})
@@ -395,7 +624,6 @@ inline void sum_axis_to(Eout&& out, Ein&& in, int axis,
   using Tout = expr_value_type<Eout>;
   using Sin = expr_space_type<Ein>;
   using Tin = expr_value_type<Ein>;
-  using shape_type = expr_shape_type<Eout>;
 
   static_assert(std::is_same<Sout, Sin>::value,
                 "out and in expressions must be in the same space");
@@ -423,17 +651,17 @@ inline void sum_axis_to(Eout&& out, Ein&& in, int axis,
   auto strides_out = calc_strides(shape_out);
   auto strides_in = calc_strides(shape_in);
 
-  auto flat_out_shape = gt::shape(static_cast<int>(out.size()));
-  int reduction_length = in.shape(axis);
+  auto flat_out_shape = gt::shape(static_cast<index_t>(out.size()));
+  index_t reduction_length = in.shape(axis);
 
   gt::launch<1, Sout>(
     flat_out_shape,
-    GT_LAMBDA(int i) {
+    GT_LAMBDA(index_t i) {
       auto idx_out = unravel(i, strides_out);
-      auto idx_in = insert(idx_out, axis, 0);
+      auto idx_in = insert(idx_out, axis, index_t(0));
       Tin tmp = k_in[idx_in];
       idx_in[axis]++;
-      for (int j = 1; j < reduction_length; j++) {
+      for (index_t j = 1; j < reduction_length; j++) {
         tmp = tmp + k_in[idx_in];
         idx_in[axis]++;
       }
@@ -14,6 +14,7 @@
 #include <cassert>
 #include <cstddef>
 #include <iostream>
+#include <type_traits>
 
 namespace gt
 {
@@ -29,16 +30,22 @@ template <typename T, std::size_t N>
 class sarray
 {
 public:
+  using value_type = T;
   constexpr static std::size_t dimension = N;
 
   sarray() = default;
 
   // construct from exactly N elements provided
   template <typename... U, std::enable_if_t<sizeof...(U) == N, int> = 0>
-  GT_INLINE sarray(U... args);
+  GT_INLINE constexpr sarray(U... args);
   sarray(const T* p, std::size_t n);
   sarray(const T data[N]);
 
+  // convert from an sarray with a different element type, e.g. between
+  // 32-bit and 64-bit shapes
+  template <typename U, std::enable_if_t<!std::is_same<U, T>::value, int> = 0>
+  GT_INLINE sarray(const sarray<U, N>& o);
+
   template <typename O>
   bool operator==(const O& o) const;
   template <typename O>
@@ -49,8 +56,8 @@ public:
   GT_INLINE const T* data() const { return data_; }
   GT_INLINE T* data() { return data_; }
 
-  GT_INLINE const T& operator[](std::size_t i) const;
-  GT_INLINE T& operator[](std::size_t i);
+  GT_INLINE constexpr const T& operator[](std::size_t i) const;
+  GT_INLINE constexpr T& operator[](std::size_t i);
 
   GT_INLINE const T* begin() const;
   GT_INLINE const T* end() const;
@@ -69,6 +76,7 @@ template <typename T>
 class sarray<T, 0>
 {
 public:
+  using value_type = T;
   constexpr static std::size_t dimension = 0;
 
   sarray() = default;
@@ -125,9 +133,18 @@ public:
 
 template <typename T, std::size_t N>
 template <typename... U, std::enable_if_t<sizeof...(U) == N, int>>
-GT_INLINE sarray<T, N>::sarray(U... args) : data_{T(args)...}
+GT_INLINE constexpr sarray<T, N>::sarray(U... args) : data_{T(args)...}
 {}
 
+template <typename T, std::size_t N>
+template <typename U, std::enable_if_t<!std::is_same<U, T>::value, int>>
+GT_INLINE sarray<T, N>::sarray(const sarray<U, N>& o)
+{
+  for (std::size_t i = 0; i < N; i++) {
+    data_[i] = T(o[i]);
+  }
+}
+
 template <typename T, std::size_t N>
 sarray<T, N>::sarray(const T* p, std::size_t n)
 {
@@ -165,12 +182,12 @@ GT_INLINE constexpr std::size_t sarray<T, N>::size()
 }
 
 template <typename T, std::size_t N>
-GT_INLINE const T& sarray<T, N>::operator[](std::size_t i) const
+GT_INLINE constexpr const T& sarray<T, N>::operator[](std::size_t i) const
 {
   return data_[i];
 }
 template <typename T, std::size_t N>
-GT_INLINE T& sarray<T, N>::operator[](std::size_t i)
+GT_INLINE constexpr T& sarray<T, N>::operator[](std::size_t i)
 {
   return data_[i];
 }
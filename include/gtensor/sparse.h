@@ -2,6 +2,7 @@
 #define GTENSOR_SPARSE_H
 
 #include <numeric>
+#include <stdexcept>
 #include <type_traits>
 
 #include "gtensor.h"
@@ -16,6 +17,16 @@ namespace sparse
 namespace detail
 {
 
+// the row_ptr / col_ind arrays are 32-bit, since that is what the vendor
+// sparse triangular solvers accept, so nnz has to fit in an int as well
+inline int checked_nnz(index_t nnz)
+{
+  if (nnz < 0 || !fits_index_32(nnz)) {
+    throw std::length_error("gt::sparse: nnz does not fit in 32-bit indices");
+  }
+  return nnz;
+}
+
 template <typename DataArray>
 gt::gtensor<int, 1> row_ptr_batches(DataArray& d_a_batches, int nbatches)
 {
@@ -52,6 +63,35 @@ gt::gtensor<int, 1> row_ptr_batches(DataArray& d_a_batches, int nbatches)
   return h_row_ptr;
 }
 
+// nonzero pattern shared by a batch of matrices: (i, j) is in the pattern if
+// it is nonzero in any of the batches
+template <typename DataArray>
+auto pattern_batches(DataArray& d_a_batches)
+{
+  using S = typename DataArray::space_type;
+  using T = typename DataArray::value_type;
+
+  int nrows = d_a_batches.shape(0);
+  int ncols = d_a_batches.shape(1);
+  int nbatches = d_a_batches.shape(2);
+  gt::gtensor<int, 2, S> d_pattern{gt::shape(nrows, ncols)};
+
+  auto k_pattern = d_pattern.to_kernel();
+  auto k_a_batches = d_a_batches.to_kernel();
+  gt::launch<2, S>(
+    d_pattern.shape(), GT_LAMBDA(int i, int j) {
+      int nz = 0;
+      for (int b = 0; b < nbatches; b++) {
+        if (T(k_a_batches(i, j, b)) != T(0)) {
+          nz = 1;
+          break;
+        }
+      }
+      k_pattern(i, j) = nz;
+    });
+  return d_pattern;
+}
+
 } // namespace detail
 
 template <typename T, typename S>
@@ -154,7 +194,8 @@ public:
   using const_kernel_type =
     csr_matrix_span<std::add_const_t<value_type>, space_type>;
 
-  csr_matrix(gt::shape_type<2> shape, int nnz) : shape_(shape), nnz_(nnz)
+  csr_matrix(gt::shape_type<2> shape, index_t nnz)
+    : shape_(shape), nnz_(detail::checked_nnz(nnz))
   {
     values_.resize({nnz_});
     col_ind_.resize({nnz_});
@@ -201,6 +242,46 @@ public:
 
   constexpr static size_type dimension() { return 2; }
 
+  // replaces the values of a matrix created by join_matrix_batches, keeping
+  // its sparsity pattern. Throws std::runtime_error if there are nonzeros
+  // outside of the pattern, in which case the values are left partially
+  // updated.
+  template <typename BatchData>
+  void update_batches(BatchData& d_matrix_batches)
+  {
+    static_assert(expr_dimension<BatchData>() == 3,
+                  "batched sparse update requires a 3d object");
+    auto k_row_ptr = row_ptr_.to_kernel();
+    auto k_col_ind = col_ind_.to_kernel();
+    auto k_values = values_.to_kernel();
+    auto k_matrix = d_matrix_batches.to_kernel();
+    int nrows = d_matrix_batches.shape(0);
+    int ncols = d_matrix_batches.shape(1);
+    int nbatches = d_matrix_batches.shape(2);
+    gt::gtensor<int, 2, S> outside(gt::shape(nrows, nbatches));
+    auto k_outside = outside.to_kernel();
+
+    gt::launch<2, S>(
+      gt::shape(nrows, nbatches), GT_LAMBDA(int i, int b) {
+        int row = i + b * nrows;
+        int n_inside = 0;
+        for (int idx = k_row_ptr(row); idx < k_row_ptr(row + 1); idx++) {
+          T value = k_matrix(i, k_col_ind(idx) - b * ncols, b);
+          k_values(idx) = value;
+          n_inside += value != T(0);
+        }
+        int n_nonzero = 0;
+        for (int j = 0; j < ncols; j++) {
+          n_nonzero += k_matrix(i, j, b) != T(0);
+        }
+        k_outside(i, b) = n_nonzero - n_inside;
+      });
+    if (gt::sum(outside) != 0) {
+      throw std::runtime_error(
+        "csr_matrix::update_batches: nonzero outside the sparsity pattern");
+    }
+  }
+
   template <typename BatchView>
   void convert_batches(BatchView& d_matrix_view,
                        gt::gtensor<int, 1, S>& d_row_ptr)
@@ -314,6 +395,151 @@ private:
   gt::gtensor<int, 1, S> row_ptr_;
 };
 
+// ======================================================================
+// csr_matrix_batch
+//
+// A batch of sparse matrices that share one nonzero pattern. The pattern
+// (row_ptr, col_ind) is stored once, the values of batch b are at
+// values_data() + b * nnz(). Unlike csr_matrix::join_matrix_batches, this
+// does not duplicate the pattern per batch, and the batches stay
+// independent of each other, see gt::solver::solver_sparse_batch.
+
+template <typename T, typename S>
+class csr_matrix_batch
+{
+public:
+  using value_type = T;
+  using space_type = S;
+  using shape_type = gt::shape_type<2>;
+  using batch_type = csr_matrix_span<value_type, space_type>;
+  using const_batch_type =
+    csr_matrix_span<std::add_const_t<value_type>, space_type>;
+
+  csr_matrix_batch(gt::shape_type<2> shape, index_t nnz, int nbatches)
+    : nnz_(detail::checked_nnz(nnz)),
+      nbatches_(nbatches),
+      shape_(shape),
+      values_(gt::shape(nnz_, nbatches)),
+      col_ind_(gt::shape(nnz_)),
+      row_ptr_(gt::shape(shape[0] + 1))
+  {}
+
+  // from dense nrows x ncols x nbatches data, with the union of the nonzero
+  // patterns of the batches as the shared pattern
+  template <typename BatchData>
+  explicit csr_matrix_batch(BatchData& d_matrix_batches)
+    : nbatches_(d_matrix_batches.shape(2)),
+      shape_(gt::shape(d_matrix_batches.shape(0), d_matrix_batches.shape(1)))
+  {
+    static_assert(expr_dimension<BatchData>() == 3,
+                  "batched sparse construction requires a 3d object");
+    auto d_pattern = detail::pattern_batches(d_matrix_batches);
+    auto d_pattern_batch = d_pattern.view(gt::all, gt::all, gt::newaxis);
+    auto h_row_ptr = detail::row_ptr_batches(d_pattern_batch, 1);
+    nnz_ = h_row_ptr(shape_[0]);
+
+    values_.resize({nnz_, nbatches_});
+    col_ind_.resize({nnz_});
+    row_ptr_.resize({shape_[0] + 1});
+    gt::copy(h_row_ptr, row_ptr_);
+
+    auto k_pattern = d_pattern.to_kernel();
+    auto k_matrix = d_matrix_batches.to_kernel();
+    auto k_row_ptr = row_ptr_.to_kernel();
+    auto k_values = values_.to_kernel();
+    auto k_col_ind = col_ind_.to_kernel();
+    int ncols = shape_[1];
+    gt::launch<2, S>(
+      gt::shape(shape_[0], nbatches_), GT_LAMBDA(int i, int b) {
+        int idx = k_row_ptr(i);
+        for (int j = 0; j < ncols; j++) {
+          if (k_pattern(i, j)) {
+            k_values(idx, b) = k_matrix(i, j, b);
+            if (b == 0) {
+              k_col_ind(idx) = j;
+            }
+            idx++;
+          }
+        }
+      });
+  }
+
+  // replaces the values from dense data like the constructor, keeping the
+  // sparsity pattern. Throws std::runtime_error if there are nonzeros
+  // outside of the pattern, in which case the values are left partially
+  // updated.
+  template <typename BatchData>
+  void update(BatchData& d_matrix_batches)
+  {
+    static_assert(expr_dimension<BatchData>() == 3,
+                  "batched sparse update requires a 3d object");
+    auto k_matrix = d_matrix_batches.to_kernel();
+    auto k_row_ptr = row_ptr_.to_kernel();
+    auto k_values = values_.to_kernel();
+    auto k_col_ind = col_ind_.to_kernel();
+    gt::gtensor<int, 2, S> outside(gt::shape(shape_[0], nbatches_));
+    auto k_outside = outside.to_kernel();
+    int ncols = shape_[1];
+    gt::launch<2, S>(
+      gt::shape(shape_[0], nbatches_), GT_LAMBDA(int i, int b) {
+        int n_inside = 0;
+        for (int idx = k_row_ptr(i); idx < k_row_ptr(i + 1); idx++) {
+          T value = k_matrix(i, k_col_ind(idx), b);
+          k_values(idx, b) = value;
+          n_inside += value != T(0);
+        }
+        int n_nonzero = 0;
+        for (int j = 0; j < ncols; j++) {
+          n_nonzero += k_matrix(i, j, b) != T(0);
+        }
+        k_outside(i, b) = n_nonzero - n_inside;
+      });
+    if (gt::sum(outside) != 0) {
+      throw std::runtime_error(
+        "csr_matrix_batch::update: nonzero outside the sparsity pattern");
+    }
+  }
+
+  int nnz() const { return nnz_; }
+  int nbatches() const { return nbatches_; }
+  auto size() const { return calc_size(shape_); }
+  auto shape() const { return shape_; }
+  auto shape(int i) const { return shape_[i]; }
+
+  auto values_data() const { return gt::raw_pointer_cast(values_.data()); }
+  auto row_ptr_data() const { return gt::raw_pointer_cast(row_ptr_.data()); }
+  auto col_ind_data() const { return gt::raw_pointer_cast(col_ind_.data()); }
+
+  auto values_data() { return gt::raw_pointer_cast(values_.data()); }
+  auto row_ptr_data() { return gt::raw_pointer_cast(row_ptr_.data()); }
+  auto col_ind_data() { return gt::raw_pointer_cast(col_ind_.data()); }
+
+  // kernel view of a single batch, sharing the pattern
+  auto batch(int b) const
+  {
+    auto values =
+      gt::adapt<1, S>(values_.data() + index_t(b) * nnz_, gt::shape(nnz_));
+    return const_batch_type(shape_, nnz_, values, col_ind_.to_kernel(),
+                            row_ptr_.to_kernel());
+  }
+
+  auto batch(int b)
+  {
+    auto values =
+      gt::adapt<1, S>(values_.data() + index_t(b) * nnz_, gt::shape(nnz_));
+    return batch_type(shape_, nnz_, values, col_ind_.to_kernel(),
+                      row_ptr_.to_kernel());
+  }
+
+private:
+  int nnz_;
+  int nbatches_;
+  shape_type shape_;
+  gt::gtensor<T, 2, S> values_;
+  gt::gtensor<int, 1, S> col_ind_;
+  gt::gtensor<int, 1, S> row_ptr_;
+};
+
 } // namespace sparse
 
 } // namespace gt
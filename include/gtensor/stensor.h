@@ -0,0 +1,362 @@
+
+// ======================================================================
+// stensor.h
+//
+// stensor<T, N0, N1, ...> : stack allocated tensor with static extents
+//
+// Intended for small dense blocks (per-cell 3x3 matrices, per-point vectors)
+// that live in registers inside GT_LAMBDA kernels. Shape and strides are
+// compile time constants, so indexing reduces to constant offsets once the
+// loops over the (small, fixed) extents are unrolled. Like a scalar, a
+// stensor has no fixed memory space (space::any), so it can be mixed into
+// host and device expressions alike; it is captured by value.
+
+#ifndef GTENSOR_STENSOR_H
+#define GTENSOR_STENSOR_H
+
+#include <sstream>
+#include <type_traits>
+
+#include "assign.h"
+#include "defs.h"
+#include "expression.h"
+#include "helper.h"
+#include "macros.h"
+#include "sarray.h"
+#include "space.h"
+#include "strides.h"
+
+namespace gt
+{
+
+namespace detail
+{
+
+// ----------------------------------------------------------------------
+// stensor_size
+//
+// product of the static extents
+
+template <int... Ns>
+struct stensor_size;
+
+template <>
+struct stensor_size<>
+{
+  constexpr static size_type value = 1;
+};
+
+template <int N0, int... Ns>
+struct stensor_size<N0, Ns...>
+{
+  constexpr static size_type value = N0 * stensor_size<Ns...>::value;
+};
+
+// ----------------------------------------------------------------------
+// stensor_index
+//
+// col-major index with compile time strides. As in calc_strides, dimensions
+// of extent 1 get stride 0, so they broadcast.
+
+template <size_type Stride, int... Ns>
+struct stensor_index;
+
+template <size_type Stride>
+struct stensor_index<Stride>
+{
+  GT_INLINE constexpr static size_type run() { return 0; }
+};
+
+template <size_type Stride, int N0, int... Ns>
+struct stensor_index<Stride, N0, Ns...>
+{
+  template <typename Arg, typename... Args>
+  GT_INLINE constexpr static size_type run(Arg arg, Args... args)
+  {
+    return (N0 == 1 ? 0 : Stride) * size_type(arg) +
+           stensor_index<Stride * N0, Ns...>::run(args...);
+  }
+};
+
+// ----------------------------------------------------------------------
+// stensor_stride
+//
+// col-major stride of dimension d, 0 for extent 1 like stensor_index
+
+template <int... Ns>
+GT_INLINE constexpr index_t stensor_stride(size_type d)
+{
+  constexpr int ns[] = {Ns...};
+  index_t stride = 1;
+  for (size_type i = 0; i < d; i++) {
+    stride *= ns[i];
+  }
+  return ns[d] == 1 ? 0 : stride;
+}
+
+} // namespace detail
+
+// ======================================================================
+// stensor
+
+template <typename T, int... Ns>
+class stensor : public expression<stensor<T, Ns...>>
+{
+public:
+  using self_type = stensor<T, Ns...>;
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using space_type = space::any;
+
+  constexpr static size_type dimension() { return sizeof...(Ns); }
+
+  using shape_type = gt::shape_type<dimension()>;
+  using strides_type = gt::shape_type<dimension()>;
+
+  static_assert(sizeof...(Ns) > 0, "stensor needs at least one extent");
+
+  stensor() = default;
+
+  // construct from exactly size() elements, in col-major order
+  template <typename... U,
+            std::enable_if_t<sizeof...(U) ==
+                                 detail::stensor_size<Ns...>::value &&
+                               !has_expression<U...>::value,
+                             int> = 0>
+  GT_INLINE stensor(U... args) : data_{T(args)...}
+  {}
+
+  template <typename E>
+  stensor(const expression<E>& e);
+
+  template <typename E>
+  self_type& operator=(const expression<E>& e);
+
+  GT_INLINE constexpr static shape_type shape() { return shape_type(Ns...); }
+  GT_INLINE constexpr static index_t shape(int i) { return shape()[i]; }
+  GT_INLINE constexpr static strides_type strides()
+  {
+    return strides_impl(std::make_index_sequence<sizeof...(Ns)>{});
+  }
+  GT_INLINE constexpr static size_type size()
+  {
+    return detail::stensor_size<Ns...>::value;
+  }
+
+  template <typename... Args>
+  GT_INLINE const_reference operator()(Args... args) const;
+  template <typename... Args>
+  GT_INLINE reference operator()(Args... args);
+
+  GT_INLINE const_reference operator[](const shape_type& idx) const;
+  GT_INLINE reference operator[](const shape_type& idx);
+
+  GT_INLINE const_reference data_access(size_type i) const { return data_[i]; }
+  GT_INLINE reference data_access(size_type i) { return data_[i]; }
+
+  GT_INLINE const_pointer data() const { return data_; }
+  GT_INLINE pointer data() { return data_; }
+
+  GT_INLINE void fill(const value_type v);
+
+  GT_INLINE self_type& operator+=(const self_type& o);
+  GT_INLINE self_type& operator-=(const self_type& o);
+  GT_INLINE self_type& operator*=(const value_type v);
+  GT_INLINE self_type& operator/=(const value_type v);
+
+  // copy by value, so it can be captured / passed into kernels
+  self_type to_kernel() const { return *this; }
+
+  inline std::string typestr() const&;
+
+  inline bool is_f_contiguous() const { return true; }
+
+private:
+  template <size_type... I>
+  GT_INLINE constexpr static strides_type strides_impl(
+    std::index_sequence<I...>)
+  {
+    return strides_type(detail::stensor_stride<Ns...>(I)...);
+  }
+
+  template <typename S, size_type... I>
+  GT_INLINE const_reference access(std::index_sequence<I...>,
+                                   const S& idx) const
+  {
+    return (*this)(idx[I]...);
+  }
+
+  template <typename S, size_type... I>
+  GT_INLINE reference access(std::index_sequence<I...>, const S& idx)
+  {
+    return (*this)(idx[I]...);
+  }
+
+  T data_[detail::stensor_size<Ns...>::value] = {};
+};
+
+// ======================================================================
+// stensor implementation
+
+template <typename T, int... Ns>
+template <typename E>
+inline stensor<T, Ns...>::stensor(const expression<E>& e)
+{
+  *this = e;
+}
+
+template <typename T, int... Ns>
+template <typename E>
+inline auto stensor<T, Ns...>::operator=(const expression<E>& e) -> self_type&
+{
+  // the elements live wherever the stensor does, evaluate on the host
+  static_assert(!std::is_same<expr_space_type<E>, space::device>::value,
+                "stensor: cannot assign from a device expression");
+  detail::valid_assign_broadcast_or_throw(shape(), e.derived().shape());
+  detail::assigner<dimension(), space::host>::run(*this, e.derived(),
+                                                  gt::stream_view{});
+  return *this;
+}
+
+template <typename T, int... Ns>
+template <typename... Args>
+GT_INLINE auto stensor<T, Ns...>::operator()(Args... args) const
+  -> const_reference
+{
+  static_assert(sizeof...(Args) == sizeof...(Ns),
+                "stensor: need matching number of args");
+#ifdef GTENSOR_BOUNDS_CHECK
+  bounds_check(shape(), args...);
+#endif
+  return data_[detail::stensor_index<1, Ns...>::run(args...)];
+}
+
+template <typename T, int... Ns>
+template <typename... Args>
+GT_INLINE auto stensor<T, Ns...>::operator()(Args... args) -> reference
+{
+  static_assert(sizeof...(Args) == sizeof...(Ns),
+                "stensor: need matching number of args");
+#ifdef GTENSOR_BOUNDS_CHECK
+  bounds_check(shape(), args...);
+#endif
+  return data_[detail::stensor_index<1, Ns...>::run(args...)];
+}
+
+template <typename T, int... Ns>
+GT_INLINE auto stensor<T, Ns...>::operator[](const shape_type& idx) const
+  -> const_reference
+{
+  return access(std::make_index_sequence<sizeof...(Ns)>(), idx);
+}
+
+template <typename T, int... Ns>
+GT_INLINE auto stensor<T, Ns...>::operator[](const shape_type& idx)
+  -> reference
+{
+  return access(std::make_index_sequence<sizeof...(Ns)>(), idx);
+}
+
+template <typename T, int... Ns>
+GT_INLINE void stensor<T, Ns...>::fill(const value_type v)
+{
+  for (size_type i = 0; i < size(); i++) {
+    data_[i] = v;
+  }
+}
+
+template <typename T, int... Ns>
+GT_INLINE auto stensor<T, Ns...>::operator+=(const self_type& o) -> self_type&
+{
+  for (size_type i = 0; i < size(); i++) {
+    data_[i] += o.data_[i];
+  }
+  return *this;
+}
+
+template <typename T, int... Ns>
+GT_INLINE auto stensor<T, Ns...>::operator-=(const self_type& o) -> self_type&
+{
+  for (size_type i = 0; i < size(); i++) {
+    data_[i] -= o.data_[i];
+  }
+  return *this;
+}
+
+template <typename T, int... Ns>
+GT_INLINE auto stensor<T, Ns...>::operator*=(const value_type v) -> self_type&
+{
+  for (size_type i = 0; i < size(); i++) {
+    data_[i] *= v;
+  }
+  return *this;
+}
+
+template <typename T, int... Ns>
+GT_INLINE auto stensor<T, Ns...>::operator/=(const value_type v) -> self_type&
+{
+  for (size_type i = 0; i < size(); i++) {
+    data_[i] /= v;
+  }
+  return *this;
+}
+
+template <typename T, int... Ns>
+inline std::string stensor<T, Ns...>::typestr() const&
+{
+  std::stringstream s;
+  s << "st" << dimension() << "<" << get_type_name<T>() << ">" << shape();
+  return s.str();
+}
+
+// ======================================================================
+// matmul, matvec
+//
+// small dense products for use inside kernels; the loop bounds are compile
+// time constants, so these unroll completely.
+
+template <typename T, int M, int K, int N>
+GT_INLINE stensor<T, M, N> matmul(const stensor<T, M, K>& a,
+                                  const stensor<T, K, N>& b)
+{
+  stensor<T, M, N> c;
+  for (int j = 0; j < N; j++) {
+    for (int k = 0; k < K; k++) {
+      for (int i = 0; i < M; i++) {
+        c(i, j) += a(i, k) * b(k, j);
+      }
+    }
+  }
+  return c;
+}
+
+template <typename T, int M, int K>
+GT_INLINE stensor<T, M> matvec(const stensor<T, M, K>& a,
+                               const stensor<T, K>& x)
+{
+  stensor<T, M> y;
+  for (int k = 0; k < K; k++) {
+    for (int i = 0; i < M; i++) {
+      y(i) += a(i, k) * x(k);
+    }
+  }
+  return y;
+}
+
+// ======================================================================
+// is_stensor
+
+template <typename E>
+struct is_stensor : std::false_type
+{};
+
+template <typename T, int... Ns>
+struct is_stensor<stensor<T, Ns...>> : std::true_type
+{};
+
+} // namespace gt
+
+#endif
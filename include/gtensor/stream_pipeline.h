@@ -0,0 +1,128 @@
+// ======================================================================
+// stream_pipeline.h
+//
+// stream_pipeline : streams host arrays through buffers in space S in chunks
+// along their last axis
+//
+// Chunk i is handled on stream i % depth of a stream_pool: it is copied into
+// that stream's input buffer, the user kernel runs, and the output buffer is
+// copied back. With depth >= 2 the transfers of one chunk overlap with the
+// kernel of another, and buffers are reused once their stream gets back to
+// them. On host-only builds the buffers live on the host and each stream is
+// a worker thread, so the same code overlaps e.g. I/O with compute.
+//
+// The kernel is called once per chunk as
+//
+//   f(gt::gtensor_span<const T, N, S> in, gt::gtensor_span<T, N, S> out,
+//     gt::stream_view stream)
+//
+// and must only submit stream-ordered work (gt::assign, gt::launch, ... on
+// `stream`). The spans cover the chunk, the last one may be shorter than
+// the chunk shape. With CUDA / HIP, copies from pageable host memory are not
+// fully asynchronous.
+//
+// The host side is the caller's array itself, so unlike the usual
+// gt::host_mirror + gt::copy pattern there is no host copy of the whole
+// array: chunks of the last axis are contiguous and are copied straight
+// between the caller's memory and the per-stream buffers. The buffers are
+// the only extra storage, depth * 2 chunks in space S.
+
+#ifndef GTENSOR_STREAM_PIPELINE_H
+#define GTENSOR_STREAM_PIPELINE_H
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <vector>
+
+#include "gtensor.h"
+#include "stream_pool.h"
+
+namespace gt
+{
+
+template <typename T, size_type N, typename S = gt::space::device>
+class stream_pipeline
+{
+public:
+  using value_type = T;
+  using shape_type = gt::shape_type<N>;
+  using buffer_type = gt::gtensor<T, N, S>;
+  using span_type = gt::gtensor_span<T, N, S>;
+  using const_span_type = gt::gtensor_span<const T, N, S>;
+
+  // the last dimension of chunk_shape is the (max) number of slices per chunk
+  explicit stream_pipeline(const shape_type& chunk_shape, int depth = 2)
+    : chunk_shape_(chunk_shape), streams_(depth)
+  {
+    assert(chunk_shape[N - 1] > 0);
+    in_.reserve(depth);
+    out_.reserve(depth);
+    for (int k = 0; k < depth; k++) {
+      in_.emplace_back(chunk_shape);
+      out_.emplace_back(chunk_shape);
+    }
+  }
+
+  int depth() const { return streams_.size(); }
+
+  const shape_type& chunk_shape() const { return chunk_shape_; }
+
+  // dst = f(src) chunk by chunk, for host arrays src and dst of the same
+  // shape whose leading dimensions match the chunk shape. Returns when dst
+  // is complete.
+  template <typename E1, typename E2, typename F>
+  void run(const E1& src, E2& dst, F&& f)
+  {
+    static_assert(std::is_same<gt::expr_space_type<E1>, gt::space::host>{} &&
+                    std::is_same<gt::expr_space_type<E2>, gt::space::host>{},
+                  "stream_pipeline: src and dst must be host arrays");
+    assert(src.shape() == dst.shape());
+    for (size_type d = 0; d < N - 1; d++) {
+      assert(src.shape(d) == chunk_shape_[d]);
+    }
+
+    index_t n_slices = src.shape(N - 1);
+    index_t chunk_slices = chunk_shape_[N - 1];
+    for (index_t start = 0, i = 0; start < n_slices;
+         start += chunk_slices, i++) {
+      shape_type shape = chunk_shape_;
+      shape[N - 1] = std::min(chunk_slices, n_slices - start);
+
+      int k = i % depth();
+      auto stream = streams_[k];
+      auto in = gt::adapt<N, S>(in_[k].data(), shape);
+      auto out = gt::adapt<N, S>(out_[k].data(), shape);
+
+      gt::copy_async(host_chunk(src, start, shape), in, stream);
+      f(const_span_type(in), out, stream);
+      gt::copy_async(out, host_chunk(dst, start, shape), stream);
+    }
+    streams_.synchronize();
+  }
+
+  // in place, a = f(a)
+  template <typename E, typename F>
+  void run(E& a, F&& f)
+  {
+    run(a, a, std::forward<F>(f));
+  }
+
+private:
+  template <typename E>
+  static auto host_chunk(E& e, index_t start, const shape_type& shape)
+  {
+    using U = std::remove_pointer_t<decltype(e.data())>;
+    return gt::gtensor_span<U, N>(e.data() + start * e.strides()[N - 1],
+                                  shape, e.strides());
+  }
+
+  shape_type chunk_shape_;
+  gt::stream_pool streams_;
+  std::vector<buffer_type> in_;
+  std::vector<buffer_type> out_;
+};
+
+} // namespace gt
+
+#endif // GTENSOR_STREAM_PIPELINE_H
@@ -0,0 +1,78 @@
+// ======================================================================
+// stream_pool.h
+//
+// stream_pool : fixed set of streams created once and handed out repeatedly
+//
+// Creating a gt::stream costs a backend create / destroy each time. For many
+// small independent launches (e.g. one per species), take streams from a pool
+// instead: next() hands them out round-robin, next_idle() prefers a stream
+// that has no pending work. Both may be called from several threads.
+
+#ifndef GTENSOR_STREAM_POOL_H
+#define GTENSOR_STREAM_POOL_H
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "device_backend.h"
+
+namespace gt
+{
+
+class stream_pool
+{
+public:
+  explicit stream_pool(
+    int size, gt::stream_priority priority = gt::stream_priority::normal)
+    : next_(0)
+  {
+    assert(size > 0);
+    streams_.reserve(size);
+    for (int i = 0; i < size; i++) {
+      streams_.push_back(std::make_unique<gt::stream>(priority));
+    }
+  }
+
+  int size() const { return streams_.size(); }
+
+  gt::stream_view operator[](int i) { return streams_[i]->get_view(); }
+
+  // round-robin
+  gt::stream_view next() { return (*this)[position(next_.fetch_add(1))]; }
+
+  // the first idle stream starting at the round-robin position, or simply
+  // the next one if all streams are busy. Idleness is only a snapshot, so
+  // concurrent callers may still be handed the same stream.
+  gt::stream_view next_idle()
+  {
+    int start = next_.load();
+    for (int k = 0; k < size(); k++) {
+      int i = position(start + k);
+      if (streams_[i]->query()) {
+        next_.store(i + 1);
+        return (*this)[i];
+      }
+    }
+    return next();
+  }
+
+  void synchronize()
+  {
+    for (auto& stream : streams_) {
+      stream->synchronize();
+    }
+  }
+
+private:
+  // the counter may wrap around, so map it through unsigned
+  int position(int count) const { return unsigned(count) % unsigned(size()); }
+
+  std::vector<std::unique_ptr<gt::stream>> streams_;
+  std::atomic<int> next_;
+};
+
+} // namespace gt
+
+#endif // GTENSOR_STREAM_POOL_H
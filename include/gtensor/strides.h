@@ -2,6 +2,10 @@
 #ifndef GTENSOR_STRIDES_H
 #define GTENSOR_STRIDES_H
 
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
 namespace gt
 {
 
@@ -14,7 +18,7 @@ template <typename S>
 GT_INLINE S calc_strides(const S& shape)
 {
   S strides;
-  int stride = 1;
+  typename S::value_type stride = 1;
   for (int i = 0; i < shape.size(); i++) {
     if (shape[i] == 1) {
       strides[i] = 0;
@@ -31,17 +35,35 @@ GT_INLINE S calc_strides(const S& shape)
 //
 // given 1-d index and strides, calculate multi-d index
 //
-template <typename S>
-GT_INLINE S unravel(size_type i, const S& strides)
+// The arithmetic is done in the type of the 1-d index, so device kernels can
+// pass a 32-bit index (with 32-bit strides) when the total size allows.
+// Non-integral index types (e.g. sycl::id<1>) are converted to size_type.
+template <typename S, typename I>
+GT_INLINE S unravel(I i, const S& strides)
 {
+  using index_type =
+    std::conditional_t<std::is_integral<I>::value, I, size_type>;
+  index_type j = i;
   S idx;
   for (int d = strides.size() - 1; d >= 0; d--) {
-    idx[d] = strides[d] == 0 ? 0 : (i / strides[d]);
-    i -= idx[d] * strides[d];
+    idx[d] = strides[d] == 0 ? 0 : (j / strides[d]);
+    j -= idx[d] * strides[d];
   }
   return idx;
 }
 
+// ======================================================================
+// fits_index_32
+//
+// whether a linear index over `size` elements (plus `pad` for threads past the
+// end of the last block) can be done in 32-bit arithmetic. Device kernels use
+// this to keep 32-bit indexing when possible, independent of index_t.
+
+inline bool fits_index_32(size_type size, size_type pad = 0)
+{
+  return size + pad <= size_type(std::numeric_limits<int>::max());
+}
+
 // ======================================================================
 // calc_index
 //
@@ -0,0 +1,101 @@
+// ======================================================================
+// write_tracking.h
+//
+// hooks for containers that can track their last writer (see
+// gtensor_container::track_writes()), no-ops for other expressions.
+// Function expressions and views forward wait_write() to their operands, so
+// that reads of tracked containers through them are ordered as well. Views
+// also forward record_write() and synchronize_write(), so writes through a
+// view of a tracked container are recorded on the container.
+
+#ifndef GTENSOR_WRITE_TRACKING_H
+#define GTENSOR_WRITE_TRACKING_H
+
+#include <type_traits>
+#include <utility>
+
+#include "device_backend.h"
+#include "meta.h"
+
+namespace gt
+{
+
+namespace detail
+{
+
+template <typename E, typename Enable = void>
+struct has_synchronize_write : std::false_type
+{};
+
+template <typename E>
+struct has_synchronize_write<
+  E, gt::meta::void_t<decltype(std::declval<const E&>().synchronize_write())>>
+  : std::true_type
+{};
+
+template <typename E>
+using wait_write_t = decltype(std::declval<const E&>().wait_write(
+  std::declval<gt::stream_view>()));
+
+template <typename E, typename Enable = void>
+struct has_wait_write : std::false_type
+{};
+
+template <typename E>
+struct has_wait_write<E, gt::meta::void_t<wait_write_t<E>>> : std::true_type
+{};
+
+template <typename E>
+using record_write_t =
+  decltype(std::declval<E&>().record_write(std::declval<gt::stream_view>()));
+
+template <typename E, typename Enable = void>
+struct has_record_write : std::false_type
+{};
+
+template <typename E>
+struct has_record_write<E, gt::meta::void_t<record_write_t<E>>>
+  : std::true_type
+{};
+
+template <typename E>
+inline std::enable_if_t<has_record_write<E>::value> record_write(
+  E& e, gt::stream_view stream)
+{
+  e.record_write(stream);
+}
+
+template <typename E>
+inline std::enable_if_t<!has_record_write<E>::value> record_write(
+  E&, gt::stream_view)
+{}
+
+template <typename E>
+inline std::enable_if_t<has_wait_write<E>::value> wait_write(
+  const E& e, gt::stream_view stream)
+{
+  e.wait_write(stream);
+}
+
+template <typename E>
+inline std::enable_if_t<!has_wait_write<E>::value> wait_write(
+  const E&, gt::stream_view)
+{}
+
+template <typename E>
+inline std::enable_if_t<has_synchronize_write<E>::value> synchronize_write(
+  const E& e)
+{
+  e.synchronize_write();
+}
+
+template <typename E>
+inline std::enable_if_t<!has_synchronize_write<E>::value> synchronize_write(
+  const E&)
+{}
+
+} // namespace detail
+
+} // namespace gt
+
+#endif // GTENSOR_WRITE_TRACKING_H
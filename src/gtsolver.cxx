@@ -1,3 +1,10 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
 #include "gtensor/gtensor.h"
 
 #include "gt-blas/blas.h"
@@ -28,6 +35,28 @@ void init_device_pointer_array(PtrArray& d_ptr_array, DataArray& d_data_array)
   gt::copy(h_ptr_array, d_ptr_array);
 }
 
+// forward / backward substitution in place on x, with the L (unit diagonal)
+// and U factors of one batch of a csr_matrix_batch
+template <typename T>
+GT_INLINE void csr_lu_solve(int n, const int* row_ptr, const int* col_ind,
+                            const int* diag_ind, const T* values, T* x)
+{
+  for (int i = 0; i < n; i++) {
+    T sum = x[i];
+    for (int idx = row_ptr[i]; idx < diag_ind[i]; idx++) {
+      sum -= values[idx] * x[col_ind[idx]];
+    }
+    x[i] = sum;
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    T sum = x[i];
+    for (int idx = diag_ind[i] + 1; idx < row_ptr[i + 1]; idx++) {
+      sum -= values[idx] * x[col_ind[idx]];
+    }
+    x[i] = sum / values[diag_ind[i]];
+  }
+}
+
 template <typename T, typename DataArray>
 void copy_batch_data(T* const* in_matrix_batches, DataArray& out_data)
 {
@@ -42,9 +71,92 @@ void copy_batch_data(T* const* in_matrix_batches, DataArray& out_data)
   }
 }
 
-} // namespace detail
+// copies the matrices to contiguous device memory and LU factors them
+// without pivoting, for the sparse solvers
+template <typename T>
+gt::gtensor_device<T, 3> lu_factor_npvt_batches(gt::blas::handle_t& h, int n,
+                                                int nbatches,
+                                                T* const* matrix_batches)
+{
+  gt::gtensor_device<T, 3> matrix_data(gt::shape(n, n, nbatches));
+  gt::gtensor_device<T*, 1> matrix_pointers(gt::shape(nbatches));
+  gt::gtensor_device<int, 1> info(gt::shape(nbatches));
+
+  copy_batch_data(matrix_batches, matrix_data);
+  init_device_pointer_array(matrix_pointers, matrix_data);
 
-#ifdef GTENSOR_DEVICE_SYCL
+  gt::blas::getrf_npvt_batched<T>(
+    h, n, gt::raw_pointer_cast(matrix_pointers.data()), n,
+    gt::raw_pointer_cast(info.data()), nbatches);
+  h.get_stream().synchronize();
+  return matrix_data;
+}
+
+// the first n * nrhs * nbatches elements of buf, as a contiguous
+// n x nrhs x nbatches array
+template <typename T>
+gt::gtensor_span_device<T, 3> packed_span(gt::gtensor_device<T, 3>& buf, int n,
+                                          int nrhs, int nbatches)
+{
+  return gt::adapt<3, gt::space::device>(buf.data(),
+                                         gt::shape(n, nrhs, nbatches));
+}
+
+// rhs must be n x nrhs x nbatches for some nrhs up to max_nrhs, and result
+// the same shape
+template <typename E1, typename E2>
+void check_rhs_shape(const E1& rhs, const E2& result, int n, int max_nrhs,
+                     int nbatches)
+{
+  if (rhs.shape(0) != n || rhs.shape(1) > max_nrhs ||
+      rhs.shape(2) != nbatches) {
+    throw std::invalid_argument(
+      "gt::solver: rhs shape " + to_string(rhs.shape()) + " is not n = " +
+      std::to_string(n) + " x nrhs <= " + std::to_string(max_nrhs) +
+      " x nbatches = " + std::to_string(nbatches));
+  }
+  if (result.shape() != rhs.shape()) {
+    throw std::invalid_argument("gt::solver: result shape " +
+                                to_string(result.shape()) +
+                                " does not match rhs shape " +
+                                to_string(rhs.shape()));
+  }
+}
+
+enum class overlap
+{
+  none,
+  same,   // the same elements, for solving in place
+  partial // must be staged through a buffer before writing the result
+};
+
+// [begin, end) addresses spanned by the elements of s
+template <typename S>
+std::pair<std::uintptr_t, std::uintptr_t> address_range(const S& s)
+{
+  auto range = gt::detail::strided_storage_range(s);
+  auto begin = reinterpret_cast<std::uintptr_t>(range.first);
+  return {begin, begin + range.second * sizeof(typename S::value_type)};
+}
+
+// how the elements of spans a and b of the same shape overlap in memory;
+// conservatively partial when their address ranges intersect, even if the
+// strides interleave them without sharing elements
+template <typename S1, typename S2>
+overlap get_overlap(const S1& a, const S2& b)
+{
+  auto ra = address_range(a);
+  auto rb = address_range(b);
+  if (ra.first >= rb.second || rb.first >= ra.second) {
+    return overlap::none;
+  }
+  if (ra.first == rb.first && a.strides() == b.strides()) {
+    return overlap::same;
+  }
+  return overlap::partial;
+}
+
+} // namespace detail
 
 template <typename T>
 solver_dense<T>::solver_dense(gt::blas::handle_t& h, int n, int nbatches,
@@ -56,102 +168,83 @@ solver_dense<T>::solver_dense(gt::blas::handle_t& h, int n, int nbatches,
     matrix_data_(gt::shape(n, n, nbatches)),
     pivot_data_(gt::shape(n, nbatches)),
     rhs_data_(gt::shape(n, nrhs, nbatches)),
-    scratch_count_(gt::blas::getrs_strided_batched_scratchpad_size<T>(
-      h, n, n, n, nrhs, nbatches)),
+    // Note: the scratch space is shared by getrf and getrs
+    scratch_count_(
+      std::max(gt::blas::getrf_strided_batched_scratchpad_size<T>(h, n, n,
+                                                                  nbatches),
+               gt::blas::getrs_strided_batched_scratchpad_size<T>(
+                 h, n, nrhs, n, n, nbatches))),
     scratch_(scratch_count_)
+{
+  update_matrices(matrix_batches);
+}
+
+template <typename T>
+void solver_dense<T>::update_matrices(T* const* matrix_batches)
 {
   detail::copy_batch_data(matrix_batches, matrix_data_);
 
   // factor using strided API
-  auto prep_scratch_count =
-    gt::blas::getrf_strided_batched_scratchpad_size<T>(h_, n_, n_, nbatches_);
-  gt::space::device_vector<T> prep_scratch(prep_scratch_count);
-
   gt::blas::getrf_strided_batched<T>(
     h_, n_, gt::raw_pointer_cast(matrix_data_.data()), n_,
     gt::raw_pointer_cast(pivot_data_.data()), nbatches_,
-    gt::raw_pointer_cast(prep_scratch.data()), prep_scratch_count);
-  // Note: synchronize so it's safe to destroy scratch
-  gt::synchronize();
+    gt::raw_pointer_cast(scratch_.data()), scratch_count_);
+  // Note: synchronize for consistency with other implementations
+  h_.get_stream().synchronize();
 }
 
 template <typename T>
-void solver_dense<T>::solve(T* rhs, T* result)
+void solver_dense<T>::getrs(T* rhs, int nrhs)
 {
-  gt::copy_n(gt::device_pointer_cast(rhs), n_ * nrhs_ * nbatches_,
-             rhs_data_.data());
   gt::blas::getrs_strided_batched<T>(
-    h_, n_, nrhs_, gt::raw_pointer_cast(matrix_data_.data()), n_,
-    gt::raw_pointer_cast(pivot_data_.data()),
-    gt::raw_pointer_cast(rhs_data_.data()), n_, nbatches_,
+    h_, n_, nrhs, gt::raw_pointer_cast(matrix_data_.data()), n_,
+    gt::raw_pointer_cast(pivot_data_.data()), rhs, n_, nbatches_,
     gt::raw_pointer_cast(scratch_.data()), scratch_count_);
-  gt::copy_n(rhs_data_.data(), n_ * nrhs_ * nbatches_,
-             gt::device_pointer_cast(result));
 }
 
 template <typename T>
-std::size_t solver_dense<T>::get_device_memory_usage()
+void solver_dense<T>::solve(T* rhs, T* result)
 {
-  size_t nelements = matrix_data_.size() + rhs_data_.size() + scratch_count_;
-  size_t nindex = pivot_data_.size();
-  return nelements * sizeof(T) + nindex * sizeof(gt::blas::index_t);
+  auto shape = gt::shape(n_, nrhs_, nbatches_);
+  solve(const_span_type(gt::adapt_device(rhs, shape)),
+        gt::adapt_device(result, shape));
 }
 
-#else // CUDA and HIP
-
 template <typename T>
-solver_dense<T>::solver_dense(gt::blas::handle_t& h, int n, int nbatches,
-                              int nrhs, T* const* matrix_batches)
-  : h_(h),
-    n_(n),
-    nbatches_(nbatches),
-    nrhs_(nrhs),
-    matrix_data_(gt::shape(n, n, nbatches)),
-    matrix_pointers_(gt::shape(nbatches)),
-    pivot_data_(gt::shape(n, nbatches)),
-    info_(gt::shape(nbatches)),
-    rhs_data_(gt::shape(n, nrhs, nbatches)),
-    rhs_pointers_(gt::shape(nbatches))
+void solver_dense<T>::solve(const_span_type rhs, span_type result)
 {
-  // copy non-contiguous host memory to contiguous device memory
-  detail::copy_batch_data(matrix_batches, matrix_data_);
-  detail::init_device_pointer_array(matrix_pointers_, matrix_data_);
-  detail::init_device_pointer_array(rhs_pointers_, rhs_data_);
-
-  // dense LU factor with pivot
-  gt::blas::getrf_batched<T>(h_, n_,
-                             gt::raw_pointer_cast(matrix_pointers_.data()), n_,
-                             gt::raw_pointer_cast(pivot_data_.data()),
-                             gt::raw_pointer_cast(info_.data()), nbatches_);
-  // Note: synchronize for consistency with other implementations
-  gt::synchronize();
+  detail::check_rhs_shape(rhs, result, n_, nrhs_, nbatches_);
+  int nrhs = rhs.shape(1);
+  auto overlap = detail::get_overlap(rhs, result);
+  auto stream = h_.get_stream();
+  // getrs is in place, so solve directly in result if possible
+  if (result.is_f_contiguous() && overlap != detail::overlap::partial) {
+    if (overlap == detail::overlap::none) {
+      gt::assign(result, rhs, stream);
+    }
+    getrs(gt::raw_pointer_cast(result.data()), nrhs);
+  } else {
+    auto b = detail::packed_span(rhs_data_, n_, nrhs, nbatches_);
+    gt::assign(b, rhs, stream);
+    getrs(gt::raw_pointer_cast(b.data()), nrhs);
+    gt::assign(result, b, stream);
+  }
 }
 
 template <typename T>
-void solver_dense<T>::solve(T* rhs, T* result)
+void solver_dense<T>::solve_inplace(span_type rhs)
 {
-  gt::copy_n(gt::device_pointer_cast(rhs), n_ * nrhs_ * nbatches_,
-             rhs_data_.data());
-  gt::blas::getrs_batched<T>(
-    h_, n_, nrhs_, gt::raw_pointer_cast(matrix_pointers_.data()), n_,
-    gt::raw_pointer_cast(pivot_data_.data()),
-    gt::raw_pointer_cast(rhs_pointers_.data()), n_, nbatches_);
-  gt::copy_n(rhs_data_.data(), n_ * nrhs_ * nbatches_,
-             gt::device_pointer_cast(result));
+  solve(const_span_type(rhs), rhs);
 }
 
 template <typename T>
 std::size_t solver_dense<T>::get_device_memory_usage()
 {
-  size_t nelements = matrix_data_.size() + rhs_data_.size();
+  size_t nelements = matrix_data_.size() + rhs_data_.size() + scratch_count_;
   size_t nindex = pivot_data_.size();
-  size_t nptr = matrix_pointers_.size() + rhs_pointers_.size();
-  return nelements * sizeof(T) + nindex * sizeof(gt::blas::index_t) +
-         nptr * sizeof(T*) + info_.size() * sizeof(int);
+  return nelements * sizeof(T) + nindex * sizeof(gt::blas::index_t);
 }
 
-#endif
-
 template class solver_dense<float>;
 template class solver_dense<double>;
 template class solver_dense<gt::complex<float>>;
@@ -165,63 +258,102 @@ solver_invert<T>::solver_invert(gt::blas::handle_t& h, int n, int nbatches,
     nbatches_(nbatches),
     nrhs_(nrhs),
     matrix_data_(gt::shape(n, n, nbatches)),
-    matrix_pointers_(gt::shape(nbatches)),
     pivot_data_(gt::shape(n, nbatches)),
-    info_(gt::shape(nbatches)),
-    rhs_data_(gt::shape(n, nrhs, nbatches)),
-    rhs_pointers_(gt::shape(nbatches)),
-    rhs_input_data_(gt::shape(n, nrhs, nbatches)),
-    rhs_input_pointers_(gt::shape(nbatches))
+    rhs_data_(gt::shape(n, nrhs, nbatches))
 {
-  detail::copy_batch_data(matrix_batches, matrix_data_);
-  detail::init_device_pointer_array(matrix_pointers_, matrix_data_);
-  detail::init_device_pointer_array(rhs_pointers_, rhs_data_);
-  detail::init_device_pointer_array(rhs_input_pointers_, rhs_input_data_);
-
-  // LU factor with pivot into matrix_data_
-  gt::blas::getrf_batched<T>(h_, n_,
-                             gt::raw_pointer_cast(matrix_pointers_.data()), n_,
-                             gt::raw_pointer_cast(pivot_data_.data()),
-                             gt::raw_pointer_cast(info_.data()), nbatches_);
-
-  // invert using LU factors with getri.
-  // Note: getri is not in place, so we copy input data to temporary and have
-  // inverted output go into the matrix_data_ member variable
+  update_matrices(matrix_batches);
+}
+
+template <typename T>
+void solver_invert<T>::update_matrices(T* const* matrix_batches)
+{
+  // LU factor with pivot into a temporary
   gt::gtensor_device<T, 3> d_A(matrix_data_.shape());
-  gt::gtensor_device<T*, 1> d_Aptr(matrix_pointers_.shape());
-  detail::init_device_pointer_array(d_Aptr, d_A);
-  gt::copy(matrix_data_, d_A);
-  gt::blas::getri_batched<T>(h_, n_, gt::raw_pointer_cast(d_Aptr.data()), n_,
-                             gt::raw_pointer_cast(pivot_data_.data()),
-                             gt::raw_pointer_cast(matrix_pointers_.data()), n_,
-                             gt::raw_pointer_cast(info_.data()), nbatches_);
+  detail::copy_batch_data(matrix_batches, d_A);
+  auto getrf_scratch_count =
+    gt::blas::getrf_strided_batched_scratchpad_size<T>(h_, n_, n_, nbatches_);
+  gt::space::device_vector<T> getrf_scratch(getrf_scratch_count);
+  gt::blas::getrf_strided_batched<T>(
+    h_, n_, gt::raw_pointer_cast(d_A.data()), n_,
+    gt::raw_pointer_cast(pivot_data_.data()), nbatches_,
+    gt::raw_pointer_cast(getrf_scratch.data()), getrf_scratch_count);
+
+  // invert using LU factors with getri, which is not in place; the inverse
+  // goes into the matrix_data_ member variable
+  auto getri_scratch_count = gt::blas::getri_strided_batched_scratchpad_size<T>(
+    h_, n_, n_, n_, nbatches_);
+  gt::space::device_vector<T> getri_scratch(getri_scratch_count);
+  gt::blas::getri_strided_batched<T>(
+    h_, n_, gt::raw_pointer_cast(d_A.data()), n_,
+    gt::raw_pointer_cast(pivot_data_.data()),
+    gt::raw_pointer_cast(matrix_data_.data()), n_, nbatches_,
+    gt::raw_pointer_cast(getri_scratch.data()), getri_scratch_count);
   // Note: synchronize so it's safe to destroy temporaries
-  gt::synchronize();
+  h_.get_stream().synchronize();
+}
+
+template <typename T>
+void solver_invert<T>::multiply(const T* rhs, T* result, int nrhs)
+{
+  gt::blas::gemm_strided_batched<T>(
+    h_, n_, nrhs, n_, 1.0, gt::raw_pointer_cast(matrix_data_.data()), n_,
+    n_ * n_, rhs, n_, n_ * nrhs, 0.0, result, n_, n_ * nrhs, nbatches_);
 }
 
 template <typename T>
 void solver_invert<T>::solve(T* rhs, T* result)
 {
-  gt::copy_n(gt::device_pointer_cast(rhs), n_ * nrhs_ * nbatches_,
-             rhs_input_data_.data());
-  gt::blas::gemm_batched<T>(
-    h_, n_, nrhs_, n_, 1.0, gt::raw_pointer_cast(matrix_pointers_.data()), n_,
-    gt::raw_pointer_cast(rhs_input_pointers_.data()), n_, 0.0,
-    gt::raw_pointer_cast(rhs_pointers_.data()), n_, nbatches_);
-  gt::copy_n(rhs_data_.data(), n_ * nrhs_ * nbatches_,
-             gt::device_pointer_cast(result));
+  auto shape = gt::shape(n_, nrhs_, nbatches_);
+  solve(const_span_type(gt::adapt_device(rhs, shape)),
+        gt::adapt_device(result, shape));
+}
+
+template <typename T>
+void solver_invert<T>::solve(const_span_type rhs, span_type result)
+{
+  detail::check_rhs_shape(rhs, result, n_, nrhs_, nbatches_);
+  int nrhs = rhs.shape(1);
+  auto c = detail::packed_span(rhs_data_, n_, nrhs, nbatches_);
+  auto stream = h_.get_stream();
+  // gemm is not in place, rhs_data_ is used for either the input or the
+  // output where needed; rhs is fully read before result is written
+  // otherwise
+  if (rhs.is_f_contiguous()) {
+    if (result.is_f_contiguous() &&
+        detail::get_overlap(rhs, result) == detail::overlap::none) {
+      multiply(gt::raw_pointer_cast(rhs.data()),
+               gt::raw_pointer_cast(result.data()), nrhs);
+    } else {
+      multiply(gt::raw_pointer_cast(rhs.data()),
+               gt::raw_pointer_cast(c.data()), nrhs);
+      gt::assign(result, c, stream);
+    }
+  } else if (result.is_f_contiguous()) {
+    gt::assign(c, rhs, stream);
+    multiply(gt::raw_pointer_cast(c.data()),
+             gt::raw_pointer_cast(result.data()), nrhs);
+  } else {
+    // Note: neither is contiguous, needs a second buffer
+    gt::gtensor_device<T, 3> b(c.shape());
+    gt::assign(b, rhs, stream);
+    multiply(gt::raw_pointer_cast(b.data()), gt::raw_pointer_cast(c.data()),
+             nrhs);
+    gt::assign(result, c, stream);
+  }
+}
+
+template <typename T>
+void solver_invert<T>::solve_inplace(span_type rhs)
+{
+  solve(const_span_type(rhs), rhs);
 }
 
 template <typename T>
 std::size_t solver_invert<T>::get_device_memory_usage()
 {
-  size_t nelements =
-    matrix_data_.size() + rhs_data_.size() + rhs_input_data_.size();
+  size_t nelements = matrix_data_.size() + rhs_data_.size();
   size_t nindex = pivot_data_.size();
-  size_t nptr =
-    matrix_pointers_.size() + rhs_pointers_.size() + rhs_input_pointers_.size();
-  return nelements * sizeof(T) + nindex * sizeof(gt::blas::index_t) +
-         nptr * sizeof(T*) + info_.size() * sizeof(int);
+  return nelements * sizeof(T) + nindex * sizeof(gt::blas::index_t);
 }
 
 template class solver_invert<float>;
@@ -232,45 +364,82 @@ template class solver_invert<gt::complex<double>>;
 template <typename T>
 solver_sparse<T>::solver_sparse(gt::blas::handle_t& blas_h, int n, int nbatches,
                                 int nrhs, T* const* matrix_batches)
-  : n_(n),
+  : h_(blas_h),
+    n_(n),
     nbatches_(nbatches),
     nrhs_(nrhs),
     csr_mat_(lu_factor_batches_to_csr(blas_h, n, nbatches, matrix_batches)),
-    csr_mat_lu_(csr_mat_, T(1.0), nrhs)
+    csr_mat_lu_(csr_mat_, T(1.0), nrhs, blas_h.get_stream())
 {}
 
+template <typename T>
+void solver_sparse<T>::update_matrices(T* const* matrix_batches)
+{
+  auto matrix_data =
+    detail::lu_factor_npvt_batches(h_, n_, nbatches_, matrix_batches);
+  csr_mat_.update_batches(matrix_data);
+  h_.get_stream().synchronize();
+  csr_mat_lu_.update();
+}
+
 template <typename T>
 void solver_sparse<T>::solve(T* rhs, T* result)
 {
   csr_mat_lu_.solve(rhs, result);
 }
 
+template <typename T>
+void solver_sparse<T>::solve(const_span_type rhs, span_type result)
+{
+  detail::check_rhs_shape(rhs, result, n_, nrhs_, nbatches_);
+  // the sparse solve copies rhs into its own buffer first, so rhs and
+  // result may overlap. With a single right hand side, the layouts agree.
+  if (nrhs_ == 1 && rhs.is_f_contiguous() && result.is_f_contiguous()) {
+    // Note: the backends only read rhs
+    csr_mat_lu_.solve(const_cast<T*>(gt::raw_pointer_cast(rhs.data())),
+                      gt::raw_pointer_cast(result.data()));
+    return;
+  }
+  // otherwise the sparse solve is for all nrhs_ right hand sides of the
+  // block diagonal matrix, n x nbatches x nrhs_; unused ones are solved,
+  // too, but not copied back
+  int nrhs = rhs.shape(1);
+  auto stream = h_.get_stream();
+  if (rhs_data_.size() == 0) {
+    rhs_data_ = gt::empty_device<T>({n_, nbatches_, nrhs_});
+  }
+  if (nrhs < nrhs_) {
+    gt::assign(rhs_data_, gt::scalar(T(0)), stream);
+  }
+  auto b = rhs_data_.view(gt::all, gt::all, gt::slice(0, nrhs));
+  gt::assign(b, gt::transpose(rhs, gt::shape(0, 2, 1)), stream);
+  T* data = gt::raw_pointer_cast(rhs_data_.data());
+  csr_mat_lu_.solve(data, data);
+  auto x = gt::transpose(result, gt::shape(0, 2, 1));
+  gt::assign(x, b, stream);
+}
+
+template <typename T>
+void solver_sparse<T>::solve_inplace(span_type rhs)
+{
+  solve(const_span_type(rhs), rhs);
+}
+
 template <typename T>
 std::size_t solver_sparse<T>::get_device_memory_usage()
 {
-  return csr_mat_lu_.get_device_memory_usage();
+  return csr_mat_lu_.get_device_memory_usage() + rhs_data_.size() * sizeof(T);
 }
 
+
 template <typename T>
 gt::sparse::csr_matrix<T, gt::space::device>
 solver_sparse<T>::lu_factor_batches_to_csr(gt::blas::handle_t& h, int n,
                                            int nbatches,
                                            T* const* matrix_batches)
 {
-  // temporary arrays to do dense factoring in contiguous device memory
-  gt::gtensor_device<T, 3> matrix_data(gt::shape(n, n, nbatches));
-  gt::gtensor_device<T*, 1> matrix_pointers(gt::shape(nbatches));
-  gt::gtensor_device<int, 1> info(gt::shape(nbatches));
-
-  // copy non-contiguous host memory to contiguous device memory
-  detail::copy_batch_data(matrix_batches, matrix_data);
-  detail::init_device_pointer_array(matrix_pointers, matrix_data);
-
-  // dense LU factor without pivot
-  gt::blas::getrf_npvt_batched<T>(
-    h, n, gt::raw_pointer_cast(matrix_pointers.data()), n,
-    gt::raw_pointer_cast(info.data()), nbatches);
-  gt::synchronize();
+  auto matrix_data =
+    detail::lu_factor_npvt_batches(h, n, nbatches, matrix_batches);
 
   // convert to single sparse CSR format matrix, with each batch matrix
   // along the diagonal
@@ -282,11 +451,448 @@ template class solver_sparse<float>;
 template class solver_sparse<double>;
 
 // Note: oneMKL sparse API does not support complex yet
-#if defined(GTENSOR_DEVICE_CUDA) || defined(GTENSOR_DEVICE_HIP)
+#ifndef GTENSOR_DEVICE_SYCL
 template class solver_sparse<gt::complex<float>>;
 template class solver_sparse<gt::complex<double>>;
 #endif
 
+template <typename T>
+solver_mixed<T>::solver_mixed(gt::blas::handle_t& h, int n, int nbatches,
+                              int nrhs, T* const* matrix_batches,
+                              int max_iterations, real_type tolerance)
+  : h_(h),
+    n_(n),
+    nbatches_(nbatches),
+    nrhs_(nrhs),
+    max_iterations_(max_iterations),
+    tolerance_(tolerance > 0
+                 ? tolerance
+                 : std::sqrt(real_type(n)) *
+                     std::numeric_limits<real_type>::epsilon()),
+    iterations_(0),
+    n_fallback_(0),
+    matrix_data_(gt::shape(n, n, nbatches)),
+    lu_data_(gt::shape(n, n, nbatches)),
+    pivot_data_(gt::shape(n, nbatches)),
+    rhs_data_(gt::shape(n, nrhs, nbatches)),
+    x_data_(gt::shape(n, nrhs, nbatches)),
+    residual_data_(gt::shape(n, nrhs, nbatches)),
+    correction_data_(gt::shape(n, nrhs, nbatches)),
+    norm_data_(gt::shape(nbatches)),
+    error_data_(gt::shape(nbatches)),
+    fallback_batches_(gt::shape(nbatches)),
+    h_fallback_batches_(gt::shape(nbatches)),
+    scratch_count_(gt::blas::getrs_strided_batched_scratchpad_size<low_type>(
+      h, n, nrhs, n, n, nbatches)),
+    scratch_(scratch_count_),
+    fallback_scratch_count_(0)
+{
+  update_matrices(matrix_batches);
+}
+
+template <typename T>
+void solver_mixed<T>::update_matrices(T* const* matrix_batches)
+{
+  int n = n_;
+  n_fallback_ = 0;
+  gt::assign(fallback_batches_, gt::scalar(0), h_.get_stream());
+  gt::assign(h_fallback_batches_, gt::scalar(0));
+  // the double precision factors are out of date
+  fallback_lu_data_ = gt::gtensor_device<T, 3>();
+  fallback_pivot_data_ = gt::gtensor_device<gt::blas::index_t, 2>();
+  fallback_scratch_count_ = 0;
+  fallback_scratch_.resize(0);
+  detail::copy_batch_data(matrix_batches, matrix_data_);
+
+  auto k_matrix = matrix_data_.to_kernel();
+  auto k_lu = lu_data_.to_kernel();
+  auto k_norm = norm_data_.to_kernel();
+  gt::launch<3>(
+    lu_data_.shape(), GT_LAMBDA(int i, int j, int b) {
+      k_lu(i, j, b) = low_type(k_matrix(i, j, b));
+    },
+    h_.get_stream());
+  // infinity norm, max row sum
+  gt::launch<1>(
+    norm_data_.shape(), GT_LAMBDA(int b) {
+      real_type norm = 0;
+      for (int i = 0; i < n; i++) {
+        real_type row = 0;
+        for (int j = 0; j < n; j++) {
+          row += gt::abs(k_matrix(i, j, b));
+        }
+        norm = row > norm ? row : norm;
+      }
+      k_norm(b) = norm;
+    },
+    h_.get_stream());
+
+  auto prep_scratch_count =
+    gt::blas::getrf_strided_batched_scratchpad_size<low_type>(h_, n_, n_,
+                                                              nbatches_);
+  gt::space::device_vector<low_type> prep_scratch(prep_scratch_count);
+  gt::gtensor_device<int, 1> info(gt::shape(nbatches_));
+  gt::blas::getrf_strided_batched<low_type>(
+    h_, n_, gt::raw_pointer_cast(lu_data_.data()), n_,
+    gt::raw_pointer_cast(pivot_data_.data()), nbatches_,
+    gt::raw_pointer_cast(prep_scratch.data()), prep_scratch_count,
+    gt::raw_pointer_cast(info.data()));
+
+  // matrices that are singular in single precision cannot be refined, they
+  // use the double precision factorization right away
+  auto k_info = info.to_kernel();
+  auto k_fallback = fallback_batches_.to_kernel();
+  gt::launch<1>(
+    fallback_batches_.shape(), GT_LAMBDA(int b) {
+      if (k_info(b) > 0) {
+        k_fallback(b) = 1;
+      }
+    },
+    h_.get_stream());
+  // Note: synchronizes, so it's safe to destroy scratch and info
+  count_fallback_batches();
+}
+
+template <typename T>
+void solver_mixed<T>::solve(T* rhs, T* result)
+{
+  auto shape = gt::shape(n_, nrhs_, nbatches_);
+  solve(const_span_type(gt::adapt_device(rhs, shape)),
+        gt::adapt_device(result, shape));
+}
+
+template <typename T>
+void solver_mixed<T>::solve(const_span_type rhs, span_type result)
+{
+  detail::check_rhs_shape(rhs, result, n_, nrhs_, nbatches_);
+  int nrhs = rhs.shape(1);
+  // rhs is copied before result is written, so they may overlap
+  auto b = detail::packed_span(rhs_data_, n_, nrhs, nbatches_);
+  gt::assign(b, rhs, h_.get_stream());
+  auto x = gt::adapt_device(solve_packed(nrhs), b.shape());
+  gt::assign(result, x, h_.get_stream());
+}
+
+template <typename T>
+void solver_mixed<T>::solve_inplace(span_type rhs)
+{
+  // Note: refinement needs the original rhs, so it is copied anyway
+  solve(const_span_type(rhs), rhs);
+}
+
+// solves for the nrhs right hand sides at the start of rhs_data_, returns
+// the solution in x_data_
+template <typename T>
+T* solver_mixed<T>::solve_packed(int nrhs)
+{
+  auto b = detail::packed_span(rhs_data_, n_, nrhs, nbatches_);
+  auto x = detail::packed_span(x_data_, n_, nrhs, nbatches_);
+  auto r = detail::packed_span(residual_data_, n_, nrhs, nbatches_);
+  auto d = detail::packed_span(correction_data_, n_, nrhs, nbatches_);
+  auto k_x = x.to_kernel();
+  auto k_r = r.to_kernel();
+  auto k_d = d.to_kernel();
+  auto stream = h_.get_stream();
+  iterations_ = 0;
+
+  // x = 0, r = b
+  gt::assign(x, gt::scalar(T(0)), stream);
+  gt::assign(r, b, stream);
+  if (n_fallback_ < nbatches_) {
+    // Note: written so that a NaN error, e.g. inf / inf after the single
+    // precision solve overflowed, does not count as converged
+    real_type err = max_backward_error(nrhs);
+    while (!(err <= tolerance_) && iterations_ < max_iterations_) {
+      // solve A d = r in single precision, x += d
+      gt::launch<3>(
+        d.shape(), GT_LAMBDA(int i, int j, int b) {
+          k_d(i, j, b) = low_type(k_r(i, j, b));
+        },
+        stream);
+      gt::blas::getrs_strided_batched<low_type>(
+        h_, n_, nrhs, gt::raw_pointer_cast(lu_data_.data()), n_,
+        gt::raw_pointer_cast(pivot_data_.data()),
+        gt::raw_pointer_cast(d.data()), n_, nbatches_,
+        gt::raw_pointer_cast(scratch_.data()), scratch_count_);
+      gt::launch<3>(
+        x.shape(), GT_LAMBDA(int i, int j, int b) {
+          k_x(i, j, b) += T(k_d(i, j, b));
+        },
+        stream);
+      iterations_++;
+
+      // r = b - A x in double precision
+      gt::assign(r, b, stream);
+      gt::blas::gemm_strided_batched<T>(
+        h_, n_, nrhs, n_, T(-1), gt::raw_pointer_cast(matrix_data_.data()),
+        n_, n_ * n_, gt::raw_pointer_cast(x.data()), n_, n_ * nrhs, T(1),
+        gt::raw_pointer_cast(r.data()), n_, n_ * nrhs, nbatches_);
+      err = max_backward_error(nrhs);
+    }
+    if (!(err <= tolerance_)) {
+      update_fallback_batches();
+    }
+  }
+
+  if (n_fallback_ > 0) {
+    if (fallback_lu_data_.size() == 0) {
+      factor_fallback();
+    }
+    // solve all batches in double precision, but only take the solution of
+    // those that did not converge
+    gt::assign(r, b, stream);
+    gt::blas::getrs_strided_batched<T>(
+      h_, n_, nrhs, gt::raw_pointer_cast(fallback_lu_data_.data()), n_,
+      gt::raw_pointer_cast(fallback_pivot_data_.data()),
+      gt::raw_pointer_cast(r.data()), n_, nbatches_,
+      gt::raw_pointer_cast(fallback_scratch_.data()), fallback_scratch_count_);
+    auto k_fallback = fallback_batches_.to_kernel();
+    gt::launch<3>(
+      x.shape(), GT_LAMBDA(int i, int j, int b) {
+        if (k_fallback(b)) {
+          k_x(i, j, b) = k_r(i, j, b);
+        }
+      },
+      stream);
+  }
+  return gt::raw_pointer_cast(x.data());
+}
+
+// max over the batches that still use refinement
+template <typename T>
+typename solver_mixed<T>::real_type solver_mixed<T>::max_backward_error(
+  int nrhs)
+{
+  int n = n_;
+  real_type inf = std::numeric_limits<real_type>::infinity();
+  auto k_x = detail::packed_span(x_data_, n_, nrhs, nbatches_).to_kernel();
+  auto k_residual =
+    detail::packed_span(residual_data_, n_, nrhs, nbatches_).to_kernel();
+  auto k_norm = norm_data_.to_kernel();
+  auto k_error = error_data_.to_kernel();
+  auto k_fallback = fallback_batches_.to_kernel();
+  gt::launch<1>(
+    error_data_.shape(), GT_LAMBDA(int b) {
+      real_type rmax = 0;
+      real_type xmax = 0;
+      for (int j = 0; j < nrhs; j++) {
+        for (int i = 0; i < n; i++) {
+          real_type r = gt::abs(k_residual(i, j, b));
+          real_type x = gt::abs(k_x(i, j, b));
+          rmax = r > rmax ? r : rmax;
+          xmax = x > xmax ? x : xmax;
+          // a failed single precision factorization gives NaN
+          if (r != r || x != x) {
+            rmax = inf;
+          }
+        }
+      }
+      real_type error = rmax == 0 ? 0 : rmax / (k_norm(b) * xmax);
+      k_error(b) = k_fallback(b) ? 0 : error;
+    },
+    h_.get_stream());
+  return gt::max(error_data_, h_.get_stream());
+}
+
+// flags the batches whose last backward error is above the tolerance
+template <typename T>
+void solver_mixed<T>::update_fallback_batches()
+{
+  real_type tolerance = tolerance_;
+  auto k_error = error_data_.to_kernel();
+  auto k_fallback = fallback_batches_.to_kernel();
+  gt::launch<1>(
+    fallback_batches_.shape(), GT_LAMBDA(int b) {
+      if (!(k_error(b) <= tolerance)) {
+        k_fallback(b) = 1;
+      }
+    },
+    h_.get_stream());
+  count_fallback_batches();
+}
+
+// copies the fallback flags to the host and counts them
+template <typename T>
+void solver_mixed<T>::count_fallback_batches()
+{
+  h_.get_stream().synchronize();
+  gt::copy(fallback_batches_, h_fallback_batches_);
+  n_fallback_ = 0;
+  for (int b = 0; b < nbatches_; b++) {
+    n_fallback_ += h_fallback_batches_(b) != 0;
+  }
+}
+
+template <typename T>
+void solver_mixed<T>::factor_fallback()
+{
+  // matrix_data_ is still needed for the residuals of the other batches, so
+  // factor a copy
+  fallback_lu_data_ = matrix_data_;
+  fallback_pivot_data_ =
+    gt::gtensor_device<gt::blas::index_t, 2>(pivot_data_.shape());
+  auto prep_scratch_count =
+    gt::blas::getrf_strided_batched_scratchpad_size<T>(h_, n_, n_, nbatches_);
+  gt::space::device_vector<T> prep_scratch(prep_scratch_count);
+  gt::blas::getrf_strided_batched<T>(
+    h_, n_, gt::raw_pointer_cast(fallback_lu_data_.data()), n_,
+    gt::raw_pointer_cast(fallback_pivot_data_.data()), nbatches_,
+    gt::raw_pointer_cast(prep_scratch.data()), prep_scratch_count);
+
+  fallback_scratch_count_ = gt::blas::getrs_strided_batched_scratchpad_size<T>(
+    h_, n_, nrhs_, n_, n_, nbatches_);
+  fallback_scratch_.resize(fallback_scratch_count_);
+  // Note: synchronize so it's safe to destroy scratch
+  h_.get_stream().synchronize();
+}
+
+template <typename T>
+std::size_t solver_mixed<T>::get_device_memory_usage()
+{
+  size_t nelements = matrix_data_.size() + rhs_data_.size() + x_data_.size() +
+                     residual_data_.size() + fallback_lu_data_.size() +
+                     fallback_scratch_.size();
+  size_t nlow = lu_data_.size() + correction_data_.size() + scratch_count_;
+  size_t nreal = norm_data_.size() + error_data_.size();
+  size_t nindex = pivot_data_.size() + fallback_pivot_data_.size();
+  return nelements * sizeof(T) + nlow * sizeof(low_type) +
+         nreal * sizeof(real_type) + nindex * sizeof(gt::blas::index_t) +
+         fallback_batches_.size() * sizeof(int);
+}
+
+template class solver_mixed<double>;
+template class solver_mixed<gt::complex<double>>;
+
+template <typename T>
+solver_sparse_batch<T>::solver_sparse_batch(gt::blas::handle_t& h, int n,
+                                            int nbatches, int nrhs,
+                                            T* const* matrix_batches)
+  : h_(h),
+    n_(n),
+    nbatches_(nbatches),
+    nrhs_(nrhs),
+    csr_mat_(lu_factor_batches(h, n, nbatches, matrix_batches)),
+    diag_ind_(gt::shape(n)),
+    rhs_data_(gt::shape(n, nrhs, nbatches))
+{
+  // column indices are sorted within a row, find the diagonal
+  const int* row_ptr = csr_mat_.row_ptr_data();
+  const int* col_ind = csr_mat_.col_ind_data();
+  auto k_diag_ind = diag_ind_.to_kernel();
+  gt::launch<1>(
+    gt::shape(n), GT_LAMBDA(int i) {
+      int idx = row_ptr[i];
+      while (idx < row_ptr[i + 1] - 1 && col_ind[idx] < i) {
+        idx++;
+      }
+      k_diag_ind(i) = idx;
+    },
+    h_.get_stream());
+  h_.get_stream().synchronize();
+}
+
+template <typename T>
+void solver_sparse_batch<T>::update_matrices(T* const* matrix_batches)
+{
+  auto matrix_data =
+    detail::lu_factor_npvt_batches(h_, n_, nbatches_, matrix_batches);
+  csr_mat_.update(matrix_data);
+  // Note: synchronize so it's safe to destroy matrix_data
+  h_.get_stream().synchronize();
+}
+
+template <typename T>
+void solver_sparse_batch<T>::solve(T* rhs, T* result)
+{
+  auto shape = gt::shape(n_, nrhs_, nbatches_);
+  solve(const_span_type(gt::adapt_device(rhs, shape)),
+        gt::adapt_device(result, shape));
+}
+
+template <typename T>
+void solver_sparse_batch<T>::solve(const_span_type rhs, span_type result)
+{
+  detail::check_rhs_shape(rhs, result, n_, nrhs_, nbatches_);
+  int nrhs = rhs.shape(1);
+  auto overlap = detail::get_overlap(rhs, result);
+  auto stream = h_.get_stream();
+  if (result.is_f_contiguous() && overlap != detail::overlap::partial) {
+    if (overlap == detail::overlap::none) {
+      gt::assign(result, rhs, stream);
+    }
+    solve_contiguous(gt::raw_pointer_cast(result.data()), nrhs);
+  } else {
+    auto x = detail::packed_span(rhs_data_, n_, nrhs, nbatches_);
+    gt::assign(x, rhs, stream);
+    solve_contiguous(gt::raw_pointer_cast(x.data()), nrhs);
+    gt::assign(result, x, stream);
+  }
+}
+
+template <typename T>
+void solver_sparse_batch<T>::solve_inplace(span_type rhs)
+{
+  solve(const_span_type(rhs), rhs);
+}
+
+// solves in place for the packed (n, nrhs, nbatches) right hand sides in rhs
+template <typename T>
+void solver_sparse_batch<T>::solve_contiguous(T* rhs, int nrhs)
+{
+  int n = n_;
+  index_t nnz = csr_mat_.nnz();
+  const int* row_ptr = csr_mat_.row_ptr_data();
+  const int* col_ind = csr_mat_.col_ind_data();
+  const int* diag_ind = gt::raw_pointer_cast(diag_ind_.data());
+  const T* values = csr_mat_.values_data();
+  T* x = rhs;
+
+#ifdef GTENSOR_HAVE_DEVICE
+  gt::launch<2>(
+    gt::shape(nrhs, nbatches_), GT_LAMBDA(int r, int b) {
+      detail::csr_lu_solve(n, row_ptr, col_ind, diag_ind, values + b * nnz,
+                           x + (b * nrhs + r) * n);
+    },
+    h_.get_stream());
+#else
+  h_.wait_for_stream();
+  h_.parallel_batch(nbatches_, [&](int begin, int end) {
+    for (int b = begin; b < end; b++) {
+      for (int r = 0; r < nrhs; r++) {
+        detail::csr_lu_solve(n, row_ptr, col_ind, diag_ind, values + b * nnz,
+                             x + (b * nrhs + r) * n);
+      }
+    }
+  });
+#endif
+}
+
+template <typename T>
+std::size_t solver_sparse_batch<T>::get_device_memory_usage()
+{
+  size_t nelements = size_t(csr_mat_.nnz()) * nbatches_ + rhs_data_.size();
+  size_t nint = csr_mat_.nnz() + n_ + 1 + diag_ind_.size();
+  return nelements * sizeof(T) + nint * sizeof(int);
+}
+
+template <typename T>
+gt::sparse::csr_matrix_batch<T, gt::space::device>
+solver_sparse_batch<T>::lu_factor_batches(gt::blas::handle_t& h, int n,
+                                          int nbatches,
+                                          T* const* matrix_batches)
+{
+  auto matrix_data =
+    detail::lu_factor_npvt_batches(h, n, nbatches, matrix_batches);
+
+  // the nonzero pattern of the factors is shared by all batches
+  return gt::sparse::csr_matrix_batch<T, gt::space::device>(matrix_data);
+}
+
+template class solver_sparse_batch<float>;
+template class solver_sparse_batch<double>;
+template class solver_sparse_batch<gt::complex<float>>;
+template class solver_sparse_batch<gt::complex<double>>;
+
 } // namespace solver
 
 } // namespace gt
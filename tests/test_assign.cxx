@@ -81,8 +81,101 @@ TEST(assign, broadcast_6d)
   }
 }
 
+TEST(assign, view_noncontiguous_5d)
+{
+  // host assign walks lhs and rhs with cursors, exercise reversed, strided and
+  // broadcast views as well as a non-strided expression (generator)
+  auto shape = gt::shape(5, 3, 4, 2, 3);
+  gt::gtensor<double, 5> a(shape);
+  gt::gtensor<double, 5> b(shape, 0.);
+  gt::gtensor<double, 5> expected(shape);
+
+  auto gen = gt::generator<5, double>(
+    shape, [](int i, int j, int k, int l, int m) {
+      return i + 10. * j + 100. * k + 1000. * l + 10000. * m;
+    });
+  gt::assign(a, gen);
+  for (int m = 0; m < shape[4]; m++) {
+    for (int l = 0; l < shape[3]; l++) {
+      for (int k = 0; k < shape[2]; k++) {
+        for (int j = 0; j < shape[1]; j++) {
+          for (int i = 0; i < shape[0]; i++) {
+            expected(i, j, k, l, m) =
+              i + 10. * j + 100. * k + 1000. * l + 10000. * m;
+          }
+        }
+      }
+    }
+  }
+  EXPECT_EQ(a, expected);
+
+  // reversed first dim on the rhs, every other element of the first dim
+  // on the lhs
+  auto bv = b.view(gt::slice(0, 5, 2));
+  bv = 2. * a.view(gt::slice(4, gt::none, -2));
+  for (int m = 0; m < shape[4]; m++) {
+    for (int l = 0; l < shape[3]; l++) {
+      for (int k = 0; k < shape[2]; k++) {
+        for (int j = 0; j < shape[1]; j++) {
+          EXPECT_EQ(b(0, j, k, l, m), 2. * a(4, j, k, l, m));
+          EXPECT_EQ(b(1, j, k, l, m), 0.);
+          EXPECT_EQ(b(2, j, k, l, m), 2. * a(2, j, k, l, m));
+          EXPECT_EQ(b(4, j, k, l, m), 2. * a(0, j, k, l, m));
+        }
+      }
+    }
+  }
+
+  // broadcast a single slab along the second dim via a view
+  auto c = gt::empty_like(a);
+  gt::assign(c, a.view(gt::all, 1, gt::newaxis) + gt::scalar(1.));
+  for (int m = 0; m < shape[4]; m++) {
+    for (int l = 0; l < shape[3]; l++) {
+      for (int k = 0; k < shape[2]; k++) {
+        for (int j = 0; j < shape[1]; j++) {
+          for (int i = 0; i < shape[0]; i++) {
+            EXPECT_EQ(c(i, j, k, l, m), a(i, 1, k, l, m) + 1.);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(assign, masked)
+{
+  gt::gtensor<double, 1> a({1., -2., 3., -4.});
+  gt::gtensor<double, 1> b({10., 20., 30., 40.});
+
+  gt::assign_masked(a, a < 0., b);
+  EXPECT_EQ(a, (gt::gtensor<double, 1>{1., 20., 3., 40.}));
+
+  gt::assign_masked(a, a > 10., 0.);
+  EXPECT_EQ(a, (gt::gtensor<double, 1>{1., 0., 3., 0.}));
+}
+
+TEST(assign, masked_view_broadcast)
+{
+  gt::gtensor<int, 2> a(gt::shape(3, 2), 1);
+  gt::gtensor<bool, 1> mask({true, false, true});
+
+  gt::assign_masked(a.view(gt::all, 1), mask, 5);
+  EXPECT_EQ(a, (gt::gtensor<int, 2>{{1, 1, 1}, {5, 1, 5}}));
+}
+
 #ifdef GTENSOR_HAVE_DEVICE
 
+TEST(assign, device_masked)
+{
+  gt::gtensor_device<double, 1> a({1., -2., 3., -4.});
+  gt::gtensor<double, 1> h_a(a.shape());
+
+  gt::assign_masked(a, a < 0., -a);
+  gt::copy(a, h_a);
+
+  EXPECT_EQ(h_a, (gt::gtensor<double, 1>{1., 2., 3., 4.}));
+}
+
 TEST(assign, device_gtensor_6d)
 {
   gt::gtensor_device<int, 6> a(gt::shape(2, 3, 4, 5, 6, 7));
@@ -817,3 +817,192 @@ TEST(bandsolve, zfull_invert_solve_new_stream)
   gt::stream s;
   test_full_solve_real<gt::complex<double>>(s.get_view());
 }
+
+// small diagonal, so that pivoting within the band is needed and U gets
+// fill-in beyond ubw. With compact, the matrices are factored in band
+// storage instead of in place.
+template <typename T>
+void test_getrf_banded_batch(bool compact = false)
+{
+  constexpr int N = 16;
+  constexpr int NRHS = 2;
+  constexpr int batch_size = 3;
+  constexpr int lbw = 2;
+  constexpr int ubw = 1;
+
+  gt::gtensor<T, 3> h_A(gt::shape(N, N, batch_size));
+  gt::gtensor_device<T, 3> d_A(gt::shape(N, N, batch_size));
+  gt::gtensor<T*, 1> h_Aptr(batch_size);
+  gt::gtensor_device<T*, 1> d_Aptr(batch_size);
+
+  gt::gtensor<T, 3> h_B(gt::shape(N, NRHS, batch_size));
+  gt::gtensor_device<T, 3> d_B(gt::shape(N, NRHS, batch_size));
+  gt::gtensor<T*, 1> h_Bptr(batch_size);
+  gt::gtensor_device<T*, 1> d_Bptr(batch_size);
+  gt::gtensor<T, 3> h_X(gt::shape(N, NRHS, batch_size));
+
+  gt::gtensor<gt::blas::index_t, 2> h_p(gt::shape(N, batch_size));
+  gt::gtensor_device<gt::blas::index_t, 2> d_p(gt::shape(N, batch_size));
+  gt::gtensor<int, 1> h_info(batch_size);
+  gt::gtensor_device<int, 1> d_info(batch_size);
+
+  h_A = gt::scalar(T(0));
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < N; i++) {
+      h_A(i, i, b) = 0.1 * (b + 1);
+      if (i + 1 < N) {
+        h_A(i + 1, i, b) = 2.0 + i % 3;
+        h_A(i, i + 1, b) = 1.0;
+      }
+      if (i + 2 < N) {
+        h_A(i + 2, i, b) = -1.0;
+      }
+    }
+    h_Aptr(b) = gt::raw_pointer_cast(d_A.data()) + b * N * N;
+    h_Bptr(b) = gt::raw_pointer_cast(d_B.data()) + b * N * NRHS;
+  }
+
+  // B = A X
+  h_B = gt::scalar(T(0));
+  for (int b = 0; b < batch_size; b++) {
+    for (int r = 0; r < NRHS; r++) {
+      for (int j = 0; j < N; j++) {
+        h_X(j, r, b) = (r == 0) ? T(j + 1) : T(1.0 - 0.5 * j);
+      }
+      for (int j = 0; j < N; j++) {
+        for (int i = 0; i < N; i++) {
+          h_B(i, r, b) += h_A(i, j, b) * h_X(j, r, b);
+        }
+      }
+    }
+  }
+
+  gt::copy(h_A, d_A);
+  gt::copy(h_Aptr, d_Aptr);
+  gt::copy(h_B, d_B);
+  gt::copy(h_Bptr, d_Bptr);
+
+  gt::blas::handle_t h;
+
+  auto bw = gt::blas::get_max_bandwidth(
+    h, N, gt::raw_pointer_cast(d_Aptr.data()), N, batch_size);
+  EXPECT_EQ(bw.lower, lbw);
+  EXPECT_EQ(bw.upper, ubw);
+
+  if (compact) {
+    gt::blas::band_matrix_batch<T> band(d_A, bw, h.get_stream());
+    EXPECT_EQ(band.ldab(), 2 * lbw + ubw + 1);
+    gt::blas::getrf_banded_batched(h, band, gt::raw_pointer_cast(d_p.data()),
+                                   gt::raw_pointer_cast(d_info.data()));
+    gt::blas::getrs_banded_lu_batched(h, NRHS, band,
+                                      gt::raw_pointer_cast(d_p.data()),
+                                      gt::raw_pointer_cast(d_Bptr.data()), N);
+  } else {
+    gt::blas::getrf_banded_batched(
+      h, N, gt::raw_pointer_cast(d_Aptr.data()), N,
+      gt::raw_pointer_cast(d_p.data()), gt::raw_pointer_cast(d_info.data()),
+      batch_size, bw.lower, bw.upper);
+    gt::blas::getrs_banded_lu_batched(
+      h, N, NRHS, gt::raw_pointer_cast(d_Aptr.data()), N,
+      gt::raw_pointer_cast(d_p.data()), gt::raw_pointer_cast(d_Bptr.data()),
+      N, batch_size, bw.lower, bw.upper);
+  }
+  gt::copy(d_info, h_info);
+  gt::copy(d_p, h_p);
+  gt::copy(d_B, h_B);
+
+  for (int b = 0; b < batch_size; b++) {
+    EXPECT_EQ(h_info(b), 0);
+  }
+  EXPECT_NE(h_p(0, 0), 1);
+  GT_EXPECT_NEAR_ARRAY_ERR(h_B, h_X,
+                           1000 * gt::test::detail::max_err<T>::value);
+}
+
+TEST(bandsolve, sgetrf_banded_batch) { test_getrf_banded_batch<float>(); }
+
+TEST(bandsolve, dgetrf_banded_batch) { test_getrf_banded_batch<double>(); }
+
+TEST(bandsolve, cgetrf_banded_batch)
+{
+  test_getrf_banded_batch<gt::complex<float>>();
+}
+
+TEST(bandsolve, zgetrf_banded_batch)
+{
+  test_getrf_banded_batch<gt::complex<double>>();
+}
+
+TEST(bandsolve, dgetrf_banded_compact_batch)
+{
+  test_getrf_banded_batch<double>(true);
+}
+
+TEST(bandsolve, zgetrf_banded_compact_batch)
+{
+  test_getrf_banded_batch<gt::complex<double>>(true);
+}
+
+TEST(bandsolve, band_matrix_batch_from_dense)
+{
+  constexpr int N = 5;
+  constexpr int batch_size = 2;
+  gt::blas::matrix_bandwidth bw{1, 2};
+
+  gt::gtensor<double, 3> h_A(gt::shape(N, N, batch_size));
+  h_A = gt::scalar(0.0);
+  for (int b = 0; b < batch_size; b++) {
+    for (int j = 0; j < N; j++) {
+      int imin = std::max(0, j - bw.upper);
+      int imax = std::min(N - 1, j + bw.lower);
+      for (int i = imin; i <= imax; i++) {
+        h_A(i, j, b) = 100 * b + 10 * i + j + 1;
+      }
+    }
+  }
+
+  gt::blas::band_matrix_batch<double, gt::space::host> band(h_A, bw);
+  EXPECT_EQ(band.n(), N);
+  EXPECT_EQ(band.nbatches(), batch_size);
+  EXPECT_EQ(band.ldab(), 5);
+
+  // fill-in row, then A(j - 2, j), A(j - 1, j), A(j, j), A(j + 1, j)
+  gt::gtensor<double, 2> h_expected(gt::shape(5, N));
+  h_expected = gt::scalar(0.0);
+  for (int j = 0; j < N; j++) {
+    for (int r = 1; r < 5; r++) {
+      int i = r - 3 + j;
+      if (i >= 0 && i < N) {
+        h_expected(r, j) = 100 + h_A(i, j, 0);
+      }
+    }
+  }
+  GT_EXPECT_NEAR_ARRAY(band.data().view(gt::all, gt::all, 1), h_expected);
+  EXPECT_EQ(band.batch_data(1), &band.data()(0, 0, 1));
+
+  // factor and solve in host space, for x = ones
+  gt::gtensor<gt::blas::index_t, 2> h_piv(gt::shape(N, batch_size));
+  gt::gtensor<int, 1> h_info(gt::shape(batch_size));
+  gt::gtensor<double, 2> h_B(gt::shape(N, batch_size), 0.0);
+  gt::gtensor<double*, 1> h_Bptr(gt::shape(batch_size));
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        h_B(i, b) += h_A(i, j, b);
+      }
+    }
+    h_Bptr(b) = &h_B(0, b);
+  }
+  gt::blas::handle_t h;
+  gt::blas::getrf_banded_batched(h, band, h_piv.data(), h_info.data());
+  gt::blas::getrs_banded_lu_batched(h, 1, band, h_piv.data(), h_Bptr.data(),
+                                    N);
+  for (int b = 0; b < batch_size; b++) {
+    EXPECT_EQ(h_info(b), 0);
+  }
+  gt::gtensor<double, 2> h_x(h_B.shape(), 1.0);
+  GT_EXPECT_NEAR_ARRAY(h_B, h_x);
+
+  gt::gtensor<double, 3> h_A1(gt::shape(N, N, 1));
+  EXPECT_THROW(band.update(h_A1), std::runtime_error);
+}
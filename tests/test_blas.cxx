@@ -423,6 +423,68 @@ TEST(blas, sgemm_batched) { test_gemm_batched_real<float>(); }
 
 TEST(blas, dgemm_batched) { test_gemm_batched_real<double>(); }
 
+template <typename T>
+void test_gemm_strided_batched()
+{
+  constexpr int M = 3, K = 2, N = 4;
+  constexpr int batch_size = 5;
+
+  gt::gtensor<T, 3> h_A(gt::shape(M, K, batch_size));
+  gt::gtensor<T, 3> h_B(gt::shape(K, N, batch_size));
+  gt::gtensor<T, 3> h_C(gt::shape(M, N, batch_size));
+  for (int t = 0; t < batch_size; t++) {
+    for (int k = 0; k < K; k++) {
+      for (int i = 0; i < M; i++) {
+        h_A(i, k, t) = T(i + 2 * k + t);
+      }
+      for (int j = 0; j < N; j++) {
+        h_B(k, j, t) = T(k - j + t);
+      }
+    }
+    for (int j = 0; j < N; j++) {
+      for (int i = 0; i < M; i++) {
+        h_C(i, j, t) = T(i * j);
+      }
+    }
+  }
+  auto d_A = gt::empty_device<T>(h_A.shape());
+  auto d_B = gt::empty_device<T>(h_B.shape());
+  auto d_C = gt::empty_device<T>(h_C.shape());
+  gt::copy(h_A, d_A);
+  gt::copy(h_B, d_B);
+  gt::copy(h_C, d_C);
+
+  T a = T(0.5);
+  T b = T(-1.0);
+  gt::blas::handle_t h;
+  gt::blas::gemm_strided_batched<T>(
+    h, M, N, K, a, gt::raw_pointer_cast(d_A.data()), M, M * K,
+    gt::raw_pointer_cast(d_B.data()), K, K * N, b,
+    gt::raw_pointer_cast(d_C.data()), M, M * N, batch_size);
+
+  gt::gtensor<T, 3> h_C_result(h_C.shape());
+  gt::copy(d_C, h_C_result);
+  for (int t = 0; t < batch_size; t++) {
+    for (int j = 0; j < N; j++) {
+      for (int i = 0; i < M; i++) {
+        T sum = 0;
+        for (int k = 0; k < K; k++) {
+          sum += h_A(i, k, t) * h_B(k, j, t);
+        }
+        EXPECT_EQ(h_C_result(i, j, t), a * sum + b * h_C(i, j, t))
+          << "i = " << i << " j = " << j << " t = " << t;
+      }
+    }
+  }
+}
+
+TEST(blas, sgemm_strided_batched) { test_gemm_strided_batched<float>(); }
+
+TEST(blas, zgemm_strided_batched)
+{
+  test_gemm_strided_batched<gt::complex<double>>();
+}
+
 template <typename R>
 void test_gemm_batched_complex()
 {
@@ -107,6 +107,35 @@ TEST(device_backend, managed_prefetch)
   allocator::deallocate(a);
 }
 
+TEST(device_backend, managed_prefetch_advise_stream)
+{
+  using managed_vector = gt::space::managed_vector<double>;
+  gt::gtensor_container<managed_vector, 2> a(gt::shape(N, 4));
+  gt::stream stream;
+
+  gt::advise(a, gt::memory_advice::preferred_location_device);
+  gt::prefetch_host(a, stream.get_view());
+  stream.synchronize();
+  for (int j = 0; j < a.shape(1); j++) {
+    for (int i = 0; i < a.shape(0); i++) {
+      a(i, j) = j;
+    }
+  }
+
+  // prefetch only the part the kernel reads
+  auto a_col = gt::view(a, gt::all, 2);
+  gt::advise(a_col, gt::memory_advice::read_mostly);
+  gt::prefetch_device(a_col, stream.get_view());
+  gt::gtensor_device<double, 1> b(gt::shape(N));
+  gt::assign(b, 2. * a_col, stream.get_view());
+  stream.synchronize();
+  gt::advise(a_col, gt::memory_advice::unset_read_mostly);
+
+  gt::gtensor<double, 1> h_b(b.shape());
+  gt::copy(b, h_b);
+  EXPECT_EQ(h_b, gt::full<double>(h_b.shape(), 4.));
+}
+
 TEST(device_backend, get_memory_type)
 {
   gt::backend::host_storage<int> h(1);
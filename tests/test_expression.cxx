@@ -251,6 +251,147 @@ TEST(expression, exp_complex)
   EXPECT_LT(gt::norm_linf(gt::exp(I * t) - ref), 1e-14);
 }
 
+TEST(expression, unary_math_funcs)
+{
+  gt::gtensor<double, 1> t({0.25, 0.5, 1., 4.});
+  gt::gtensor<double, 1> ref(t.shape());
+
+  for (int i = 0; i < t.shape(0); i++) {
+    ref(i) = std::sqrt(t(i));
+  }
+  EXPECT_LT(gt::norm_linf(gt::sqrt(t) - ref), 1e-14);
+
+  for (int i = 0; i < t.shape(0); i++) {
+    ref(i) = std::log(t(i));
+  }
+  EXPECT_LT(gt::norm_linf(gt::log(t) - ref), 1e-14);
+
+  for (int i = 0; i < t.shape(0); i++) {
+    ref(i) = std::tanh(t(i));
+  }
+  EXPECT_LT(gt::norm_linf(gt::tanh(t) - ref), 1e-14);
+
+  for (int i = 0; i < t.shape(0); i++) {
+    ref(i) = std::cbrt(t(i));
+  }
+  EXPECT_LT(gt::norm_linf(gt::cbrt(t) - ref), 1e-14);
+
+  for (int i = 0; i < t.shape(0); i++) {
+    ref(i) = std::log1p(t(i));
+  }
+  EXPECT_LT(gt::norm_linf(gt::log1p(t) - ref), 1e-14);
+
+  EXPECT_EQ(gt::floor(2. * t), (gt::gtensor<double, 1>{0., 1., 2., 8.}));
+}
+
+TEST(expression, sqrt_complex)
+{
+  using T = gt::complex<double>;
+  gt::gtensor<T, 1> t({T(-4., 0.), T(0., 2.)});
+  gt::gtensor<T, 1> ref({T(0., 2.), T(1., 1.)});
+
+  EXPECT_LT(gt::norm_linf(gt::sqrt(t) - ref), 1e-14);
+}
+
+TEST(expression, binary_math_funcs)
+{
+  gt::gtensor<double, 1> a({1., -2., 3., -4.});
+  gt::gtensor<double, 1> b({2., 2., -1., -1.});
+
+  EXPECT_EQ(gt::pow(a, 2), (gt::gtensor<double, 1>{1., 4., 9., 16.}));
+  EXPECT_EQ(gt::pow(2., b), (gt::gtensor<double, 1>{4., 4., 0.5, 0.5}));
+  EXPECT_EQ(gt::minimum(a, b), (gt::gtensor<double, 1>{1., -2., -1., -4.}));
+  EXPECT_EQ(gt::maximum(a, b), (gt::gtensor<double, 1>{2., 2., 3., -1.}));
+  EXPECT_EQ(gt::maximum(a, 0.), (gt::gtensor<double, 1>{1., 0., 3., 0.}));
+  EXPECT_EQ(gt::copysign(b, a), (gt::gtensor<double, 1>{2., -2., 1., -1.}));
+
+  gt::gtensor<double, 1> ref(a.shape());
+  for (int i = 0; i < a.shape(0); i++) {
+    ref(i) = std::atan2(a(i), b(i));
+  }
+  EXPECT_LT(gt::norm_linf(gt::atan2(a, b) - ref), 1e-14);
+}
+
+TEST(expression, compare)
+{
+  gt::gtensor<double, 1> a({1., 2., 3.});
+  gt::gtensor<double, 1> b({3., 2., 1.});
+
+  EXPECT_EQ(a < b, (gt::gtensor<bool, 1>{true, false, false}));
+  EXPECT_EQ(a <= b, (gt::gtensor<bool, 1>{true, true, false}));
+  EXPECT_EQ(a > 1., (gt::gtensor<bool, 1>{false, true, true}));
+  EXPECT_EQ(2. >= a, (gt::gtensor<bool, 1>{true, true, false}));
+  EXPECT_EQ(gt::equal(a, b), (gt::gtensor<bool, 1>{false, true, false}));
+  EXPECT_EQ(gt::not_equal(a, b), (gt::gtensor<bool, 1>{true, false, true}));
+  EXPECT_EQ(gt::logical_and(a > 1., b > 1.),
+            (gt::gtensor<bool, 1>{false, true, false}));
+  EXPECT_EQ(gt::logical_or(a > 2., b > 2.),
+            (gt::gtensor<bool, 1>{true, false, true}));
+  EXPECT_EQ(gt::logical_not(a > 1.),
+            (gt::gtensor<bool, 1>{true, false, false}));
+}
+
+TEST(expression, where)
+{
+  gt::gtensor<double, 1> a({1., -2., 3., -4.});
+  gt::gtensor<double, 1> b({10., 20., 30., 40.});
+
+  auto e = gt::where(a < 0., b, a);
+  EXPECT_EQ(e.shape(), gt::shape(4));
+  EXPECT_EQ(e, (gt::gtensor<double, 1>{1., 20., 3., 40.}));
+
+  // scalar branches
+  EXPECT_EQ(gt::where(a > 0., a, 0.),
+            (gt::gtensor<double, 1>{1., 0., 3., 0.}));
+
+  // broadcast condition
+  gt::gtensor<double, 2> c(gt::shape(2, 2), 1.);
+  gt::gtensor<bool, 2> mask({{true, false}});
+  EXPECT_EQ(gt::where(mask, c, 2. * c),
+            (gt::gtensor<double, 2>{{1., 2.}, {1., 2.}}));
+}
+
+TEST(expression, where_view)
+{
+  gt::gtensor<double, 1> a({1., -2., 3., -4.});
+  auto e = gt::where(a < 0., -a, a);
+  EXPECT_EQ(e.view(gt::placeholders::_s(1, 3)), (gt::gtensor<double, 1>{2., 3.}));
+}
+
+TEST(expression, math_funcs_typestr)
+{
+  gt::gtensor<double, 1> a({1., 2.});
+  auto e = gt::maximum(gt::sqrt(a), 1.);
+  EXPECT_NE(e.typestr().find("maximum"), std::string::npos);
+  EXPECT_NE(e.typestr().find("sqrt"), std::string::npos);
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+TEST(expression, device_math_funcs)
+{
+  gt::gtensor_device<double, 1> a({1., -2., 3., -4.});
+  gt::gtensor_device<double, 1> b(a.shape());
+  gt::gtensor<double, 1> h_b(a.shape());
+
+  b = gt::sqrt(gt::maximum(a, 0.)) + gt::pow(a, 2);
+  gt::copy(b, h_b);
+
+  EXPECT_EQ(h_b, (gt::gtensor<double, 1>{2., 4., std::sqrt(3.) + 9., 16.}));
+}
+
+TEST(expression, device_where)
+{
+  gt::gtensor_device<double, 1> a({1., -2., 3., -4.});
+  gt::gtensor_device<double, 1> b(a.shape());
+  gt::gtensor<double, 1> h_b(a.shape());
+
+  b = gt::where(a < 0., -a, 2. * a);
+  gt::copy(b, h_b);
+
+  EXPECT_EQ(h_b, (gt::gtensor<double, 1>{2., 2., 6., 4.}));
+}
+#endif
+
 // Note: not currently working on Intel SYCL host backend on github
 // CI, but does work locally on GPU backend
 #if defined(GTENSOR_HAVE_DEVICE) && !defined(GTENSOR_DEVICE_SYCL_HOST)
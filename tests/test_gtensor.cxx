@@ -973,6 +973,79 @@ TYPED_TEST(gtensor_copy, expr_to_non_contiguous)
     b, (gt::gtensor<double, 2, b_space_type>{{0., 12., 13.}, {0., 22., 23.}}));
 }
 
+TYPED_TEST(gtensor_copy, view_slab_5d)
+{
+  using a_space_type = typename TypeParam::a_space_type;
+  using b_space_type = typename TypeParam::b_space_type;
+  auto shape = gt::shape(4, 3, 5, 2, 3);
+  auto h_a = gt::gtensor<double, 5>(shape);
+  for (int i = 0; i < h_a.size(); i++) {
+    h_a.data()[i] = i;
+  }
+  auto a = gt::gtensor<double, 5, a_space_type>(shape);
+  gt::copy(h_a, a);
+
+  // ghost slabs in the first, a middle and the last dimension
+  auto b0 = gt::gtensor<double, 5, b_space_type>(gt::shape(2, 3, 5, 2, 3));
+  gt::copy(a.view(gt::slice(1, 3)), b0);
+  EXPECT_EQ(b0, h_a.view(gt::slice(1, 3)));
+
+  auto b2 = gt::gtensor<double, 5, b_space_type>(gt::shape(4, 3, 2, 2, 3));
+  gt::copy(a.view(gt::all, gt::all, gt::slice(3, 5)), b2);
+  EXPECT_EQ(b2, h_a.view(gt::all, gt::all, gt::slice(3, 5)));
+
+  auto b4 = gt::gtensor<double, 5, b_space_type>(gt::shape(4, 3, 5, 2, 1));
+  gt::copy(a.view(gt::all, gt::all, gt::all, gt::all, gt::slice(2, 3)), b4);
+  EXPECT_EQ(b4, h_a.view(gt::all, gt::all, gt::all, gt::all, gt::slice(2, 3)));
+
+  // and back into the slab of another array
+  auto c = gt::gtensor<double, 5, a_space_type>(shape, 0.);
+  gt::copy(b2, c.view(gt::all, gt::all, gt::slice(3, 5)));
+  auto h_c = gt::gtensor<double, 5>(shape, 0.);
+  h_c.view(gt::all, gt::all, gt::slice(3, 5)) =
+    h_a.view(gt::all, gt::all, gt::slice(3, 5));
+  EXPECT_EQ(c, h_c);
+}
+
+TYPED_TEST(gtensor_copy, view_strided_inner)
+{
+  using a_space_type = typename TypeParam::a_space_type;
+  using b_space_type = typename TypeParam::b_space_type;
+  auto a = gt::gtensor<double, 2, a_space_type>{{11., 12., 13., 14.},
+                                                {21., 22., 23., 24.}};
+  auto b = gt::gtensor<double, 2, b_space_type>(gt::shape(2, 2), 0.);
+  auto c = gt::gtensor<double, 2, a_space_type>(a.shape(), 0.);
+
+  // no unit stride in the fastest dimension, needs packing
+  gt::copy(a.view(gt::slice(0, 4, 2)), b);
+  EXPECT_EQ(b, (gt::gtensor<double, 2, b_space_type>{{11., 13.}, {21., 23.}}));
+
+  gt::copy(b, c.view(gt::slice(1, 4, 2)));
+  EXPECT_EQ(c, (gt::gtensor<double, 2, a_space_type>{{0., 11., 0., 13.},
+                                                     {0., 21., 0., 23.}}));
+}
+
+TYPED_TEST(gtensor_copy, view_shape_mismatch)
+{
+  using a_space_type = typename TypeParam::a_space_type;
+  using b_space_type = typename TypeParam::b_space_type;
+  auto a = gt::gtensor<double, 2, a_space_type>{{11., 12., 13.},
+                                                {21., 22., 23.}};
+  auto b = gt::gtensor<double, 2, b_space_type>(gt::shape(2, 3), 0.);
+
+  // both contiguous and of the same size: flat copy
+  gt::copy(a.view(gt::all, gt::all), b);
+  EXPECT_EQ(b, (gt::gtensor<double, 2, b_space_type>{{11., 12.},
+                                                     {13., 21.},
+                                                     {22., 23.}}));
+
+  // anything else must not be reinterpreted
+  auto c = gt::gtensor<double, 2, b_space_type>(gt::shape(4, 1), 0.);
+  EXPECT_THROW(gt::copy(a.view(gt::slice(0, 2), gt::all), c),
+               std::runtime_error);
+  EXPECT_THROW(gt::copy(a.view(gt::all, gt::all), c), std::runtime_error);
+}
+
 // ======================================================================
 
 template <typename S>
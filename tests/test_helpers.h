@@ -93,7 +93,7 @@ inline void _expect_near_array(const char* file, int line, const char* xname,
   }
 
   if (!equal) {
-    const int max_view = 10;
+    const gt::index_t max_view = 10;
     auto xs = gt::slice(0, std::min(xflat.shape(0), max_view));
     auto ys = gt::slice(0, std::min(yflat.shape(0), max_view));
     std::cerr << "Arrays not close (max " << max_err << ") at " << file << ":"
@@ -137,7 +137,7 @@ inline void _expect_near_array_abs(const char* file, int line,
   }
 
   if (!equal) {
-    const int max_view = 10;
+    const gt::index_t max_view = 10;
     auto xs = gt::slice(0, std::min(xflat.shape(0), max_view));
     std::cerr << "Array abs not close (max " << max_err << ") at " << file
               << ":" << line << std::endl
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <limits>
+
 #include "gtensor/gtensor.h"
+#include "gtensor/reductions.h"
 
 #include "gt-blas/blas.h"
 
@@ -272,6 +276,341 @@ TEST(lapack, sgetrs_batch) { test_getrs_batch_real<float>(); }
 
 TEST(lapack, dgetrs_batch) { test_getrs_batch_real<double>(); }
 
+template <typename T>
+void test_getrf_getrs_getri_strided_batch()
+{
+  constexpr int N = 3;
+  constexpr int batch_size = 4;
+
+  gt::gtensor<T, 3> h_A(gt::shape(N, N, batch_size));
+  gt::gtensor<T, 2> h_B(gt::shape(N, batch_size));
+  for (int b = 0; b < batch_size; b++) {
+    set_A0(h_A.view(gt::all, gt::all, b));
+    // A0 * [1; 2; b] = [5 + 2b; 12 + 2b; 16 + 4b]
+    h_B(0, b) = 5 + 2 * b;
+    h_B(1, b) = 12 + 2 * b;
+    h_B(2, b) = 16 + 4 * b;
+  }
+  // the inverse has a larger leading dimension than A
+  constexpr int ldc = N + 1;
+  gt::gtensor_device<T, 3> d_A(h_A.shape());
+  gt::gtensor_device<T, 3> d_Ainv(gt::shape(ldc, N, batch_size));
+  gt::gtensor_device<T, 2> d_B(h_B.shape());
+  gt::gtensor_device<gt::blas::index_t, 2> d_p(gt::shape(N, batch_size));
+  gt::gtensor_device<int, 1> d_info(gt::shape(batch_size), -1);
+  gt::gtensor_device<int, 1> d_info_ri(gt::shape(batch_size), -1);
+  gt::copy(h_A, d_A);
+  gt::copy(h_B, d_B);
+
+  gt::blas::handle_t h;
+
+  auto getrf_count = gt::blas::getrf_strided_batched_scratchpad_size<T>(
+    h, N, N, batch_size);
+  auto getrs_count = gt::blas::getrs_strided_batched_scratchpad_size<T>(
+    h, N, 1, N, N, batch_size);
+  auto getri_count = gt::blas::getri_strided_batched_scratchpad_size<T>(
+    h, N, N, ldc, batch_size);
+  gt::space::device_vector<T> scratch(
+    std::max({getrf_count, getrs_count, getri_count}));
+  T* d_scratch = gt::raw_pointer_cast(scratch.data());
+
+  gt::blas::getrf_strided_batched<T>(
+    h, N, gt::raw_pointer_cast(d_A.data()), N,
+    gt::raw_pointer_cast(d_p.data()), batch_size, d_scratch, getrf_count,
+    gt::raw_pointer_cast(d_info.data()));
+  gt::blas::getrs_strided_batched<T>(
+    h, N, 1, gt::raw_pointer_cast(d_A.data()), N,
+    gt::raw_pointer_cast(d_p.data()), gt::raw_pointer_cast(d_B.data()), N,
+    batch_size, d_scratch, getrs_count);
+  gt::blas::getri_strided_batched<T>(
+    h, N, gt::raw_pointer_cast(d_A.data()), N,
+    gt::raw_pointer_cast(d_p.data()), gt::raw_pointer_cast(d_Ainv.data()),
+    ldc, batch_size, d_scratch, getri_count,
+    gt::raw_pointer_cast(d_info_ri.data()));
+
+  gt::gtensor<T, 3> h_Ainv(d_Ainv.shape());
+  gt::gtensor<int, 1> h_info(d_info.shape());
+  gt::gtensor<int, 1> h_info_ri(d_info.shape());
+  gt::gtensor<gt::blas::index_t, 2> h_p(d_p.shape());
+  gt::copy(d_B, h_B);
+  gt::copy(d_Ainv, h_Ainv);
+  gt::copy(d_p, h_p);
+  gt::copy(d_info, h_info);
+  gt::copy(d_info_ri, h_info_ri);
+
+  EXPECT_EQ(h_info, gt::zeros<int>(h_info.shape()));
+  EXPECT_EQ(h_info_ri, gt::zeros<int>(h_info.shape()));
+  T tol = 1e-5;
+  for (int b = 0; b < batch_size; b++) {
+    EXPECT_EQ(h_p(0, b), 2);
+    EXPECT_EQ(h_p(1, b), 3);
+    EXPECT_EQ(h_p(2, b), 3);
+    EXPECT_NEAR(h_B(0, b), 1, tol);
+    EXPECT_NEAR(h_B(1, b), 2, tol);
+    EXPECT_NEAR(h_B(2, b), b, tol * (b + 1));
+    // Ainv * A0 = I
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        T sum = 0;
+        for (int k = 0; k < N; k++) {
+          sum += h_Ainv(i, k, b) * h_A(k, j, b);
+        }
+        EXPECT_NEAR(sum, i == j ? 1 : 0, tol);
+      }
+    }
+  }
+}
+
+TEST(lapack, sgetrf_getrs_getri_strided_batch)
+{
+  test_getrf_getrs_getri_strided_batch<float>();
+}
+
+TEST(lapack, dgetrf_getrs_getri_strided_batch)
+{
+  test_getrf_getrs_getri_strided_batch<double>();
+}
+
+// matrices larger than the host small batched cutoff, with padding in both A
+// and the inverse
+template <typename T>
+void test_getri_strided_batch_ld()
+{
+  constexpr int N = 20;
+  constexpr int lda = N + 2;
+  constexpr int ldc = N + 5;
+  constexpr int batch_size = 3;
+
+  // A_b = ones + (N + b) * I
+  gt::gtensor<T, 3> h_A(gt::shape(lda, N, batch_size), T(-1));
+  for (int b = 0; b < batch_size; b++) {
+    for (int j = 0; j < N; j++) {
+      for (int i = 0; i < N; i++) {
+        h_A(i, j, b) = i == j ? N + 1 + b : 1;
+      }
+    }
+  }
+  gt::gtensor_device<T, 3> d_A(h_A.shape());
+  gt::gtensor_device<T, 3> d_Ainv(gt::shape(ldc, N, batch_size), T(-1));
+  gt::gtensor_device<gt::blas::index_t, 2> d_p(gt::shape(N, batch_size));
+  gt::gtensor_device<int, 1> d_info(gt::shape(batch_size), -1);
+  gt::copy(h_A, d_A);
+
+  gt::blas::handle_t h;
+
+  auto getrf_count = gt::blas::getrf_strided_batched_scratchpad_size<T>(
+    h, N, lda, batch_size);
+  auto getri_count = gt::blas::getri_strided_batched_scratchpad_size<T>(
+    h, N, lda, ldc, batch_size);
+  gt::space::device_vector<T> scratch(std::max(getrf_count, getri_count));
+  T* d_scratch = gt::raw_pointer_cast(scratch.data());
+
+  gt::blas::getrf_strided_batched<T>(
+    h, N, gt::raw_pointer_cast(d_A.data()), lda,
+    gt::raw_pointer_cast(d_p.data()), batch_size, d_scratch, getrf_count);
+  gt::blas::getri_strided_batched<T>(
+    h, N, gt::raw_pointer_cast(d_A.data()), lda,
+    gt::raw_pointer_cast(d_p.data()), gt::raw_pointer_cast(d_Ainv.data()),
+    ldc, batch_size, d_scratch, getri_count,
+    gt::raw_pointer_cast(d_info.data()));
+
+  gt::gtensor<T, 3> h_Ainv(d_Ainv.shape());
+  gt::gtensor<int, 1> h_info(d_info.shape());
+  gt::copy(d_Ainv, h_Ainv);
+  gt::copy(d_info, h_info);
+
+  EXPECT_EQ(h_info, gt::zeros<int>(h_info.shape()));
+  T tol = 1e-5;
+  for (int b = 0; b < batch_size; b++) {
+    // Ainv * A_b = I
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        T sum = 0;
+        for (int k = 0; k < N; k++) {
+          sum += h_Ainv(i, k, b) * (k == j ? N + 1 + b : 1);
+        }
+        EXPECT_NEAR(sum, i == j ? 1 : 0, tol);
+      }
+    }
+    // padding rows of the inverse are not touched
+    for (int j = 0; j < N; j++) {
+      for (int i = N; i < ldc; i++) {
+        EXPECT_EQ(h_Ainv(i, j, b), T(-1));
+      }
+    }
+  }
+}
+
+TEST(lapack, sgetri_strided_batch_ld) { test_getri_strided_batch_ld<float>(); }
+
+TEST(lapack, dgetri_strided_batch_ld)
+{
+  test_getri_strided_batch_ld<double>();
+}
+
+#ifndef GTENSOR_HAVE_DEVICE
+
+// host backend: the info array reports singular entries
+TEST(lapack, dgetrf_strided_batch_info)
+{
+  constexpr int N = 3;
+  constexpr int batch_size = 3;
+
+  gt::gtensor<double, 3> A(gt::shape(N, N, batch_size), 0.);
+  gt::gtensor<gt::blas::index_t, 2> p(gt::shape(N, batch_size));
+  gt::gtensor<int, 1> info(gt::shape(batch_size), -1);
+  set_A0(A.view(gt::all, gt::all, 0));
+  set_A0(A.view(gt::all, gt::all, 2));
+
+  gt::blas::handle_t h;
+  gt::blas::getrf_strided_batched<double>(h, N, A.data(), N, p.data(),
+                                          batch_size, nullptr, 0, info.data());
+
+  EXPECT_EQ(info(0), 0);
+  EXPECT_GT(info(1), 0);
+  EXPECT_EQ(info(2), 0);
+}
+
+// host backend: batch split across threads in small chunks, with matrices
+// large enough to go through LAPACK rather than the small batched kernels
+TEST(lapack, dgetrf_getrs_batch_threaded)
+{
+  constexpr int N = 24;
+  constexpr int batch_size = 256;
+
+  gt::gtensor<double, 3> A(gt::shape(N, N, batch_size));
+  gt::gtensor<double, 2> B(gt::shape(N, batch_size));
+  gt::gtensor<double*, 1> Aptr(gt::shape(batch_size));
+  gt::gtensor<double*, 1> Bptr(gt::shape(batch_size));
+  gt::gtensor<gt::blas::index_t, 2> p(gt::shape(N, batch_size));
+  gt::gtensor<int, 1> info(gt::shape(batch_size));
+
+  // A_b = ones + (N + b) * I, and B = A_b * x with x_i = i + 1
+  for (int b = 0; b < batch_size; b++) {
+    double sum_x = N * (N + 1) / 2;
+    for (int j = 0; j < N; j++) {
+      for (int i = 0; i < N; i++) {
+        A(i, j, b) = i == j ? N + 1 + b : 1.;
+      }
+      B(j, b) = sum_x + (N + b) * (j + 1);
+    }
+    Aptr(b) = &A(0, 0, b);
+    Bptr(b) = &B(0, b);
+  }
+
+  gt::blas::handle_t h;
+  ASSERT_FALSE(h.use_small_batched(N));
+  h.set_batch_num_threads(4);
+  h.set_batch_chunk_size(8);
+  gt::blas::getrf_batched(h, N, Aptr.data(), N, p.data(), info.data(),
+                          batch_size);
+  gt::blas::getrs_batched(h, N, 1, Aptr.data(), N, p.data(), Bptr.data(), N,
+                          batch_size);
+
+  for (int b = 0; b < batch_size; b++) {
+    EXPECT_EQ(info(b), 0);
+    for (int i = 0; i < N; i++) {
+      EXPECT_NEAR(B(i, b), i + 1, 1e-12 * N);
+    }
+  }
+}
+
+// host backend: batched calls leave the OpenBLAS thread count alone, and a
+// batched call from inside a batch runs inline instead of waiting on the pool
+TEST(lapack, batch_thread_pool_nested)
+{
+  constexpr int batch_size = 64;
+
+  gt::blas::handle_t h;
+  h.set_batch_num_threads(4);
+  h.set_batch_chunk_size(4);
+  int blas_num_threads = openblas_get_num_threads();
+
+  gt::gtensor<int, 2> count(gt::shape(batch_size, batch_size), 0);
+  h.parallel_batch(batch_size, [&](int begin, int end) {
+    for (int b = begin; b < end; b++) {
+      h.parallel_batch(batch_size, [&](int begin2, int end2) {
+        for (int b2 = begin2; b2 < end2; b2++) {
+          count(b2, b)++;
+        }
+      });
+    }
+  });
+
+  EXPECT_EQ(count, gt::full<int>(count.shape(), 1));
+  EXPECT_EQ(openblas_get_num_threads(), blas_num_threads);
+}
+
+// native small batched kernels against LAPACK
+template <typename T>
+void test_small_batched_vs_lapack(int n, int batch_size)
+{
+  using R = gt::complex_subtype_t<T>;
+  gt::gtensor<T, 3> A(gt::shape(n, n, batch_size));
+  // pseudo-random and not diagonally dominant, so that rows get swapped
+  unsigned seed = 1;
+  for (int k = 0; k < A.size(); k++) {
+    seed = seed * 1103515245u + 12345u;
+    A.data()[k] = T(double((seed >> 16) & 0x7fff) / 0x7fff - 0.5);
+  }
+  gt::gtensor<T, 3> LU_ref(A);
+  gt::gtensor<T, 3> LU(A);
+  gt::gtensor<T, 2> B_ref(gt::shape(n, batch_size), T(1));
+  gt::gtensor<T, 2> B(B_ref);
+  gt::gtensor<T, 3> C_ref(A.shape());
+  gt::gtensor<T, 3> C(A.shape());
+  gt::gtensor<gt::blas::index_t, 2> p_ref(gt::shape(n, batch_size));
+  gt::gtensor<gt::blas::index_t, 2> p(p_ref.shape());
+  gt::gtensor<int, 1> info(gt::shape(batch_size));
+
+  auto ptrs = [&](auto& a) {
+    gt::gtensor<T*, 1> result(gt::shape(batch_size));
+    for (int b = 0; b < batch_size; b++) {
+      result(b) = a.data() + b * (a.size() / batch_size);
+    }
+    return result;
+  };
+  auto LU_ref_ptr = ptrs(LU_ref), LU_ptr = ptrs(LU);
+  auto B_ref_ptr = ptrs(B_ref), B_ptr = ptrs(B);
+  auto C_ref_ptr = ptrs(C_ref), C_ptr = ptrs(C);
+
+  gt::blas::handle_t h_ref, h;
+  h_ref.set_small_batched_max_n(0);
+  ASSERT_TRUE(h.use_small_batched(n));
+
+  gt::blas::getrf_batched(h_ref, n, LU_ref_ptr.data(), n, p_ref.data(),
+                          info.data(), batch_size);
+  gt::blas::getrf_batched(h, n, LU_ptr.data(), n, p.data(), info.data(),
+                          batch_size);
+  gt::blas::getrs_batched(h_ref, n, 1, LU_ref_ptr.data(), n, p_ref.data(),
+                          B_ref_ptr.data(), n, batch_size);
+  gt::blas::getrs_batched(h, n, 1, LU_ptr.data(), n, p.data(), B_ptr.data(),
+                          n, batch_size);
+  gt::blas::getri_batched(h_ref, n, LU_ref_ptr.data(), n, p_ref.data(),
+                          C_ref_ptr.data(), n, info.data(), batch_size);
+  gt::blas::getri_batched(h, n, LU_ptr.data(), n, p.data(), C_ptr.data(), n,
+                          info.data(), batch_size);
+
+  R tol = 1000 * std::numeric_limits<R>::epsilon();
+  EXPECT_EQ(p, p_ref);
+  EXPECT_EQ(info, gt::zeros<int>(info.shape()));
+  EXPECT_LT(gt::norm_linf(LU - LU_ref), tol);
+  EXPECT_LT(gt::norm_linf(B - B_ref), tol * gt::norm_linf(B_ref));
+  EXPECT_LT(gt::norm_linf(C - C_ref), tol * gt::norm_linf(C_ref));
+}
+
+TEST(lapack, dsmall_batched_n5)
+{
+  test_small_batched_vs_lapack<double>(5, 21);
+}
+
+TEST(lapack, zsmall_batched_n16)
+{
+  test_small_batched_vs_lapack<gt::complex<double>>(16, 7);
+}
+
+#endif // GTENSOR_HAVE_DEVICE
+
 template <typename R>
 void test_getrf_batch_complex()
 {
@@ -243,3 +243,32 @@ TEST(gtensor, device_launch_6d)
 }
 
 #endif // GTENSOR_HAVE_DEVICE
+
+template <typename S>
+void test_launch_index_t()
+{
+  auto shape = gt::shape(2, 3, 4, 2, 3);
+  gt::gtensor<double, 5, S> a(shape);
+  auto k_a = a.to_kernel();
+
+  gt::launch<5, S>(
+    shape,
+    GT_LAMBDA(gt::index_t i, gt::index_t j, gt::index_t k, gt::index_t l,
+              gt::index_t m) { k_a(i, j, k, l, m) = i + 10 * j + 100 * m; });
+
+  gt::gtensor<double, 5> h_a(shape);
+  gt::copy(a, h_a);
+  EXPECT_EQ(h_a(1, 2, 3, 1, 2), 221.);
+  EXPECT_EQ(h_a(0, 1, 0, 0, 1), 110.);
+}
+
+TEST(gtensor, launch_index_t) { test_launch_index_t<gt::space::host>(); }
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(gtensor, device_launch_index_t)
+{
+  test_launch_index_t<gt::space::device>();
+}
+
+#endif
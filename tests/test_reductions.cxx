@@ -253,6 +253,63 @@ TEST(reductions, device_reduce_sum_1d_stream)
 }
 #endif // GTENSOR_HAVE_DEVICE
 
+template <typename S>
+void test_reduce_async(int n, gt::stream_view stream = gt::stream_view{})
+{
+  gt::gtensor<double, 1> h_a(gt::shape(n));
+  for (int i = 0; i < n; i++) {
+    h_a(i) = i + 1;
+  }
+  gt::gtensor<double, 1, S> a(h_a.shape());
+  gt::gtensor<double, 1, S> b(h_a.shape());
+  gt::gtensor<double, 1, S> asum(gt::shape(1));
+  gt::gtensor<double, 1, S> amax(gt::shape(1));
+  gt::gtensor<double, 1, S> amin(gt::shape(1));
+  gt::copy(h_a, a);
+
+  gt::sum_async(a, asum, stream);
+  gt::max_async(a, amax, stream);
+  gt::min_async(a, amin, stream);
+
+  // the result feeds the next kernel without a round trip to the host
+  auto k_a = a.to_kernel();
+  auto k_b = b.to_kernel();
+  auto k_amax = amax.to_kernel();
+  gt::launch<1, S>(
+    a.shape(), GT_LAMBDA(int i) { k_b(i) = k_a(i) / k_amax(0); }, stream);
+  gt::event done =
+    gt::reduce_async(b, asum, 0., std::plus<double>{}, stream);
+
+  done.synchronize();
+  gt::gtensor<double, 1> h_asum(asum.shape());
+  gt::gtensor<double, 1> h_amin(amin.shape());
+  gt::copy(asum, h_asum);
+  gt::copy(amin, h_amin);
+  EXPECT_EQ(h_asum(0), (double)(n + 1) / 2);
+  EXPECT_EQ(h_amin(0), 1.);
+}
+
+TEST(reductions, reduce_async_1d)
+{
+  test_reduce_async<gt::space::host>(2048);
+}
+
+TEST(reductions, reduce_async_1d_stream)
+{
+  gt::stream s;
+  test_reduce_async<gt::space::host>(2048, s.get_view());
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(reductions, device_reduce_async_1d_stream)
+{
+  gt::stream s;
+  test_reduce_async<gt::space::device>(2048, s.get_view());
+}
+
+#endif // GTENSOR_HAVE_DEVICE
+
 template <typename Tin, typename Tout = Tin, typename Enable = void>
 struct UnaryOpNorm
 {
@@ -145,6 +145,37 @@ TEST(sarray, zero_dim)
   EXPECT_EQ(gt::to_string(a), "{}");
 }
 
+TEST(sarray, convert_index_type)
+{
+  gt::sarray<int, 3> a{2, 3, 4};
+  gt::sarray<std::int64_t, 3> b(a);
+  gt::sarray<int, 3> c(b);
+
+  EXPECT_EQ(b[0], 2);
+  EXPECT_EQ(b[1], 3);
+  EXPECT_EQ(b[2], 4);
+  EXPECT_EQ(c, a);
+
+  gt::shape_type<3> shape(a);
+  EXPECT_EQ(shape, gt::shape(2, 3, 4));
+}
+
+TEST(sarray, unravel_index_type)
+{
+  auto shape = gt::shape(3, 4, 5);
+  auto strides = gt::calc_strides(shape);
+  auto strides32 = gt::calc_strides(gt::sarray<int, 3>(shape));
+  auto strides64 = gt::calc_strides(gt::sarray<std::int64_t, 3>(shape));
+
+  for (int i = 0; i < 60; i++) {
+    auto idx = gt::unravel(gt::size_type(i), strides);
+    gt::sarray<int, 3> idx32(idx);
+    gt::sarray<std::int64_t, 3> idx64(idx);
+    EXPECT_EQ(gt::unravel(i, strides32), idx32);
+    EXPECT_EQ(gt::unravel(std::int64_t(i), strides64), idx64);
+  }
+}
+
 #ifdef GTENSOR_HAVE_DEVICE
 
 TEST(sarray, device_launch_insert) { test_launch_insert<gt::space::device>(); }
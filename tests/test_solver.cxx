@@ -9,6 +9,48 @@
 #include "gtest_predicates.h"
 #include "test_debug.h"
 
+/*
+  A_b = scale * (b + 1) * A for batch b, with the N x N tridiagonal
+
+  A = [ 2 -1  0  0  0;
+       -1  2 -1  0  0;
+        0 -1  2 -1  0;
+        0  0 -1  2 -1;
+        0  0  0 -1  2]
+
+  and pointers to the batches, as taken by the solvers. For N = 5, the
+  solution of A x = ones is tridiagonal_x.
+*/
+template <typename T>
+struct tridiagonal_batches
+{
+  gt::gtensor<T, 3> A;
+  gt::gtensor<T*, 1> ptr;
+
+  tridiagonal_batches(int n, int nbatches, double scale = 1)
+    : A(gt::shape(n, n, nbatches)), ptr(gt::shape(nbatches))
+  {
+    for (int b = 0; b < nbatches; b++) {
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+          if (i == j) {
+            A(j, i, b) = 2.0 * scale * (b + 1);
+          } else if (std::abs(i - j) == 1) {
+            A(j, i, b) = -1.0 * scale * (b + 1);
+          } else {
+            A(j, i, b) = 0.0;
+          }
+        }
+      }
+      ptr(b) = gt::raw_pointer_cast(&A(0, 0, b));
+    }
+  }
+
+  T* const* data() { return gt::raw_pointer_cast(ptr.data()); }
+};
+
+const double tridiagonal_x[5] = {2.5, 4.0, 4.5, 4.0, 2.5};
+
 template <typename Solver>
 void test_full_solve()
 {
@@ -71,6 +113,48 @@ void test_full_solve()
   GT_EXPECT_NEAR(h_C.view(gt::all, 1, 0), h_C_expected);
 }
 
+// many batches, so that the rows of a sparse triangular solve level are
+// split across threads on host. A single right hand side, since
+// solver_sparse stores multiple ones for all batches one after the other.
+// With update, the solver is created for other matrices with the same
+// sparsity pattern first, and then updated.
+template <typename Solver>
+void test_batch_solve(bool update = false)
+{
+  using T = typename Solver::value_type;
+  constexpr int N = 5;
+  constexpr int batch_size = 256;
+
+  tridiagonal_batches<T> A(N, batch_size);
+  tridiagonal_batches<T> A2(N, batch_size, 2);
+  gt::gtensor_device<T, 2> d_B(gt::shape(N, batch_size));
+  gt::gtensor<T, 2> h_B(gt::shape(N, batch_size));
+  gt::gtensor_device<T, 2> d_C(gt::shape(N, batch_size));
+  gt::gtensor<T, 2> h_C(gt::shape(N, batch_size));
+  gt::gtensor<T, 2> h_C_expected(gt::shape(N, batch_size));
+
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < N; i++) {
+      h_B(i, b) = 1.0;
+      h_C_expected(i, b) = tridiagonal_x[i] / (b + 1);
+    }
+  }
+
+  gt::blas::handle_t h;
+
+  Solver solver(h, N, batch_size, 1, update ? A2.data() : A.data());
+  if (update) {
+    solver.update_matrices(A.data());
+  }
+
+  gt::copy(h_B, d_B);
+  solver.solve(gt::raw_pointer_cast(d_B.data()),
+               gt::raw_pointer_cast(d_C.data()));
+  gt::copy(d_C, h_C);
+
+  GT_EXPECT_NEAR(h_C, h_C_expected);
+}
+
 TEST(solver, sfull_dense_solve)
 {
   test_full_solve<gt::solver::solver_dense<float>>();
@@ -122,7 +206,7 @@ TEST(solver, dfull_sparse_solve)
 }
 
 // Note: oneMKL sparse API does not support complex yet
-#if defined(GTENSOR_DEVICE_CUDA) || defined(GTENSOR_DEVICE_HIP)
+#ifndef GTENSOR_DEVICE_SYCL
 
 TEST(solver, cfull_sparse_solve)
 {
@@ -134,4 +218,336 @@ TEST(solver, zfull_sparse_solve)
   test_full_solve<gt::solver::solver_sparse<gt::complex<double>>>();
 }
 
+TEST(solver, cbatch_sparse_solve)
+{
+  test_batch_solve<gt::solver::solver_sparse<gt::complex<float>>>();
+}
+
 #endif
+
+TEST(solver, dbatch_dense_solve)
+{
+  test_batch_solve<gt::solver::solver_dense<double>>();
+}
+
+TEST(solver, dbatch_sparse_solve)
+{
+  test_batch_solve<gt::solver::solver_sparse<double>>();
+}
+
+TEST(solver, sfull_sparse_batch_solve)
+{
+  test_full_solve<gt::solver::solver_sparse_batch<float>>();
+}
+
+TEST(solver, dfull_sparse_batch_solve)
+{
+  test_full_solve<gt::solver::solver_sparse_batch<double>>();
+}
+
+TEST(solver, cfull_sparse_batch_solve)
+{
+  test_full_solve<gt::solver::solver_sparse_batch<gt::complex<float>>>();
+}
+
+TEST(solver, zfull_sparse_batch_solve)
+{
+  test_full_solve<gt::solver::solver_sparse_batch<gt::complex<double>>>();
+}
+
+TEST(solver, dbatch_sparse_batch_solve)
+{
+  test_batch_solve<gt::solver::solver_sparse_batch<double>>();
+}
+
+TEST(solver, dfull_mixed_solve)
+{
+  test_full_solve<gt::solver::solver_mixed<double>>();
+}
+
+TEST(solver, zfull_mixed_solve)
+{
+  test_full_solve<gt::solver::solver_mixed<gt::complex<double>>>();
+}
+
+TEST(solver, dbatch_mixed_solve)
+{
+  test_batch_solve<gt::solver::solver_mixed<double>>();
+}
+
+template <typename T>
+void test_mixed_refine()
+{
+  constexpr int N = 8;
+  constexpr int batch_size = 2;
+  using R = gt::complex_subtype_t<T>;
+
+  // batch 0 is well conditioned, batch 1 is the Hilbert matrix, which is too
+  // ill conditioned to factor in single precision
+  gt::gtensor<T*, 1> h_Aptr(gt::shape(batch_size));
+  auto h_A = gt::zeros<T>(gt::shape(N, N, batch_size));
+  gt::gtensor<T, 2> h_B(gt::shape(N, batch_size));
+  gt::gtensor_device<T, 2> d_B(h_B.shape());
+  gt::gtensor<T, 2> h_X(h_B.shape());
+  gt::gtensor_device<T, 2> d_X(h_B.shape());
+  for (int j = 0; j < N; j++) {
+    for (int i = 0; i < N; i++) {
+      h_A(i, j, 0) = i == j ? 4.0 : 1.0 / (1 + i + j);
+      h_A(i, j, 1) = 1.0 / (1 + i + j);
+    }
+    h_B(j, 0) = j + 1;
+    h_B(j, 1) = 1;
+  }
+  for (int b = 0; b < batch_size; b++) {
+    h_Aptr(b) = gt::raw_pointer_cast(&h_A(0, 0, b));
+  }
+
+  gt::blas::handle_t h;
+  gt::copy(h_B, d_B);
+
+  // well conditioned only: converges without the fallback
+  gt::solver::solver_mixed<T> solver1(h, N, 1, 1,
+                                      gt::raw_pointer_cast(h_Aptr.data()));
+  solver1.solve(gt::raw_pointer_cast(d_B.data()),
+                gt::raw_pointer_cast(d_X.data()));
+  EXPECT_GT(solver1.get_iterations(), 1);
+  EXPECT_LE(solver1.get_iterations(), 5);
+  EXPECT_FALSE(solver1.is_fallback());
+
+  gt::solver::solver_mixed<T> solver2(h, N, batch_size, 1,
+                                      gt::raw_pointer_cast(h_Aptr.data()));
+  solver2.solve(gt::raw_pointer_cast(d_B.data()),
+                gt::raw_pointer_cast(d_X.data()));
+  EXPECT_TRUE(solver2.is_fallback());
+  EXPECT_FALSE(solver2.is_fallback(0));
+  EXPECT_TRUE(solver2.is_fallback(1));
+  gt::copy(d_X, h_X);
+
+  // check the residuals of the solutions
+  for (int b = 0; b < batch_size; b++) {
+    R rmax = 0;
+    for (int i = 0; i < N; i++) {
+      T r = h_B(i, b);
+      for (int j = 0; j < N; j++) {
+        r -= h_A(i, j, b) * h_X(j, b);
+      }
+      rmax = std::max(rmax, R(gt::abs(r)));
+    }
+    EXPECT_LT(rmax, 1e-10);
+  }
+
+  // later solves still refine batch 0, and no longer wait for batch 1
+  gt::gtensor<T, 2> h_X1(h_X);
+  solver2.solve(gt::raw_pointer_cast(d_B.data()),
+                gt::raw_pointer_cast(d_X.data()));
+  EXPECT_GT(solver2.get_iterations(), 1);
+  EXPECT_LE(solver2.get_iterations(), 5);
+  gt::copy(d_X, h_X);
+  EXPECT_LT(gt::norm_linf(h_X - h_X1), 1e-10 * gt::norm_linf(h_X1));
+
+  // new matrices start over without fallback
+  solver2.update_matrices(gt::raw_pointer_cast(h_Aptr.data()));
+  EXPECT_FALSE(solver2.is_fallback());
+
+  // singular in single precision, 1 + 1e-10 rounds to 1: the single
+  // precision solve gives inf / NaN, which must not be taken as converged
+  gt::gtensor<T, 2> h_S(gt::shape(2, 2));
+  h_S(0, 0) = 1;
+  h_S(1, 0) = 1;
+  h_S(0, 1) = 1;
+  h_S(1, 1) = 1 + 1e-10;
+  T* h_Sptr = gt::raw_pointer_cast(h_S.data());
+  gt::gtensor<T, 1> h_b(gt::shape(2));
+  h_b(0) = 1;
+  h_b(1) = 2;
+  gt::gtensor_device<T, 1> d_b(h_b.shape());
+  gt::gtensor_device<T, 1> d_x(h_b.shape());
+  gt::gtensor<T, 1> h_x(h_b.shape());
+  gt::copy(h_b, d_b);
+
+  gt::solver::solver_mixed<T> solver3(h, 2, 1, 1, &h_Sptr);
+  EXPECT_TRUE(solver3.is_fallback(0));
+  solver3.solve(gt::raw_pointer_cast(d_b.data()),
+                gt::raw_pointer_cast(d_x.data()));
+  EXPECT_TRUE(solver3.is_fallback());
+  gt::copy(d_x, h_x);
+  EXPECT_LT(gt::abs(h_x(0) - T(1 - 1e10)), 1e-4 * 1e10);
+  EXPECT_LT(gt::abs(h_x(1) - T(1e10)), 1e-4 * 1e10);
+}
+
+TEST(solver, dmixed_refine)
+{
+  test_mixed_refine<double>();
+}
+
+TEST(solver, zmixed_refine)
+{
+  test_mixed_refine<gt::complex<double>>();
+}
+
+TEST(solver, dupdate_dense_solve)
+{
+  test_batch_solve<gt::solver::solver_dense<double>>(true);
+}
+
+TEST(solver, dupdate_invert_solve)
+{
+  test_batch_solve<gt::solver::solver_invert<double>>(true);
+}
+
+TEST(solver, dupdate_sparse_solve)
+{
+  test_batch_solve<gt::solver::solver_sparse<double>>(true);
+}
+
+TEST(solver, dupdate_sparse_batch_solve)
+{
+  test_batch_solve<gt::solver::solver_sparse_batch<double>>(true);
+}
+
+TEST(solver, dupdate_mixed_solve)
+{
+  test_batch_solve<gt::solver::solver_mixed<double>>(true);
+}
+
+// solves through spans, for fewer right hand sides than the solver was
+// created for: contiguous, with strided (non-contiguous) rhs and result, and
+// in place
+template <typename Solver>
+void test_span_solve()
+{
+  using T = typename Solver::value_type;
+  using span_type = typename Solver::span_type;
+  constexpr int N = 5;
+  constexpr int NRHS = 4;
+  constexpr int batch_size = 3;
+
+  tridiagonal_batches<T> A(N, batch_size);
+  gt::gtensor<T, 3> h_B(gt::shape(N, NRHS, batch_size));
+  gt::gtensor<T, 3> h_C_expected(gt::shape(N, NRHS, batch_size));
+
+  // rhs j = (j + 1) * ones
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < NRHS; j++) {
+        h_B(i, j, b) = j + 1;
+        h_C_expected(i, j, b) = (j + 1) * tridiagonal_x[i] / (b + 1);
+      }
+    }
+  }
+
+  gt::blas::handle_t h;
+  Solver solver(h, N, batch_size, NRHS, A.data());
+
+  gt::gtensor_device<T, 3> d_B(h_B.shape());
+  gt::gtensor_device<T, 3> d_C(h_B.shape());
+  gt::gtensor<T, 3> h_C(h_B.shape());
+  gt::copy(h_B, d_B);
+
+  // first two right hand sides, contiguous
+  auto shape2 = gt::shape(N, 2, batch_size);
+  gt::gtensor<T, 3> h_C2 = h_B.view(gt::all, gt::slice(0, 2), gt::all);
+  gt::gtensor_device<T, 3> d_B2(shape2);
+  gt::gtensor_device<T, 3> d_C2(shape2);
+  gt::copy(h_C2, d_B2);
+  solver.solve(d_B2.to_kernel(), d_C2.to_kernel());
+  gt::copy(d_C2, h_C2);
+  GT_EXPECT_NEAR(h_C2, h_C_expected.view(gt::all, gt::slice(0, 2), gt::all));
+
+  // right hand sides 0 and 2, strided
+  auto strides2 = gt::shape(1, 2 * N, NRHS * N);
+  span_type d_Bs(d_B.data(), shape2, strides2);
+  span_type d_Cs(d_C.data(), shape2, strides2);
+  d_C = gt::scalar(T(0));
+  solver.solve(d_Bs, d_Cs);
+  gt::copy(d_C, h_C);
+  GT_EXPECT_NEAR(h_C.view(gt::all, gt::slice(0, NRHS, 2), gt::all),
+                 h_C_expected.view(gt::all, gt::slice(0, NRHS, 2), gt::all));
+
+  // all right hand sides, in place
+  solver.solve_inplace(d_B.to_kernel());
+  gt::copy(d_B, h_C);
+  GT_EXPECT_NEAR(h_C, h_C_expected);
+
+  // strided, in place
+  gt::copy(h_B, d_B);
+  solver.solve_inplace(d_Bs);
+  gt::copy(d_B, h_C);
+  GT_EXPECT_NEAR(h_C.view(gt::all, gt::slice(0, NRHS, 2), gt::all),
+                 h_C_expected.view(gt::all, gt::slice(0, NRHS, 2), gt::all));
+  GT_EXPECT_NEAR(h_C.view(gt::all, gt::slice(1, NRHS, 2), gt::all),
+                 h_B.view(gt::all, gt::slice(1, NRHS, 2), gt::all));
+
+  // rhs (b + 1) * ones for batch b, so the solution is the same for every
+  // batch, and result overlapping rhs shifted by one batch
+  auto shape1 = gt::shape(N, 1, batch_size);
+  gt::gtensor<T, 1> h_S(gt::shape(N * (batch_size + 1)), T(0));
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < N; i++) {
+      h_S(b * N + i) = b + 1;
+    }
+  }
+  gt::gtensor_device<T, 1> d_S(h_S.shape());
+  gt::copy(h_S, d_S);
+  auto d_Sb = gt::adapt_device(gt::raw_pointer_cast(d_S.data()), shape1);
+  auto d_Sx = gt::adapt_device(gt::raw_pointer_cast(d_S.data()) + N, shape1);
+  solver.solve(d_Sb.to_kernel(), d_Sx.to_kernel());
+  gt::copy(d_S, h_S);
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < N; i++) {
+      EXPECT_NEAR(gt::abs(h_S((b + 1) * N + i) - T(tridiagonal_x[i])), 0.,
+                  1e-12);
+    }
+  }
+
+  // rhs overlapping result with the batches in reverse order (negative
+  // batch stride), so rhs batch b is read from where result batch
+  // batch_size - b is stored
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < N; i++) {
+      h_S((batch_size - b) * N + i) = b + 1;
+    }
+  }
+  gt::copy(h_S, d_S);
+  gt::gtensor_span_device<const T, 3> d_Sr(d_S.data() + batch_size * N,
+                                           shape1, gt::shape(1, N, -N));
+  solver.solve(d_Sr, d_Sb.to_kernel());
+  gt::copy(d_S, h_S);
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < N; i++) {
+      EXPECT_NEAR(gt::abs(h_S(b * N + i) - T(tridiagonal_x[i])), 0., 1e-12);
+    }
+  }
+
+  // wrong number of batches, result shape not matching rhs
+  span_type d_Bn(d_B.data(), gt::shape(N, NRHS, batch_size - 1),
+                 d_B.strides());
+  EXPECT_THROW(solver.solve_inplace(d_Bn), std::invalid_argument);
+  EXPECT_THROW(solver.solve(d_B.to_kernel(), d_C2.to_kernel()),
+               std::invalid_argument);
+}
+
+TEST(solver, dspan_dense_solve)
+{
+  test_span_solve<gt::solver::solver_dense<double>>();
+}
+
+TEST(solver, dspan_invert_solve)
+{
+  test_span_solve<gt::solver::solver_invert<double>>();
+}
+
+TEST(solver, dspan_sparse_solve)
+{
+  test_span_solve<gt::solver::solver_sparse<double>>();
+}
+
+TEST(solver, dspan_sparse_batch_solve)
+{
+  test_span_solve<gt::solver::solver_sparse_batch<double>>();
+}
+
+TEST(solver, dspan_mixed_solve)
+{
+  test_span_solve<gt::solver::solver_mixed<double>>();
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 #include <gtest/gtest.h>
@@ -71,6 +72,30 @@ void test_csr_matrix_batched()
   EXPECT_EQ(h_err(0), 0);
 }
 
+// update_batches keeps the pattern and rejects nonzeros outside of it
+TEST(sparse, csr_matrix_update_batches_host)
+{
+  constexpr int N = 3;
+  constexpr int NBATCHES = 2;
+  gt::gtensor<double, 3> h_A(gt::shape(N, N, NBATCHES), 0.);
+  for (int b = 0; b < NBATCHES; b++) {
+    for (int i = 0; i < N; i++) {
+      h_A(i, i, b) = b + 1;
+    }
+    h_A(1, 0, b) = -1;
+  }
+
+  auto h_Acsr =
+    gt::sparse::csr_matrix<double, gt::space::host>::join_matrix_batches(h_A);
+  gt::gtensor<double, 3> h_A2 = 2. * h_A;
+  h_Acsr.update_batches(h_A2);
+  EXPECT_EQ(h_Acsr(1, 0), -2.);
+  EXPECT_EQ(h_Acsr(N + 2, N + 2), 4.);
+
+  h_A2(0, 2, 1) = 1.;
+  EXPECT_THROW(h_Acsr.update_batches(h_A2), std::runtime_error);
+}
+
 TEST(sparse, csr_matrix_batched_host_z)
 {
   test_csr_matrix_batched<gt::complex<double>, gt::space::host>();
@@ -95,6 +120,98 @@ TEST(sparse, csr_matrix_batched_device_c)
 
 #endif
 
+// the CSR index arrays are 32-bit, so nnz has to fit in an int
+TEST(sparse, csr_matrix_nnz_range)
+{
+  using csr_type = gt::sparse::csr_matrix<double, gt::space::host>;
+  using csr_batch_type = gt::sparse::csr_matrix_batch<double, gt::space::host>;
+  EXPECT_THROW(csr_type(gt::shape(4, 4), -1), std::length_error);
+  EXPECT_THROW(csr_batch_type(gt::shape(4, 4), -1, 2), std::length_error);
+#ifdef GTENSOR_INDEX_64
+  gt::index_t nnz = gt::index_t(std::numeric_limits<int>::max()) + 1;
+  EXPECT_THROW(csr_type(gt::shape(nnz, nnz), nnz), std::length_error);
+#endif
+  EXPECT_EQ(csr_type(gt::shape(4, 4), 6).nnz(), 6);
+}
+
+template <typename T, typename S>
+void test_csr_matrix_batch()
+{
+  constexpr int N = 5;
+  constexpr int NBATCHES = 3;
+  auto h_A = gt::zeros<T>(gt::shape(N, N, NBATCHES));
+  gt::gtensor<T, 3, S> d_A(h_A.shape());
+
+  // tridiagonal with diagonal b + 1, except that the (0, 1) entry is only
+  // nonzero in the last batch; the shared pattern still contains it
+  for (int b = 0; b < NBATCHES; b++) {
+    for (int i = 0; i < N; i++) {
+      h_A(i, i, b) = b + 1;
+      if (i > 0) {
+        h_A(i, i - 1, b) = -1;
+      }
+      if (i > 1) {
+        h_A(i - 1, i, b) = -1;
+      }
+    }
+  }
+  h_A(0, 1, NBATCHES - 1) = -1;
+
+  gt::copy(h_A, d_A);
+
+  gt::sparse::csr_matrix_batch<T, S> d_Acsr(d_A);
+  EXPECT_EQ(d_Acsr.nnz(), 3 * N - 2);
+  EXPECT_EQ(d_Acsr.nbatches(), NBATCHES);
+  EXPECT_EQ(d_Acsr.shape(), gt::shape(N, N));
+
+  gt::gtensor<int, 1> h_row_ptr(gt::shape(N + 1));
+  gt::gtensor<int, 1> h_col_ind(gt::shape(d_Acsr.nnz()));
+  gt::gtensor<T, 2> h_values(gt::shape(d_Acsr.nnz(), NBATCHES));
+  gt::copy_n(gt::device_pointer_cast(d_Acsr.row_ptr_data()), N + 1,
+             h_row_ptr.data());
+  gt::copy_n(gt::device_pointer_cast(d_Acsr.col_ind_data()), d_Acsr.nnz(),
+             h_col_ind.data());
+  gt::copy_n(gt::device_pointer_cast(d_Acsr.values_data()), h_values.size(),
+             h_values.data());
+
+  for (int b = 0; b < NBATCHES; b++) {
+    for (int i = 0; i < N; i++) {
+      for (int idx = h_row_ptr(i); idx < h_row_ptr(i + 1); idx++) {
+        EXPECT_EQ(h_values(idx, b), h_A(i, h_col_ind(idx), b));
+      }
+    }
+  }
+  EXPECT_EQ(h_values(1, 0), T(0));
+  EXPECT_EQ(h_values(1, NBATCHES - 1), T(-1));
+
+  // updates keep the shared pattern, nonzeros outside of it throw
+  gt::gtensor<T, 3> h_A2 = T(2) * h_A;
+  gt::copy(h_A2, d_A);
+  d_Acsr.update(d_A);
+  gt::copy_n(gt::device_pointer_cast(d_Acsr.values_data()), h_values.size(),
+             h_values.data());
+  EXPECT_EQ(h_values(1, NBATCHES - 1), T(-2));
+  EXPECT_EQ(h_values(0, 0), T(2));
+
+  h_A2(N - 1, 0, 0) = T(1);
+  gt::copy(h_A2, d_A);
+  EXPECT_THROW(d_Acsr.update(d_A), std::runtime_error);
+}
+
+TEST(sparse, csr_matrix_batch_host_d)
+{
+  test_csr_matrix_batch<double, gt::space::host>();
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(sparse, csr_matrix_batch_device_z)
+{
+  test_csr_matrix_batch<gt::complex<double>, gt::space::device>();
+}
+
+#endif
+
 template <typename T, typename S>
 void test_csr_matrix()
 {
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/gtensor.h>
+
+#include "test_debug.h"
+
+TEST(stensor, construct)
+{
+  gt::stensor<double, 2, 3> a(1., 2., 3., 4., 5., 6.);
+
+  EXPECT_EQ(a.dimension(), 2);
+  EXPECT_EQ(a.shape(), gt::shape(2, 3));
+  EXPECT_EQ(a.size(), 6);
+  EXPECT_EQ(a(0, 0), 1.);
+  EXPECT_EQ(a(1, 0), 2.);
+  EXPECT_EQ(a(0, 1), 3.);
+  EXPECT_EQ(a(1, 2), 6.);
+  EXPECT_EQ(a[gt::shape(1, 1)], 4.);
+
+  gt::stensor<double, 2, 3> b;
+  EXPECT_EQ(b(1, 2), 0.);
+}
+
+TEST(stensor, constexpr_size)
+{
+  using S = gt::stensor<float, 3, 3>;
+  static_assert(S::size() == 9, "stensor size");
+  static_assert(sizeof(S) == 9 * sizeof(float), "stensor storage");
+
+  using B = gt::stensor<float, 3, 1, 2>;
+  static_assert(B::shape(2) == 2, "stensor shape");
+  static_assert(B::strides()[0] == 1 && B::strides()[1] == 0 &&
+                  B::strides()[2] == 3,
+                "stensor strides");
+  EXPECT_EQ(B::strides(), gt::calc_strides(B::shape()));
+}
+
+TEST(stensor, expression)
+{
+  gt::stensor<double, 2, 2> a(1., 2., 3., 4.);
+  gt::gtensor<double, 2> b(gt::shape(2, 2), 10.);
+
+  gt::gtensor<double, 2> c = a + b;
+  EXPECT_EQ(c, (gt::gtensor<double, 2>{{11., 12.}, {13., 14.}}));
+  EXPECT_EQ(a, (gt::gtensor<double, 2>{{1., 2.}, {3., 4.}}));
+
+  gt::stensor<double, 2, 2> d = 2. * a;
+  EXPECT_EQ(d(1, 1), 8.);
+}
+
+TEST(stensor, device_expression)
+{
+  gt::stensor<double, 2, 2> a(1., 2., 3., 4.);
+  gt::gtensor_device<double, 2> d_b(gt::shape(2, 2), 10.);
+  gt::gtensor_device<double, 2> d_c(gt::shape(2, 2));
+  gt::gtensor<double, 2> h_c(gt::shape(2, 2));
+
+  static_assert(
+    std::is_same<gt::expr_space_type<decltype(a * d_b)>,
+                 gt::space::device>::value,
+    "stensor takes the space of the expression it is mixed into");
+  d_c = a * d_b + a;
+  gt::copy(d_c, h_c);
+  EXPECT_EQ(h_c, (gt::gtensor<double, 2>{{11., 22.}, {33., 44.}}));
+}
+
+TEST(stensor, broadcast)
+{
+  gt::stensor<int, 3, 1> a(1, 2, 3);
+  gt::gtensor<int, 2> b(gt::shape(3, 2));
+
+  gt::assign(b, a);
+  EXPECT_EQ(b, (gt::gtensor<int, 2>{{1, 2, 3}, {1, 2, 3}}));
+}
+
+TEST(stensor, compound_ops)
+{
+  gt::stensor<double, 3> a(1., 2., 3.);
+  gt::stensor<double, 3> b(1., 1., 1.);
+
+  a += b;
+  a *= 2.;
+  EXPECT_EQ(a, (gt::gtensor<double, 1>{4., 6., 8.}));
+  a -= b;
+  a /= 3.;
+  EXPECT_EQ(a, (gt::gtensor<double, 1>{1., 5. / 3., 7. / 3.}));
+}
+
+TEST(stensor, matmul)
+{
+  gt::stensor<double, 2, 3> a(1., 2., 3., 4., 5., 6.);
+  gt::stensor<double, 3, 2> b(1., 0., 1., 0., 1., 0.);
+  gt::stensor<double, 2> x(1., 1.);
+
+  auto c = gt::matmul(a, b);
+  EXPECT_EQ(c, (gt::gtensor<double, 2>{{6., 8.}, {3., 4.}}));
+
+  auto y = gt::matvec(c, x);
+  EXPECT_EQ(y, (gt::gtensor<double, 1>{9., 12.}));
+}
+
+template <typename S>
+void test_stensor_launch()
+{
+  gt::gtensor<double, 3, S> a(gt::shape(2, 2, 4));
+  gt::gtensor<double, 3> h_a(a.shape());
+  auto k_a = a.to_kernel();
+
+  gt::stensor<double, 2, 2> rot(0., 1., -1., 0.);
+
+  gt::launch<1, S>(
+    gt::shape(4), GT_LAMBDA(int n) {
+      gt::stensor<double, 2, 2> m(double(n), 0., 0., 1.);
+      auto r = gt::matmul(rot, m);
+      for (int j = 0; j < 2; j++) {
+        for (int i = 0; i < 2; i++) {
+          k_a(i, j, n) = r(i, j);
+        }
+      }
+    });
+  gt::copy(a, h_a);
+
+  for (int n = 0; n < 4; n++) {
+    EXPECT_EQ(h_a(0, 0, n), 0.);
+    EXPECT_EQ(h_a(1, 0, n), double(n));
+    EXPECT_EQ(h_a(0, 1, n), -1.);
+    EXPECT_EQ(h_a(1, 1, n), 0.);
+  }
+}
+
+TEST(stensor, launch)
+{
+  test_stensor_launch<gt::space::host>();
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(stensor, device_launch)
+{
+  test_stensor_launch<gt::space::device>();
+}
+
+#endif
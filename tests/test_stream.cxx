@@ -1,6 +1,18 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "gtensor/gtensor.h"
+#include "gtensor/reductions.h"
+#include "gtensor/stream_pipeline.h"
+#include "gtensor/stream_pool.h"
+
+#ifdef GTENSOR_TEST_BLAS
+#include "gt-blas/blas.h"
+#endif
 
 #include "test_debug.h"
 
@@ -23,6 +35,386 @@ TEST(stream, assign_gtensor_6d)
   EXPECT_EQ(a, b);
 }
 
+TEST(stream, copy_async_host)
+{
+  gt::gtensor<double, 2> a{{11., 12., 13.}, {21., 22., 23.}};
+  gt::gtensor<double, 2> b(a.shape());
+
+  gt::stream stream;
+
+  auto event = gt::copy_async(a, b, stream.get_view());
+  event.synchronize();
+  EXPECT_TRUE(event.query());
+  EXPECT_EQ(b, a);
+}
+
+TEST(stream, copy_async_host_view)
+{
+  gt::gtensor<double, 2> a{{11., 12., 13.}, {21., 22., 23.}};
+  gt::gtensor<double, 1> b(gt::shape(2));
+
+  gt::stream stream;
+
+  gt::copy_async(a.view(1, gt::all), b, stream.get_view()).synchronize();
+  EXPECT_EQ(b, (gt::gtensor<double, 1>{12., 22.}));
+
+  gt::copy_async(2. * a.view(0, gt::all), b, stream.get_view());
+  stream.synchronize();
+  EXPECT_EQ(b, (gt::gtensor<double, 1>{22., 42.}));
+}
+
+TEST(stream, event_host)
+{
+  gt::gtensor<double, 1> a{1., 2., 3.};
+  gt::gtensor<double, 1> b(a.shape());
+
+  gt::stream stream1;
+  gt::stream stream2;
+  gt::event start(true), stop(true);
+
+  start.record(stream1.get_view());
+  gt::assign(b, 2. * a, stream1.get_view());
+  stop.record(stream1.get_view());
+
+  stream2.wait(stop);
+  stream2.get_view().wait(stop);
+  stream2.synchronize();
+
+  EXPECT_TRUE(stop.query());
+  EXPECT_GE(gt::elapsed_time(start, stop), 0.f);
+  EXPECT_EQ(b, (gt::gtensor<double, 1>{2., 4., 6.}));
+}
+
+#ifndef GTENSOR_HAVE_DEVICE
+
+// host streams run their work on a worker thread
+
+TEST(stream, host_stream_ordered)
+{
+  gt::gtensor<double, 1> a(gt::shape(1000), 1.);
+  gt::gtensor<double, 1> b(a.shape());
+  gt::gtensor<double, 1> c(a.shape());
+
+  gt::stream stream;
+
+  // the second assign reads the result of the first one
+  gt::assign(b, 2. * a, stream.get_view());
+  gt::assign(c, b + a, stream.get_view());
+  auto k_c = c.to_kernel();
+  gt::launch_host<1>(
+    c.shape(), GT_LAMBDA(int i) { k_c(i) += 1.; }, stream.get_view());
+  stream.synchronize();
+
+  EXPECT_EQ(c, gt::full<double>(a.shape(), 4.));
+}
+
+TEST(stream, host_streams_event_dependency)
+{
+  gt::gtensor<double, 1> a(gt::shape(1000), 1.);
+  gt::gtensor<double, 1> b(a.shape());
+  gt::gtensor<double, 1> c(a.shape());
+
+  gt::stream stream1;
+  gt::stream stream2;
+  gt::event done;
+
+  // stream1 is blocked until the host lets it go, stream2 waits for stream1
+  std::mutex mutex;
+  mutex.lock();
+  gt::launch_host<1>(
+    gt::shape(1), [&](int i) { std::lock_guard<std::mutex> lock(mutex); },
+    stream1.get_view());
+  gt::assign(b, 2. * a, stream1.get_view());
+  done.record(stream1.get_view());
+
+  stream2.wait(done);
+  gt::assign(c, b + a, stream2.get_view());
+
+  EXPECT_FALSE(done.query());
+  mutex.unlock();
+
+  stream2.synchronize();
+  EXPECT_TRUE(done.query());
+  EXPECT_EQ(c, gt::full<double>(a.shape(), 3.));
+}
+
+TEST(stream, host_track_writes)
+{
+  gt::gtensor<double, 1> a(gt::shape(1000), 1.);
+  gt::gtensor<double, 1> b(a.shape());
+  gt::gtensor<double, 1> h_a(a.shape());
+
+  gt::stream stream1;
+  gt::stream stream2;
+
+  std::mutex mutex;
+  mutex.lock();
+  gt::launch_host<1>(
+    gt::shape(1), [&](int i) { std::lock_guard<std::mutex> lock(mutex); },
+    stream1.get_view());
+
+  // the read of a on stream2 waits for the write on stream1 only
+  a.track_writes();
+  gt::assign(a, 2. * a, stream1.get_view());
+  gt::assign(b, a + 1., stream2.get_view());
+  EXPECT_FALSE(stream2.query());
+  mutex.unlock();
+
+  // so does the copy to the host
+  gt::copy(a, h_a);
+  EXPECT_EQ(h_a, gt::full<double>(a.shape(), 2.));
+  stream2.synchronize();
+  EXPECT_EQ(b, gt::full<double>(a.shape(), 3.));
+}
+
+TEST(stream, host_track_view_writes)
+{
+  gt::gtensor<double, 1> a(gt::shape(1000), 1.);
+  gt::gtensor<double, 1> b(a.shape());
+
+  gt::stream stream1;
+  gt::stream stream2;
+
+  std::mutex mutex;
+  mutex.lock();
+  gt::launch_host<1>(
+    gt::shape(1), [&](int) { std::lock_guard<std::mutex> lock(mutex); },
+    stream1.get_view());
+
+  // a write through a view is recorded on the viewed container
+  a.track_writes();
+  auto a_lo = a.view(gt::slice(0, 500));
+  gt::assign(a_lo, 2. * a_lo, stream1.get_view());
+  gt::assign(b, a + 1., stream2.get_view());
+  EXPECT_FALSE(stream2.query());
+  mutex.unlock();
+
+  stream2.synchronize();
+  EXPECT_EQ(b.view(gt::slice(0, 500)), gt::full<double>({500}, 3.));
+  EXPECT_EQ(b.view(gt::slice(500, 1000)), gt::full<double>({500}, 2.));
+}
+
+TEST(stream, host_synchronize_all)
+{
+  gt::gtensor<double, 1> a(gt::shape(1000), 1.);
+  gt::gtensor<double, 1> b(a.shape());
+
+  gt::stream stream;
+  gt::assign(b, 2. * a, stream.get_view());
+  gt::synchronize();
+  EXPECT_EQ(b, gt::full<double>(a.shape(), 2.));
+  EXPECT_EQ(gt::sum(b, stream.get_view()), 2000.);
+}
+
+TEST(stream, host_stream_exception)
+{
+  gt::gtensor<double, 1> a(gt::shape(100), 1.);
+  gt::gtensor<double, 1> b(a.shape(), 0.);
+
+  gt::stream stream;
+  gt::event done;
+
+  // an exception thrown by a kernel is rethrown by the event wait and once
+  // by synchronize, work submitted after it still runs
+  gt::launch_host<1>(
+    gt::shape(1), [](int) { throw std::runtime_error("kernel"); },
+    stream.get_view());
+  gt::assign(b, 2. * a, stream.get_view());
+  done.record(stream.get_view());
+  EXPECT_THROW(done.synchronize(), std::runtime_error);
+  EXPECT_THROW(stream.synchronize(), std::runtime_error);
+  EXPECT_NO_THROW(stream.synchronize());
+  EXPECT_EQ(b, gt::full<double>(a.shape(), 2.));
+
+  // and by a device-wide synchronize
+  gt::launch_host<1>(
+    gt::shape(1), [](int) { throw std::runtime_error("kernel"); },
+    stream.get_view());
+  EXPECT_THROW(gt::synchronize(), std::runtime_error);
+  EXPECT_NO_THROW(gt::synchronize());
+}
+
+TEST(stream, host_graph_replay)
+{
+  gt::gtensor<double, 1> a(gt::shape(100), 1.);
+  gt::gtensor<double, 1> b(a.shape(), 0.);
+
+  gt::stream stream;
+
+  // captured work is recorded only, it runs on each launch
+  auto graph = gt::capture_graph(stream.get_view(), [&]() {
+    gt::assign(b, b + a, stream.get_view());
+    gt::assign(b, 2. * b, stream.get_view());
+  });
+  stream.synchronize();
+  EXPECT_EQ(b, gt::zeros<double>(a.shape()));
+
+  for (int i = 0; i < 3; i++) {
+    graph.launch(stream.get_view());
+  }
+  stream.synchronize();
+  EXPECT_EQ(b, gt::full<double>(a.shape(), 14.));
+}
+
+TEST(stream, host_graph_capture_throws)
+{
+  gt::gtensor<double, 1> a(gt::shape(100), 1.);
+  gt::gtensor<double, 1> b(a.shape(), 0.);
+
+  gt::stream stream;
+
+  EXPECT_THROW(gt::capture_graph(stream.get_view(),
+                                 [&]() {
+                                   gt::assign(b, a, stream.get_view());
+                                   throw std::runtime_error("capture");
+                                 }),
+               std::runtime_error);
+
+  // the capture was ended, work runs again and can be captured again
+  gt::assign(b, 2. * a, stream.get_view());
+  stream.synchronize();
+  EXPECT_EQ(b, gt::full<double>(a.shape(), 2.));
+  EXPECT_NO_THROW(gt::capture_graph(stream.get_view(), [&]() {}));
+}
+
+TEST(stream, host_graph_capture_sync_throws)
+{
+  gt::gtensor<double, 1> a(gt::shape(100), 1.);
+  gt::gtensor<double, 1> b(a.shape(), 0.);
+
+  gt::stream stream;
+  gt::event done;
+
+  // captured work has not run yet, so waiting for it is an error
+  auto graph = gt::capture_graph(stream.get_view(), [&]() {
+    gt::assign(b, 2. * a, stream.get_view());
+    done.record(stream.get_view());
+    EXPECT_THROW(stream.synchronize(), std::logic_error);
+    EXPECT_THROW(done.synchronize(), std::logic_error);
+    EXPECT_THROW(gt::sum(b, stream.get_view()), std::logic_error);
+  });
+
+  // after the capture, the event completes when the graph runs
+  graph.launch(stream.get_view());
+  done.synchronize();
+  EXPECT_EQ(b, gt::full<double>(a.shape(), 2.));
+  EXPECT_NO_THROW(stream.synchronize());
+}
+
+#ifdef GTENSOR_TEST_BLAS
+
+// the host BLAS routines run on the calling thread, so they have to wait for
+// the work queued on the handle's stream
+TEST(stream, host_blas_after_stream_work)
+{
+  const int n = 4;
+  const int nbatches = 3;
+  gt::gtensor<double, 3> A(gt::shape(n, n, nbatches), 0.);
+  gt::gtensor<gt::blas::index_t, 2> piv(gt::shape(n, nbatches));
+  gt::gtensor<int, 1> info(gt::shape(nbatches), -1);
+
+  gt::stream stream;
+  gt::blas::handle_t h;
+  h.set_stream(stream.get_view());
+
+  // keep the stream busy, so A is still zero if getrf does not wait
+  gt::launch_host<1>(
+    gt::shape(1),
+    [](int i) { std::this_thread::sleep_for(std::chrono::milliseconds(50)); },
+    stream.get_view());
+  auto k_A = A.to_kernel();
+  gt::launch_host<3>(
+    A.shape(),
+    GT_LAMBDA(int i, int j, int b) { k_A(i, j, b) = i == j ? 2. : 1.; },
+    stream.get_view());
+
+  gt::blas::getrf_strided_batched<double>(h, n, A.data(), n, piv.data(),
+                                          nbatches, nullptr, 0, info.data());
+  stream.synchronize();
+
+  EXPECT_EQ(info, gt::zeros<int>({nbatches}));
+  EXPECT_EQ(A(0, 0, nbatches - 1), 2.);
+  EXPECT_EQ(A(1, 0, nbatches - 1), 0.5);
+}
+
+#endif // GTENSOR_TEST_BLAS
+
+#endif // GTENSOR_HAVE_DEVICE
+
+TEST(stream, priority_stream)
+{
+  gt::gtensor<double, 1> a{1., 2., 3.};
+  gt::gtensor<double, 1> b(a.shape());
+
+  gt::stream stream(gt::stream_priority::high);
+  gt::assign(b, 2. * a, stream.get_view());
+  stream.synchronize();
+  EXPECT_TRUE(stream.query());
+  EXPECT_EQ(b, (gt::gtensor<double, 1>{2., 4., 6.}));
+}
+
+TEST(stream, stream_pool)
+{
+  gt::stream_pool pool(3);
+  EXPECT_EQ(pool.size(), 3);
+
+  // round-robin
+  EXPECT_EQ(pool.next().get_backend_stream(), pool[0].get_backend_stream());
+  EXPECT_EQ(pool.next().get_backend_stream(), pool[1].get_backend_stream());
+  EXPECT_EQ(pool.next().get_backend_stream(), pool[2].get_backend_stream());
+  EXPECT_EQ(pool.next().get_backend_stream(), pool[0].get_backend_stream());
+
+  // independent work on each stream of the pool
+  std::vector<gt::gtensor<double, 1>> out;
+  gt::gtensor<double, 1> a(gt::shape(100), 1.);
+  for (int i = 0; i < 8; i++) {
+    out.emplace_back(a.shape());
+  }
+  for (int i = 0; i < 8; i++) {
+    gt::assign(out[i], double(i) * a, pool.next_idle());
+  }
+  pool.synchronize();
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(out[i], gt::full<double>(a.shape(), i));
+  }
+}
+
+TEST(stream, stream_pipeline)
+{
+  gt::gtensor<double, 2> src(gt::shape(4, 10));
+  gt::gtensor<double, 2> dst(src.shape());
+  for (int j = 0; j < src.shape(1); j++) {
+    for (int i = 0; i < src.shape(0); i++) {
+      src(i, j) = 10 * j + i;
+    }
+  }
+
+  // 3 slices per chunk, the last chunk has only one
+  gt::stream_pipeline<double, 2> pipeline(gt::shape(4, 3), 2);
+  int n_chunks = 0;
+  pipeline.run(src, dst, [&](auto in, auto out, gt::stream_view stream) {
+    EXPECT_EQ(in.shape(0), 4);
+    EXPECT_EQ(in.shape(1), n_chunks < 3 ? 3 : 1);
+    gt::assign(out, 2. * in + 1., stream);
+    n_chunks++;
+  });
+
+  EXPECT_EQ(n_chunks, 4);
+  EXPECT_EQ(dst, 2. * src + 1.);
+}
+
+TEST(stream, stream_pipeline_in_place)
+{
+  auto a = gt::full<float>(gt::shape(2, 3, 7), 1.f);
+
+  gt::stream_pipeline<float, 3> pipeline(gt::shape(2, 3, 2), 3);
+  pipeline.run(a, [](auto in, auto out, gt::stream_view stream) {
+    gt::assign(out, in + in, stream);
+  });
+
+  EXPECT_EQ(a, gt::full<float>(a.shape(), 2.f));
+}
+
 #ifdef GTENSOR_HAVE_DEVICE
 
 void device_double_add_2d_stream(gt::gtensor_device<double, 2>& a,
@@ -140,4 +532,108 @@ TEST(stream, device_assign_ordered_non_default)
   EXPECT_EQ(h_c, h_a);
 }
 
+TEST(stream, device_copy_async)
+{
+  gt::gtensor<double, 2> h_a{{11., 12., 13.}, {21., 22., 23.}};
+  gt::gtensor_device<double, 2> a(h_a.shape());
+  gt::gtensor_device<double, 2> b(h_a.shape());
+  auto h_b = gt::zeros<double>(h_a.shape());
+
+  gt::stream stream;
+
+  gt::copy_async(h_a, a, stream.get_view());
+  gt::copy_async(a, b, stream.get_view());
+  auto event = gt::copy_async(b, h_b, stream.get_view());
+  event.synchronize();
+  EXPECT_TRUE(event.query());
+  EXPECT_EQ(h_b, h_a);
+}
+
+TEST(stream, device_copy_async_view)
+{
+  gt::gtensor<double, 2> h_a{{11., 12., 13.}, {21., 22., 23.}};
+  gt::gtensor_device<double, 2> a(h_a.shape());
+  gt::gtensor_device<double, 1> b(gt::shape(2));
+  auto h_b = gt::zeros<double>(gt::shape(2));
+
+  gt::stream stream;
+
+  gt::copy_async(h_a, a, stream.get_view());
+  gt::copy_async(a.view(1, gt::all), b, stream.get_view());
+  gt::copy_async(b, h_b, stream.get_view()).synchronize();
+  EXPECT_EQ(h_b, (gt::gtensor<double, 1>{12., 22.}));
+}
+
+TEST(stream, device_event_stream_wait)
+{
+  gt::gtensor<double, 1> h_a{1., 2., 3.};
+  gt::gtensor_device<double, 1> a(h_a.shape());
+  gt::gtensor_device<double, 1> b(h_a.shape());
+  auto h_b = gt::zeros<double>(h_a.shape());
+
+  gt::stream transfer;
+  gt::stream compute;
+  gt::event start(true), copied(true);
+
+  // compute only waits for the transfer, the host does not block until the
+  // final copy back
+  start.record(transfer.get_view());
+  gt::copy_async(h_a, a, transfer.get_view());
+  copied.record(transfer.get_view());
+
+  compute.wait(copied);
+  gt::assign(b, 2. * a, compute.get_view());
+  gt::copy_async(b, h_b, compute.get_view()).synchronize();
+
+  EXPECT_TRUE(copied.query());
+  EXPECT_GE(gt::elapsed_time(start, copied), 0.f);
+  EXPECT_EQ(h_b, (gt::gtensor<double, 1>{2., 4., 6.}));
+}
+
+TEST(stream, device_track_writes)
+{
+  gt::gtensor_device<double, 1> a(gt::shape(1000), 1.);
+  gt::gtensor_device<double, 1> b(a.shape());
+  gt::gtensor<double, 1> h_a(a.shape());
+  gt::gtensor<double, 1> h_b(a.shape());
+
+  gt::stream stream1;
+  gt::stream stream2;
+
+  a.track_writes();
+  b.track_writes();
+  gt::assign(a, 2. * a, stream1.get_view());
+  gt::assign(b, a + 1., stream2.get_view());
+  gt::copy_async(b, h_b, stream2.get_view());
+
+  // waits for the write of a on stream1 only
+  a.synchronize_write();
+  gt::copy(a, h_a);
+  EXPECT_EQ(h_a, gt::full<double>(a.shape(), 2.));
+
+  stream2.synchronize();
+  EXPECT_EQ(h_b, gt::full<double>(a.shape(), 3.));
+}
+
+TEST(stream, device_graph_replay)
+{
+  gt::gtensor_device<double, 1> a(gt::shape(100), 1.);
+  gt::gtensor_device<double, 1> b(a.shape(), 0.);
+  gt::gtensor<double, 1> h_b(a.shape());
+
+  gt::stream stream;
+
+  auto graph = gt::capture_graph(stream.get_view(), [&]() {
+    gt::assign(b, b + a, stream.get_view());
+    gt::assign(b, 2. * b, stream.get_view());
+  });
+
+  for (int i = 0; i < 3; i++) {
+    graph.launch(stream.get_view());
+  }
+  stream.synchronize();
+  gt::copy(b, h_b);
+  EXPECT_EQ(h_b, gt::full<double>(a.shape(), 14.));
+}
+
 #endif
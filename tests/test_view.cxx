@@ -117,6 +117,20 @@ TEST(view, slice_range)
   EXPECT_EQ(a1.view(_s(_, _, -2)), (gt::gtensor<double, 1>{4., 2., 0.}));
 }
 
+// views of views walk the offset with a strided cursor, negative strides
+// make it step below zero after the last element
+TEST(view, assign_view_of_view_negative_step)
+{
+  gt::gtensor<double, 2> a = {{11., 12., 13.}, {21., 22., 23.}};
+
+  gt::gtensor<double, 2> b = a.view(_all, _all).view(_s(_, _, -1), _all);
+  EXPECT_EQ(b, (gt::gtensor<double, 2>{{13., 12., 11.}, {23., 22., 21.}}));
+
+  gt::gtensor<double, 2> c =
+    a.view(_s(_, _, -1), _all).view(_all, _s(_, _, -1));
+  EXPECT_EQ(c, (gt::gtensor<double, 2>{{23., 22., 21.}, {13., 12., 11.}}));
+}
+
 TEST(view, slice_missing)
 {
   gt::gtensor<double, 2> a = {{11., 12., 13.}, {21., 22., 23.}};